@@ -0,0 +1,136 @@
+/**
+ * @file ay/aes-pinned.h
+ * @brief Zero-dispatch layer for builds with a compile-time pinned engine
+ *
+ * When aes-c is configured with `aes-c_PINNED_ENGINE` set to `ni` or `bs`, the
+ * library is built without runtime CPU detection and `AY_AES_PINNED_ENGINE` is
+ * exported to users of the `aes-c` target. Including this header instead of
+ * ay/aes.h replaces `aes_ctr_xcrypt()` and friends with static inline
+ * functions that call the entry points of the pinned engine, so calls do not
+ * go through the vtable in `AesContext`.
+ *
+ * Only this dispatch layer is inlined: the kernels are compiled with their own
+ * target flags in the library, so inlining them into the caller as well takes
+ * link-time optimization (see `aes-c_PINNED_IPO`).
+ *
+ * `aes_init()` is still required to set up the context.
+ */
+#ifndef AY_AES_PINNED_H
+#define AY_AES_PINNED_H
+
+#include <ay/aes.h>
+#include <ay/aes/hedley.h>
+#include <stddef.h>
+
+#if !defined(AY_AES_PINNED_ENGINE)
+#error "ay/aes-pinned.h requires aes-c to be configured with aes-c_PINNED_ENGINE"
+#endif
+
+/** @cond */
+#if AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+#define AY_AES_PINNED_FN(name) aesni_##name
+#elif AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+#define AY_AES_PINNED_FN(name) aesbs_##name
+#else
+#error "Unknown value of AY_AES_PINNED_ENGINE"
+#endif
+/** @endcond */
+
+HEDLEY_BEGIN_C_DECLS
+
+/** @cond
+ * Entry points of the pinned engine. These are the functions the vtable in
+ * `AesContext` would point to.
+ */
+void AY_AES_PINNED_FN(ctr_xcrypt)(AesContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char next_iv[16],
+                                  const unsigned char iv[16]);
+
+void AY_AES_PINNED_FN(ctr_width_xcrypt)(AesContext *ctx, enum AesCtrWidth width,
+                                        size_t textsize, unsigned char *out,
+                                        const unsigned char *in,
+                                        unsigned char next_iv[16],
+                                        const unsigned char iv[16]);
+
+void AY_AES_PINNED_FN(ecb_encrypt)(AesContext *ctx, size_t textsize,
+                                   unsigned char *cipher_text,
+                                   const unsigned char *plain_text);
+
+void AY_AES_PINNED_FN(ecb_decrypt)(AesContext *ctx, size_t textsize,
+                                   unsigned char *plain_text,
+                                   const unsigned char *cipher_text);
+
+void AY_AES_PINNED_FN(cbc_encrypt)(AesContext *ctx, size_t textsize,
+                                   unsigned char *cipher_text,
+                                   const unsigned char *plain_text,
+                                   const unsigned char iv[16]);
+
+void AY_AES_PINNED_FN(cbc_decrypt)(AesContext *ctx, size_t textsize,
+                                   unsigned char *plain_text,
+                                   const unsigned char *cipher_text,
+                                   const unsigned char iv[16]);
+/** @endcond */
+
+/** @cond
+ * The functions of ay/aes.h, bound to the pinned engine
+ */
+static HEDLEY_ALWAYS_INLINE void
+ay_aes_pinned_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
+                         const unsigned char *in, unsigned char next_iv[16],
+                         const unsigned char iv[16]) {
+  AY_AES_PINNED_FN(ctr_xcrypt)(ctx, textsize, out, in, next_iv, iv);
+}
+
+static HEDLEY_ALWAYS_INLINE void
+ay_aes_pinned_ctr_width_xcrypt(AesContext *ctx, enum AesCtrWidth width,
+                               size_t textsize, unsigned char *out,
+                               const unsigned char *in,
+                               unsigned char next_iv[16],
+                               const unsigned char iv[16]) {
+  AY_AES_PINNED_FN(ctr_width_xcrypt)(ctx, width, textsize, out, in, next_iv,
+                                    iv);
+}
+
+static HEDLEY_ALWAYS_INLINE void
+ay_aes_pinned_ecb_encrypt(AesContext *ctx, size_t textsize,
+                          unsigned char *cipher_text,
+                          const unsigned char *plain_text) {
+  AY_AES_PINNED_FN(ecb_encrypt)(ctx, textsize, cipher_text, plain_text);
+}
+
+static HEDLEY_ALWAYS_INLINE void
+ay_aes_pinned_ecb_decrypt(AesContext *ctx, size_t textsize,
+                          unsigned char *plain_text,
+                          const unsigned char *cipher_text) {
+  AY_AES_PINNED_FN(ecb_decrypt)(ctx, textsize, plain_text, cipher_text);
+}
+
+static HEDLEY_ALWAYS_INLINE void
+ay_aes_pinned_cbc_encrypt(AesContext *ctx, size_t textsize,
+                          unsigned char *cipher_text,
+                          const unsigned char *plain_text,
+                          const unsigned char iv[16]) {
+  AY_AES_PINNED_FN(cbc_encrypt)(ctx, textsize, cipher_text, plain_text, iv);
+}
+
+static HEDLEY_ALWAYS_INLINE void
+ay_aes_pinned_cbc_decrypt(AesContext *ctx, size_t textsize,
+                          unsigned char *plain_text,
+                          const unsigned char *cipher_text,
+                          const unsigned char iv[16]) {
+  AY_AES_PINNED_FN(cbc_decrypt)(ctx, textsize, plain_text, cipher_text, iv);
+}
+/** @endcond */
+
+HEDLEY_END_C_DECLS
+
+/* ay/aes.h is included above, so only the calls of the user are renamed. */
+#define aes_ctr_xcrypt ay_aes_pinned_ctr_xcrypt
+#define aes_ctr_width_xcrypt ay_aes_pinned_ctr_width_xcrypt
+#define aes_ecb_encrypt ay_aes_pinned_ecb_encrypt
+#define aes_ecb_decrypt ay_aes_pinned_ecb_decrypt
+#define aes_cbc_encrypt ay_aes_pinned_cbc_encrypt
+#define aes_cbc_decrypt ay_aes_pinned_cbc_decrypt
+
+#endif /* AY_AES_PINNED_H */
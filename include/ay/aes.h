@@ -7,6 +7,7 @@
 
 #include <ay/aes/hedley.h>
 #include <stddef.h>
+#include <stdint.h>
 
 HEDLEY_BEGIN_C_DECLS
 
@@ -30,8 +31,22 @@ HEDLEY_BEGIN_C_DECLS
 
 #define SIZE_OF_AES_ROUND_KEY 16
 #define NUM_ROUND_KEYS_IN_ARRAY 15
+#define NUM_GHASH_TABLE_ENTRIES 32
+#define NUM_OCB_L_TABLE_ENTRIES 34
+#define NUM_HARAKA_ROUND_CONSTANTS 40
 /** @endcond */
 
+/**
+ * @name Engine identifiers
+ * Values accepted by `AY_AES_PINNED_ENGINE`. When aes-c is configured with
+ * `aes-c_PINNED_ENGINE`, `AY_AES_PINNED_ENGINE` is defined to one of these and
+ * runtime CPU detection is compiled out. See ay/aes-pinned.h.
+ */
+/** @{ */
+#define AY_AES_ENGINE_NI 1 /**< AES-NI engine (x86 with AES-NI & SSSE3) */
+#define AY_AES_ENGINE_BS 2 /**< Portable bitsliced engine */
+/** @} */
+
 /**
  * @brief AES variants that can be used with this library
  */
@@ -41,6 +56,15 @@ enum AesKeyType {
   KEY_TYPE_AES256 = 256  /**< For AES-256 */
 };
 
+/**
+ * @brief Widths of the big-endian counter at the end of a CTR counter block
+ */
+enum AesCtrWidth {
+  AES_CTR_WIDTH_32 = 32,  /**< Last 4 bytes, e.g. GCM or RFC 3686 */
+  AES_CTR_WIDTH_64 = 64,  /**< Last 8 bytes */
+  AES_CTR_WIDTH_128 = 128 /**< Whole block, as in aes_ctr_xcrypt() */
+};
+
 /**
  * @brief Structure for storing internal information needed by the library
  */
@@ -91,6 +115,28 @@ void aes_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
                     const unsigned char *in, unsigned char next_iv[16],
                     const unsigned char iv[16]);
 
+/**
+ * @brief Encrypt or decrypt data using AES CTR mode, incrementing only the
+ * last `width` bits of the counter block
+ *
+ * The counter wraps around modulo 2^width & the leading bytes of the counter
+ * block (e.g. a nonce) stay fixed, so no call has to be split at the wrap.
+ *
+ * @param ctx pointer to AES state
+ * @param width width of the big-endian counter
+ * @param textsize size of data to be encrypted
+ * @param out pointer to memory where encrypted/decrypted data must be written
+ * to. Size of out must be >= textsize.
+ * @param in pointer to data to be encrypted/decrypted
+ * @param next_iv pointer to memory where the counter block following the last
+ * full block is stored. Can be NULL
+ * @param iv pointer to the first counter block
+ */
+void aes_ctr_width_xcrypt(AesContext *ctx, enum AesCtrWidth width,
+                          size_t textsize, unsigned char *out,
+                          const unsigned char *in, unsigned char next_iv[16],
+                          const unsigned char iv[16]);
+
 /**
  * @brief Encrypt data in plain_text using AES ECB mode and store the
  * encrypted data to cipher_text
@@ -151,8 +197,2161 @@ void aes_cbc_decrypt(AesContext *ctx, size_t textsize,
                      const unsigned char *cipher_text,
                      const unsigned char iv[16]);
 
+/**
+ * @brief Structure for storing internal information needed by the streaming
+ * CTR functions, including the state of the current message
+ */
+typedef struct AesCtrStreamContext AesCtrStreamContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesCtrStreamContext {
+  AesContext aes;
+  /* Next counter block, & the key stream of the block before it, of which
+   * `used` bytes are consumed */
+  unsigned char counter[16];
+  unsigned char key_stream[16];
+  size_t used;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the streaming AES CTR context & start a message.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ * @param iv First counter block of the message
+ */
+void aes_ctr_stream_init(AesCtrStreamContext *ctx, enum AesKeyType key_type,
+                         const unsigned char *key, const unsigned char iv[16]);
+
+/**
+ * @brief Start a new message with the key of ctx.
+ *
+ * @param ctx Pointer to context
+ * @param iv First counter block of the message
+ */
+void aes_ctr_stream_set_iv(AesCtrStreamContext *ctx,
+                           const unsigned char iv[16]);
+
+/**
+ * @brief Encrypt or decrypt the next part of a message using AES CTR mode
+ *
+ * Parts may have any size: the key stream left over by a part ending in the
+ * middle of a block is used by the next one. Whole blocks go through the CTR
+ * kernel straight from in to out, as with aes_ctr_xcrypt(); the counter is
+ * 128 bits wide.
+ *
+ * @param ctx pointer to streaming AES CTR state
+ * @param textsize size of the part
+ * @param out pointer to memory where encrypted/decrypted data must be written
+ * to. Size of out must be >= textsize. It may be equal to in.
+ * @param in pointer to data to be encrypted/decrypted
+ */
+void aes_ctr_stream_update(AesCtrStreamContext *ctx, size_t textsize,
+                           unsigned char *out, const unsigned char *in);
+
+/**
+ * @brief Move to a byte offset of the message started with iv
+ *
+ * The next update encrypts or decrypts from byte `offset` of the message,
+ * i.e. with counter block iv + offset / 16 (128-bit addition). If offset is
+ * not a multiple of 16, the key stream of that block is computed here & its
+ * first offset % 16 bytes are skipped.
+ *
+ * @param ctx pointer to streaming AES CTR state
+ * @param iv First counter block of the message
+ * @param offset byte offset in the message
+ */
+void aes_ctr_stream_seek(AesCtrStreamContext *ctx, const unsigned char iv[16],
+                         uint64_t offset);
+
+/**
+ * @brief Encrypt or decrypt a range of a message using AES CTR mode
+ *
+ * Gives the bytes from offset on of what aes_ctr_xcrypt() gives for the whole
+ * message, without going through the bytes before it. ctx is not modified,
+ * so workers can share it to process ranges of a message in parallel.
+ *
+ * @param ctx pointer to AES state
+ * @param iv First counter block of the message
+ * @param offset byte offset of the range in the message
+ * @param textsize size of the range
+ * @param out pointer to memory where encrypted/decrypted data must be written
+ * to. Size of out must be >= textsize. It may be equal to in.
+ * @param in pointer to data to be encrypted/decrypted
+ */
+void aes_ctr_xcrypt_at(AesContext *ctx, const unsigned char iv[16],
+                       uint64_t offset, size_t textsize, unsigned char *out,
+                       const unsigned char *in);
+
+/**
+ * @brief End the message, wiping the key stream left over by its last part
+ *
+ * @param ctx pointer to streaming AES CTR state
+ */
+void aes_ctr_stream_final(AesCtrStreamContext *ctx);
+
+/**
+ * @brief Structure for storing internal information needed by the streaming
+ * CBC functions, including the state of the current message
+ */
+typedef struct AesCbcStreamContext AesCbcStreamContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesCbcStreamContext {
+  AesContext aes;
+  /* Previous cipher text block (the IV at the start) */
+  unsigned char iv[16];
+  /* First `buffered` bytes of the next block */
+  unsigned char buffer[16];
+  size_t buffered;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the streaming AES CBC context & start a message.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ * @param iv Initialization Vector of the message
+ */
+void aes_cbc_stream_init(AesCbcStreamContext *ctx, enum AesKeyType key_type,
+                         const unsigned char *key, const unsigned char iv[16]);
+
+/**
+ * @brief Start a new message with the key of ctx.
+ *
+ * @param ctx Pointer to context
+ * @param iv Initialization Vector of the message
+ */
+void aes_cbc_stream_set_iv(AesCbcStreamContext *ctx,
+                           const unsigned char iv[16]);
+
+/**
+ * @brief Encrypt the next part of a message using AES CBC mode
+ *
+ * Parts may have any size. Only whole blocks are encrypted: the bytes of an
+ * incomplete last block are kept in ctx until the next part completes it.
+ * Whole blocks of the part go through the CBC kernel straight from plain_text
+ * to cipher_text.
+ *
+ * @param ctx pointer to streaming AES CBC state
+ * @param textsize size of the part
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize + 15. Since the output lags
+ * behind the input while a block is incomplete, it may only be equal to
+ * plain_text if the previous parts were multiples of 16 bytes.
+ * @param plain_text pointer to data to be encrypted
+ * @return the number of bytes written to cipher_text, a multiple of 16
+ */
+size_t aes_cbc_stream_encrypt_update(AesCbcStreamContext *ctx, size_t textsize,
+                                     unsigned char *cipher_text,
+                                     const unsigned char *plain_text);
+
+/**
+ * @brief Decrypt the next part of a message using AES CBC mode
+ *
+ * As aes_cbc_stream_encrypt_update(), in the other direction.
+ *
+ * @param ctx pointer to streaming AES CBC state
+ * @param textsize size of the part
+ * @param plain_text pointer to memory where decrypted data must be written
+ * to. Size of plain_text must be >= textsize + 15. It may only be equal to
+ * cipher_text if the previous parts were multiples of 16 bytes.
+ * @param cipher_text pointer to data to be decrypted
+ * @return the number of bytes written to plain_text, a multiple of 16
+ */
+size_t aes_cbc_stream_decrypt_update(AesCbcStreamContext *ctx, size_t textsize,
+                                     unsigned char *plain_text,
+                                     const unsigned char *cipher_text);
+
+/**
+ * @brief End the message
+ *
+ * CBC has no padding here: a message must be a multiple of 16 bytes. The
+ * bytes of an incomplete last block are discarded.
+ *
+ * @param ctx pointer to streaming AES CBC state
+ * @return 0 if the message was a multiple of 16 bytes, -1 otherwise
+ */
+int aes_cbc_stream_final(AesCbcStreamContext *ctx);
+
+/**
+ * @brief Structure for storing internal information needed by the GCM
+ * functions
+ */
+typedef struct AesGcmContext AesGcmContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesGcmContext {
+  AesContext aes;
+  struct aes_gcm_vtable *gcm_vtable;
+  /* Powers of the hash key H (and values derived from them) in the layout of
+   * the selected GHASH engine. */
+  AY_AES_ALIGNAS(16)
+  unsigned char h_table[NUM_GHASH_TABLE_ENTRIES * 16];
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-GCM context.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_gcm_init(AesGcmContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AES-GCM and store
+ * the encrypted data to cipher_text
+ *
+ * @param ctx pointer to AES-GCM state
+ * @param textsize size of data to be encrypted (at most 2^36 - 32 bytes)
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param ivsize size of IV, at least 1 byte. 12 bytes is recommended; other
+ * sizes go through GHASH as described in NIST SP 800-38D.
+ * @param iv pointer to IV
+ * @param tagsize size of authentication tag (1 to 16 bytes; 12 or more is
+ * recommended)
+ * @param tag pointer to memory where the authentication tag must be written to
+ * @return 0 on success, -1 if ivsize, tagsize or textsize is invalid (nothing
+ * is written)
+ */
+int aes_gcm_seal(AesGcmContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t ivsize,
+                 const unsigned char *iv, size_t tagsize, unsigned char *tag);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AES-GCM and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AES-GCM state
+ * @param textsize size of data to be decrypted (at most 2^36 - 32 bytes)
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize. It is zeroed if authentication
+ * fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param ivsize size of IV, at least 1 byte
+ * @param iv pointer to IV
+ * @param tagsize size of authentication tag (1 to 16 bytes)
+ * @param tag pointer to the authentication tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise (or if ivsize or textsize is
+ * invalid, in which case nothing is written)
+ */
+int aes_gcm_open(AesGcmContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t ivsize,
+                 const unsigned char *iv, size_t tagsize,
+                 const unsigned char *tag);
+
+/**
+ * @brief Compute the GMAC of data, i.e. the AES-GCM tag of an empty plain
+ * text with data as additional authenticated data
+ *
+ * Only GHASH runs over data, so this is as fast as the carry-less multiplier.
+ *
+ * @param ctx pointer to AES-GCM state
+ * @param size size of data
+ * @param data pointer to data. Can be NULL if size is 0.
+ * @param ivsize size of IV, at least 1 byte. The IV must be unique for each
+ * message.
+ * @param iv pointer to IV
+ * @param tagsize size of authentication tag (1 to 16 bytes)
+ * @param tag pointer to memory where the authentication tag must be written to
+ * @return 0 on success, -1 if ivsize or tagsize is invalid
+ */
+int aes_gmac(AesGcmContext *ctx, size_t size, const unsigned char *data,
+             size_t ivsize, const unsigned char *iv, size_t tagsize,
+             unsigned char *tag);
+
+/**
+ * @brief Verify the GMAC of data
+ *
+ * @param ctx pointer to AES-GCM state
+ * @param size size of data
+ * @param data pointer to data. Can be NULL if size is 0.
+ * @param ivsize size of IV, at least 1 byte
+ * @param iv pointer to IV
+ * @param tagsize size of authentication tag (1 to 16 bytes)
+ * @param tag pointer to the authentication tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise
+ */
+int aes_gmac_verify(AesGcmContext *ctx, size_t size, const unsigned char *data,
+                    size_t ivsize, const unsigned char *iv, size_t tagsize,
+                    const unsigned char *tag);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-GCM-SIV
+ * functions
+ */
+typedef struct AesGcmSivContext AesGcmSivContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesGcmSivContext {
+  /* Key-generating key */
+  AesContext aes;
+  struct aes_gcm_siv_vtable *siv_vtable;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-GCM-SIV context (RFC 8452).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use. Only KEY_TYPE_AES128 &
+ * KEY_TYPE_AES256 are defined for AES-GCM-SIV.
+ * @param key Pointer to the key-generating key
+ * @return 0 on success, -1 if key_type is KEY_TYPE_AES192
+ */
+int aes_gcm_siv_init(AesGcmSivContext *ctx, enum AesKeyType key_type,
+                     const unsigned char *key);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AES-GCM-SIV and
+ * store the encrypted data to cipher_text
+ *
+ * Unlike GCM, reusing a nonce only reveals whether the same plain text & AAD
+ * were encrypted with it.
+ *
+ * @param ctx pointer to AES-GCM-SIV state
+ * @param textsize size of data to be encrypted (at most 2^36 bytes)
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data (at most 2^36 bytes)
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param nonce pointer to the 12-byte nonce
+ * @param tag pointer to memory where the 16-byte tag must be written to
+ * @return 0 on success, -1 if textsize or aadsize is too large (nothing is
+ * written)
+ */
+int aes_gcm_siv_seal(AesGcmSivContext *ctx, size_t textsize,
+                     unsigned char *cipher_text,
+                     const unsigned char *plain_text, size_t aadsize,
+                     const unsigned char *aad, const unsigned char nonce[12],
+                     unsigned char tag[16]);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AES-GCM-SIV and store
+ * the decrypted data to plain_text
+ *
+ * @param ctx pointer to AES-GCM-SIV state
+ * @param textsize size of data to be decrypted (at most 2^36 bytes)
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize. It is zeroed if authentication
+ * fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data (at most 2^36 bytes)
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param nonce pointer to the 12-byte nonce
+ * @param tag pointer to the 16-byte tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise (or if textsize or aadsize is
+ * too large, in which case nothing is written)
+ */
+int aes_gcm_siv_open(AesGcmSivContext *ctx, size_t textsize,
+                     unsigned char *plain_text,
+                     const unsigned char *cipher_text, size_t aadsize,
+                     const unsigned char *aad, const unsigned char nonce[12],
+                     const unsigned char tag[16]);
+
+/**
+ * @brief Structure for storing internal information needed by the AEGIS-128L
+ * functions
+ */
+typedef struct AesAegis128lContext AesAegis128lContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesAegis128lContext {
+  struct aes_aegis_vtable *aegis_vtable;
+  unsigned char key[16];
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AEGIS-128L context (draft-irtf-cfrg-aegis-aead).
+ *
+ * AEGIS updates its state with AES rounds & needs no GHASH, so with AES-NI it
+ * is about twice as fast as GCM on short messages. Nonces must not be reused
+ * with the same key.
+ *
+ * @param ctx Pointer to context
+ * @param key Pointer to the 16-byte key
+ */
+void aes_aegis128l_init(AesAegis128lContext *ctx, const unsigned char key[16]);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AEGIS-128L and store
+ * the encrypted data to cipher_text
+ *
+ * @param ctx pointer to AEGIS-128L state
+ * @param textsize size of data to be encrypted
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. It may be equal to plain_text.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param nonce pointer to the 16-byte nonce
+ * @param tagsize size of the tag: 16 or 32
+ * @param tag pointer to memory where the tag must be written to
+ * @return 0 on success, -1 if tagsize is invalid (nothing is written)
+ */
+int aes_aegis128l_seal(AesAegis128lContext *ctx, size_t textsize,
+                       unsigned char *cipher_text,
+                       const unsigned char *plain_text, size_t aadsize,
+                       const unsigned char *aad,
+                       const unsigned char nonce[16], size_t tagsize,
+                       unsigned char *tag);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AEGIS-128L and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AEGIS-128L state
+ * @param textsize size of data to be decrypted
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * It may be equal to cipher_text. It is zeroed if authentication fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param nonce pointer to the 16-byte nonce
+ * @param tagsize size of the tag: 16 or 32
+ * @param tag pointer to the tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise
+ */
+int aes_aegis128l_open(AesAegis128lContext *ctx, size_t textsize,
+                       unsigned char *plain_text,
+                       const unsigned char *cipher_text, size_t aadsize,
+                       const unsigned char *aad,
+                       const unsigned char nonce[16], size_t tagsize,
+                       const unsigned char *tag);
+
+/**
+ * @brief Structure for storing internal information needed by the AEGIS-256
+ * functions
+ */
+typedef struct AesAegis256Context AesAegis256Context;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesAegis256Context {
+  struct aes_aegis_vtable *aegis_vtable;
+  unsigned char key[32];
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AEGIS-256 context (draft-irtf-cfrg-aegis-aead).
+ *
+ * Its 256-bit key & nonce allow random nonces, at about two thirds of the
+ * speed of AEGIS-128L.
+ *
+ * @param ctx Pointer to context
+ * @param key Pointer to the 32-byte key
+ */
+void aes_aegis256_init(AesAegis256Context *ctx, const unsigned char key[32]);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AEGIS-256 and store
+ * the encrypted data to cipher_text
+ *
+ * @param ctx pointer to AEGIS-256 state
+ * @param textsize size of data to be encrypted
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. It may be equal to plain_text.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param nonce pointer to the 32-byte nonce
+ * @param tagsize size of the tag: 16 or 32
+ * @param tag pointer to memory where the tag must be written to
+ * @return 0 on success, -1 if tagsize is invalid (nothing is written)
+ */
+int aes_aegis256_seal(AesAegis256Context *ctx, size_t textsize,
+                      unsigned char *cipher_text,
+                      const unsigned char *plain_text, size_t aadsize,
+                      const unsigned char *aad,
+                      const unsigned char nonce[32], size_t tagsize,
+                      unsigned char *tag);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AEGIS-256 and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AEGIS-256 state
+ * @param textsize size of data to be decrypted
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * It may be equal to cipher_text. It is zeroed if authentication fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param nonce pointer to the 32-byte nonce
+ * @param tagsize size of the tag: 16 or 32
+ * @param tag pointer to the tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise
+ */
+int aes_aegis256_open(AesAegis256Context *ctx, size_t textsize,
+                      unsigned char *plain_text,
+                      const unsigned char *cipher_text, size_t aadsize,
+                      const unsigned char *aad,
+                      const unsigned char nonce[32], size_t tagsize,
+                      const unsigned char *tag);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-XTS
+ * functions
+ */
+typedef struct AesXtsContext AesXtsContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesXtsContext {
+  AesContext data_key;
+  AesContext tweak_key;
+  struct aes_xts_vtable *xts_vtable;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-XTS context (IEEE 1619).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use for each of the two keys. Only
+ * KEY_TYPE_AES128 & KEY_TYPE_AES256 are defined for XTS.
+ * @param key Pointer to the data key followed by the tweak key, each of them
+ * `key_type / 8` bytes long
+ * @return 0 on success, -1 if key_type is KEY_TYPE_AES192
+ */
+int aes_xts_init(AesXtsContext *ctx, enum AesKeyType key_type,
+                 const unsigned char *key);
+
+/**
+ * @brief Encrypt one data unit in plain_text using AES-XTS and store the
+ * encrypted data to cipher_text
+ *
+ * @param ctx pointer to AES-XTS state
+ * @param textsize size of data to be encrypted. It must be at least 16; sizes
+ * not divisible by 16 use ciphertext stealing.
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ * @param tweak the 16-byte tweak of the data unit
+ * @return 0 on success, -1 if textsize is less than 16
+ */
+int aes_xts_encrypt(AesXtsContext *ctx, size_t textsize,
+                    unsigned char *cipher_text,
+                    const unsigned char *plain_text,
+                    const unsigned char tweak[16]);
+
+/**
+ * @brief Decrypt one data unit in cipher_text using AES-XTS and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AES-XTS state
+ * @param textsize size of data to be decrypted. It must be at least 16.
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize.
+ * @param cipher_text pointer to data to be decrypted
+ * @param tweak the 16-byte tweak of the data unit
+ * @return 0 on success, -1 if textsize is less than 16
+ */
+int aes_xts_decrypt(AesXtsContext *ctx, size_t textsize,
+                    unsigned char *plain_text,
+                    const unsigned char *cipher_text,
+                    const unsigned char tweak[16]);
+
+/**
+ * @brief Encrypt consecutive sectors using AES-XTS, with the sector number as
+ * the tweak
+ *
+ * The tweak of each sector is its number as a 128-bit little-endian integer,
+ * as used by dm-crypt's `plain64` & most disk encryption software.
+ *
+ * @param ctx pointer to AES-XTS state
+ * @param sector_size size of each sector. It must be at least 16.
+ * @param nsectors number of sectors
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= sector_size * nsectors.
+ * @param plain_text pointer to data to be encrypted
+ * @param first_sector number of the first sector
+ * @return 0 on success, -1 if sector_size is less than 16
+ */
+int aes_xts_encrypt_sectors(AesXtsContext *ctx, size_t sector_size,
+                            size_t nsectors, unsigned char *cipher_text,
+                            const unsigned char *plain_text,
+                            uint64_t first_sector);
+
+/**
+ * @brief Decrypt consecutive sectors using AES-XTS, with the sector number as
+ * the tweak
+ *
+ * @param ctx pointer to AES-XTS state
+ * @param sector_size size of each sector. It must be at least 16.
+ * @param nsectors number of sectors
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= sector_size * nsectors.
+ * @param cipher_text pointer to data to be decrypted
+ * @param first_sector number of the first sector
+ * @return 0 on success, -1 if sector_size is less than 16
+ */
+int aes_xts_decrypt_sectors(AesXtsContext *ctx, size_t sector_size,
+                            size_t nsectors, unsigned char *plain_text,
+                            const unsigned char *cipher_text,
+                            uint64_t first_sector);
+
+/**
+ * @brief Structure for storing internal information needed by the HCTR2
+ * functions
+ */
+typedef struct AesHctr2Context AesHctr2Context;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesHctr2Context {
+  AesContext aes;
+  struct aes_hctr2_vtable *hctr2_vtable;
+  /* POLYVAL table of the hash key E(K, 0^128), in the layout of the selected
+   * engine */
+  AY_AES_ALIGNAS(16)
+  unsigned char h_table[NUM_GHASH_TABLE_ENTRIES * 16];
+  /* E(K, LE128(1)) */
+  unsigned char l[16];
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the HCTR2 context.
+ *
+ * The hash key & the mask L are derived here once per key.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_hctr2_init(AesHctr2Context *ctx, enum AesKeyType key_type,
+                    const unsigned char *key);
+
+/**
+ * @brief Encrypt a string in plain_text using HCTR2 and store the encrypted
+ * data to cipher_text
+ *
+ * HCTR2 is a tweakable wide-block cipher: every bit of the cipher text depends
+ * on every bit of the plain text, and the cipher text is as long as the plain
+ * text.
+ *
+ * @param ctx pointer to HCTR2 state
+ * @param textsize size of data to be encrypted. It must be at least 16.
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. It may be equal to plain_text.
+ * @param plain_text pointer to data to be encrypted
+ * @param tweaksize size of the tweak
+ * @param tweak pointer to the tweak. Can be NULL if tweaksize is 0.
+ * @return 0 on success, -1 if textsize is less than 16
+ */
+int aes_hctr2_encrypt(AesHctr2Context *ctx, size_t textsize,
+                      unsigned char *cipher_text,
+                      const unsigned char *plain_text, size_t tweaksize,
+                      const unsigned char *tweak);
+
+/**
+ * @brief Decrypt a string in cipher_text using HCTR2 and store the decrypted
+ * data to plain_text
+ *
+ * @param ctx pointer to HCTR2 state
+ * @param textsize size of data to be decrypted. It must be at least 16.
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * It may be equal to cipher_text.
+ * @param cipher_text pointer to data to be decrypted
+ * @param tweaksize size of the tweak
+ * @param tweak pointer to the tweak. Can be NULL if tweaksize is 0.
+ * @return 0 on success, -1 if textsize is less than 16
+ */
+int aes_hctr2_decrypt(AesHctr2Context *ctx, size_t textsize,
+                      unsigned char *plain_text,
+                      const unsigned char *cipher_text, size_t tweaksize,
+                      const unsigned char *tweak);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-OCB
+ * functions
+ */
+typedef struct AesOcbContext AesOcbContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesOcbContext {
+  AesContext aes;
+  struct aes_ocb_vtable *ocb_vtable;
+  /* L_*, L_$ & L_0 to L_31 of RFC 7253 */
+  AY_AES_ALIGNAS(16)
+  unsigned char l_table[NUM_OCB_L_TABLE_ENTRIES * 16];
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-OCB context (OCB3, RFC 7253).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_ocb_init(AesOcbContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AES-OCB and store
+ * the encrypted data to cipher_text
+ *
+ * @param ctx pointer to AES-OCB state
+ * @param textsize size of data to be encrypted (less than 2^36 bytes)
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data (less than 2^36 bytes)
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param noncesize size of nonce (1 to 15 bytes; 12 is recommended)
+ * @param nonce pointer to nonce
+ * @param tagsize size of authentication tag (1 to 16 bytes). It is part of the
+ * nonce processing, so a message sealed with one tag size cannot be opened
+ * with another.
+ * @param tag pointer to memory where the authentication tag must be written to
+ * @return 0 on success, -1 if noncesize, tagsize, textsize or aadsize is
+ * invalid (nothing is written)
+ */
+int aes_ocb_seal(AesOcbContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 unsigned char *tag);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AES-OCB and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AES-OCB state
+ * @param textsize size of data to be decrypted (less than 2^36 bytes)
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize. It is zeroed if authentication
+ * fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data (less than 2^36 bytes)
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param noncesize size of nonce (1 to 15 bytes)
+ * @param nonce pointer to nonce
+ * @param tagsize size of authentication tag (1 to 16 bytes)
+ * @param tag pointer to the authentication tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise (or if noncesize, tagsize,
+ * textsize or aadsize is invalid, in which case nothing is written)
+ */
+int aes_ocb_open(AesOcbContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 const unsigned char *tag);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-CCM
+ * functions
+ */
+typedef struct AesCcmContext AesCcmContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesCcmContext {
+  AesContext aes;
+  struct aes_ccm_vtable *ccm_vtable;
+};
+/** @endcond */
+
+/**
+ * @brief One message of aes_ccm_seal_multi() & aes_ccm_open_multi()
+ */
+typedef struct AesCcmMessage {
+  size_t textsize;            /**< Size of the plain/cipher text */
+  unsigned char *out;         /**< Output (cipher text when sealing) */
+  const unsigned char *in;    /**< Input (plain text when sealing) */
+  size_t aadsize;             /**< Size of additional authenticated data */
+  const unsigned char *aad;   /**< Additional authenticated data */
+  const unsigned char *nonce; /**< Nonce */
+  unsigned char *tag;         /**< Tag (written by seal, read by open) */
+} AesCcmMessage;
+
+/**
+ * @brief Initialize the AES-CCM context.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_ccm_init(AesCcmContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AES-CCM and store
+ * the encrypted data to cipher_text
+ *
+ * @param ctx pointer to AES-CCM state
+ * @param textsize size of data to be encrypted. It must be less than
+ * 2^(8 * (15 - noncesize)) bytes.
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param noncesize size of nonce (7 to 13 bytes)
+ * @param nonce pointer to nonce
+ * @param tagsize size of authentication tag (4, 6, 8, 10, 12, 14 or 16 bytes)
+ * @param tag pointer to memory where the authentication tag must be written to
+ * @return 0 on success, -1 if noncesize or tagsize is invalid or if textsize
+ * doesn't fit (nothing is written)
+ */
+int aes_ccm_seal(AesCcmContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 unsigned char *tag);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AES-CCM and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AES-CCM state
+ * @param textsize size of data to be decrypted. It must be less than
+ * 2^(8 * (15 - noncesize)) bytes.
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize. It is zeroed if authentication
+ * fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param noncesize size of nonce (7 to 13 bytes)
+ * @param nonce pointer to nonce
+ * @param tagsize size of authentication tag (4, 6, 8, 10, 12, 14 or 16 bytes)
+ * @param tag pointer to the authentication tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise (or if noncesize, tagsize or
+ * textsize is invalid, in which case nothing is written)
+ */
+int aes_ccm_open(AesCcmContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 const unsigned char *tag);
+
+/**
+ * @brief Seal several independent messages with AES-CCM
+ *
+ * The CBC-MAC chains of up to 8 messages are advanced together, so small
+ * messages are sealed at the throughput of the cipher instead of its latency.
+ *
+ * @param ctx pointer to AES-CCM state
+ * @param nmessages number of messages
+ * @param messages the messages, as for aes_ccm_seal()
+ * @param noncesize size of the nonce of every message
+ * @param tagsize size of the tag of every message
+ * @return 0 on success, -1 if noncesize or tagsize is invalid or if the
+ * textsize of a message doesn't fit (nothing is written)
+ */
+int aes_ccm_seal_multi(AesCcmContext *ctx, size_t nmessages,
+                       const AesCcmMessage *messages, size_t noncesize,
+                       size_t tagsize);
+
+/**
+ * @brief Verify & decrypt several independent messages with AES-CCM
+ *
+ * @param ctx pointer to AES-CCM state
+ * @param nmessages number of messages
+ * @param messages the messages, as for aes_ccm_open(). The output of each
+ * message that fails authentication is zeroed.
+ * @param noncesize size of the nonce of every message
+ * @param tagsize size of the tag of every message
+ * @param results if not NULL, receives 0 or -1 for each message
+ * @return 0 if all tags are valid, -1 otherwise. If noncesize or tagsize is
+ * invalid or if the textsize of a message doesn't fit, every result is -1 &
+ * nothing is written.
+ */
+int aes_ccm_open_multi(AesCcmContext *ctx, size_t nmessages,
+                       const AesCcmMessage *messages, size_t noncesize,
+                       size_t tagsize, int *results);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-CMAC
+ * functions
+ */
+typedef struct AesCmacContext AesCmacContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesCmacContext {
+  AesContext aes;
+  struct aes_cmac_vtable *cmac_vtable;
+  unsigned char k1[16];
+  unsigned char k2[16];
+};
+/** @endcond */
+
+/**
+ * @brief One message of aes_cmac_multi()
+ */
+typedef struct AesCmacMessage {
+  size_t size;             /**< Size of the message */
+  const unsigned char *in; /**< Message */
+  unsigned char *mac;      /**< 16 bytes where the MAC must be written to */
+} AesCmacMessage;
+
+/**
+ * @brief Initialize the AES-CMAC context & derive the CMAC subkeys.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_cmac_init(AesCmacContext *ctx, enum AesKeyType key_type,
+                   const unsigned char *key);
+
+/**
+ * @brief Compute the AES-CMAC (RFC 4493) of a message
+ *
+ * @param ctx pointer to AES-CMAC state
+ * @param size size of the message
+ * @param in pointer to the message. Can be NULL if size is 0.
+ * @param mac pointer to 16 bytes where the MAC must be written to
+ */
+void aes_cmac(AesCmacContext *ctx, size_t size, const unsigned char *in,
+              unsigned char mac[16]);
+
+/**
+ * @brief Compute the AES-CMAC of several independent messages
+ *
+ * The CBC-MAC chains of up to 8 messages are advanced together, so small
+ * messages are processed at the throughput of the cipher instead of its
+ * latency.
+ *
+ * @param ctx pointer to AES-CMAC state
+ * @param nmessages number of messages
+ * @param messages the messages
+ */
+void aes_cmac_multi(AesCmacContext *ctx, size_t nmessages,
+                    const AesCmacMessage *messages);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-EAX
+ * functions
+ */
+typedef struct AesEaxContext AesEaxContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesEaxContext {
+  AesContext aes;
+  struct aes_eax_vtable *eax_vtable;
+  unsigned char k1[16];
+  unsigned char k2[16];
+  /* E(K, [t]), the OMAC^t chain after its first block, for t = 0, 1, 2 */
+  unsigned char l[3][16];
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-EAX context.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_eax_init(AesEaxContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key);
+
+/**
+ * @brief Encrypt and authenticate data in plain_text using AES-EAX and store
+ * the encrypted data to cipher_text
+ *
+ * @param ctx pointer to AES-EAX state
+ * @param textsize size of data to be encrypted
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize. It may be equal to plain_text.
+ * @param plain_text pointer to data to be encrypted
+ * @param aadsize size of additional authenticated data (the EAX header)
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param noncesize size of nonce, of any length
+ * @param nonce pointer to nonce. Can be NULL if noncesize is 0.
+ * @param tagsize size of authentication tag (1 to 16 bytes)
+ * @param tag pointer to memory where the authentication tag must be written to
+ * @return 0 on success, -1 if tagsize is invalid (nothing is written)
+ */
+int aes_eax_seal(AesEaxContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 unsigned char *tag);
+
+/**
+ * @brief Verify and decrypt data in cipher_text using AES-EAX and store the
+ * decrypted data to plain_text
+ *
+ * @param ctx pointer to AES-EAX state
+ * @param textsize size of data to be decrypted
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize. It is zeroed if authentication
+ * fails. It may be equal to cipher_text.
+ * @param cipher_text pointer to data to be decrypted
+ * @param aadsize size of additional authenticated data (the EAX header)
+ * @param aad pointer to additional authenticated data. Can be NULL if aadsize
+ * is 0.
+ * @param noncesize size of nonce
+ * @param nonce pointer to nonce. Can be NULL if noncesize is 0.
+ * @param tagsize size of authentication tag (1 to 16 bytes)
+ * @param tag pointer to the authentication tag to be verified
+ * @return 0 if the tag is valid, -1 otherwise
+ */
+int aes_eax_open(AesEaxContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 const unsigned char *tag);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-PMAC
+ * functions
+ */
+typedef struct AesPmacContext AesPmacContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesPmacContext {
+  /* PMAC offsets are those of OCB; l_table holds L(-1), an unused entry &
+   * L(0) to L(31) so the OCB kernels can be used unchanged. */
+  AesOcbContext ocb;
+};
+/** @endcond */
+
+/**
+ * @brief State of an incremental AES-PMAC computation over one chunk of a
+ * message
+ */
+typedef struct AesPmacState AesPmacState;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesPmacState {
+  uint64_t first_block;
+  uint64_t next_block;
+  unsigned char offset[16];
+  unsigned char sum[16];
+  unsigned char buffer[16];
+  size_t buffersize;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-PMAC context (PMAC1 with Gray code offsets).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ */
+void aes_pmac_init(AesPmacContext *ctx, enum AesKeyType key_type,
+                   const unsigned char *key);
+
+/**
+ * @brief Compute the AES-PMAC of a message
+ *
+ * @param ctx pointer to AES-PMAC state
+ * @param size size of the message. It must be at most 2^36 bytes.
+ * @param in pointer to the message. Can be NULL if size is 0.
+ * @param mac pointer to 16 bytes where the MAC must be written to
+ * @return 0 on success, -1 if size is too large (nothing is written)
+ */
+int aes_pmac(AesPmacContext *ctx, size_t size, const unsigned char *in,
+             unsigned char mac[16]);
+
+/**
+ * @brief Start an incremental AES-PMAC computation over the chunk of a
+ * message beginning at byte 16 * first_block
+ *
+ * Chunks of one message can be processed independently (e.g. by different
+ * threads sharing ctx, which is not modified), then merged in order with
+ * aes_pmac_combine().
+ *
+ * The offsets are defined for the blocks of messages of at most 2^36 bytes,
+ * so first_block must be less than 2^32.
+ *
+ * @param ctx pointer to AES-PMAC state
+ * @param state pointer to the state of the chunk
+ * @param first_block index of the first 16-byte block of the chunk
+ * @return 0 on success, -1 if first_block is too large
+ */
+int aes_pmac_start(AesPmacContext *ctx, AesPmacState *state,
+                   uint64_t first_block);
+
+/**
+ * @brief Absorb data into an incremental AES-PMAC computation
+ *
+ * @param ctx pointer to AES-PMAC state
+ * @param state pointer to the state of the chunk
+ * @param size size of data
+ * @param in pointer to data
+ * @return 0 on success, -1 if the chunk would end past byte 2^36 of the
+ * message (nothing is absorbed)
+ */
+int aes_pmac_update(AesPmacContext *ctx, AesPmacState *state, size_t size,
+                    const unsigned char *in);
+
+/**
+ * @brief Merge the state of the chunk directly following the one of state
+ * into state
+ *
+ * @param ctx pointer to AES-PMAC state
+ * @param state pointer to the state of a chunk. Its size must be a multiple
+ * of 16 bytes.
+ * @param next pointer to the state of the next chunk
+ * @return 0 on success, -1 if next doesn't start where state ends
+ */
+int aes_pmac_combine(AesPmacContext *ctx, AesPmacState *state,
+                     const AesPmacState *next);
+
+/**
+ * @brief Finish an incremental AES-PMAC computation
+ *
+ * @param ctx pointer to AES-PMAC state
+ * @param state pointer to the state of the whole message, i.e. of a chunk
+ * started at block 0
+ * @param mac pointer to 16 bytes where the MAC must be written to
+ */
+void aes_pmac_final(AesPmacContext *ctx, const AesPmacState *state,
+                    unsigned char mac[16]);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-CFB
+ * functions, including the state of the current message
+ */
+typedef struct AesCfbContext AesCfbContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesCfbContext {
+  AesContext aes;
+  struct aes_cfb_vtable *cfb_vtable;
+  /* Shift register. In the middle of a CFB128 block, its first `used` bytes
+   * are cipher text & the others are still key stream. */
+  unsigned char iv[16];
+  size_t used;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-CFB context & start a message.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ * @param iv Initialization vector of the message
+ */
+void aes_cfb_init(AesCfbContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key, const unsigned char iv[16]);
+
+/**
+ * @brief Start a new message with the key of ctx.
+ *
+ * @param ctx Pointer to context
+ * @param iv Initialization vector of the message
+ */
+void aes_cfb_set_iv(AesCfbContext *ctx, const unsigned char iv[16]);
+
+/**
+ * @brief Encrypt data in plain_text using AES-CFB128 and store the encrypted
+ * data to cipher_text
+ *
+ * The message may be processed in parts of any size by successive calls; a
+ * message must only be processed by one of the CFB128 & CFB8 variants.
+ *
+ * @param ctx pointer to AES-CFB state
+ * @param textsize size of data to be encrypted
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ */
+void aes_cfb128_encrypt(AesCfbContext *ctx, size_t textsize,
+                        unsigned char *cipher_text,
+                        const unsigned char *plain_text);
+
+/**
+ * @brief Decrypt data in cipher_text using AES-CFB128 and store the decrypted
+ * data to plain_text
+ *
+ * @param ctx pointer to AES-CFB state
+ * @param textsize size of data to be decrypted
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize.
+ * @param cipher_text pointer to data to be decrypted
+ */
+void aes_cfb128_decrypt(AesCfbContext *ctx, size_t textsize,
+                        unsigned char *plain_text,
+                        const unsigned char *cipher_text);
+
+/**
+ * @brief Encrypt data in plain_text using AES-CFB8 and store the encrypted
+ * data to cipher_text
+ *
+ * @param ctx pointer to AES-CFB state
+ * @param textsize size of data to be encrypted
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize.
+ * @param plain_text pointer to data to be encrypted
+ */
+void aes_cfb8_encrypt(AesCfbContext *ctx, size_t textsize,
+                      unsigned char *cipher_text,
+                      const unsigned char *plain_text);
+
+/**
+ * @brief Decrypt data in cipher_text using AES-CFB8 and store the decrypted
+ * data to plain_text
+ *
+ * @param ctx pointer to AES-CFB state
+ * @param textsize size of data to be decrypted
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize.
+ * @param cipher_text pointer to data to be decrypted
+ */
+void aes_cfb8_decrypt(AesCfbContext *ctx, size_t textsize,
+                      unsigned char *plain_text,
+                      const unsigned char *cipher_text);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-OFB
+ * functions, including the state of the current message
+ */
+typedef struct AesOfbContext AesOfbContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesOfbContext {
+  AesContext aes;
+  struct aes_ofb_vtable *ofb_vtable;
+  /* Last key stream block generated, of which `used` bytes are consumed */
+  unsigned char iv[16];
+  size_t used;
+  /* Precomputed key stream: `ring_fill` bytes from `ring_start` on, which
+   * come before the key stream of iv */
+  unsigned char *ring;
+  size_t ring_size;
+  size_t ring_start;
+  size_t ring_fill;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the AES-OFB context & start a message.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ * @param iv Initialization vector of the message
+ */
+void aes_ofb_init(AesOfbContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key, const unsigned char iv[16]);
+
+/**
+ * @brief Start a new message with the key of ctx. Precomputed key stream is
+ * discarded.
+ *
+ * @param ctx Pointer to context
+ * @param iv Initialization vector of the message
+ */
+void aes_ofb_set_iv(AesOfbContext *ctx, const unsigned char iv[16]);
+
+/**
+ * @brief Encrypt or decrypt data using AES-OFB
+ *
+ * The message may be processed in parts of any size by successive calls.
+ * Precomputed key stream is used first, so that part of the data only costs
+ * a xor.
+ *
+ * @param ctx pointer to AES-OFB state
+ * @param textsize size of data
+ * @param out pointer to memory where the output must be written to. Size of
+ * out must be >= textsize.
+ * @param in pointer to data to be encrypted or decrypted
+ */
+void aes_ofb_xcrypt(AesOfbContext *ctx, size_t textsize, unsigned char *out,
+                    const unsigned char *in);
+
+/**
+ * @brief Set the caller-owned ring buffer where aes_ofb_precompute() stores
+ * key stream ahead of the data. Previously precomputed key stream must have
+ * been consumed.
+ *
+ * @param ctx pointer to AES-OFB state
+ * @param ring pointer to the ring buffer, which must stay valid while it is
+ * set. Can be NULL to remove the ring.
+ * @param ring_size size of the ring buffer
+ */
+void aes_ofb_set_ring(AesOfbContext *ctx, unsigned char *ring,
+                      size_t ring_size);
+
+/**
+ * @brief Fill the ring buffer with the upcoming key stream of the message
+ *
+ * @param ctx pointer to AES-OFB state
+ * @return number of bytes of key stream available in the ring buffer
+ */
+size_t aes_ofb_precompute(AesOfbContext *ctx);
+
+/**
+ * @brief Structure for storing internal information needed by the AES key
+ * wrap functions
+ */
+typedef struct AesKwContext AesKwContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesKwContext {
+  AesContext aes;
+  struct aes_kw_vtable *kw_vtable;
+};
+/** @endcond */
+
+/**
+ * @brief One key of the batch key wrap functions
+ */
+typedef struct AesKwItem {
+  size_t insize;           /**< Size of the input */
+  const unsigned char *in; /**< Input */
+  unsigned char *out;      /**< Output, as for the single key functions */
+  size_t outsize;          /**< Set to the size of the output */
+} AesKwItem;
+
+/**
+ * @brief Initialize the AES key wrap context (KW & KWP).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to the key-encryption key
+ */
+void aes_kw_init(AesKwContext *ctx, enum AesKeyType key_type,
+                 const unsigned char *key);
+
+/**
+ * @brief Wrap a key using AES-KW (RFC 3394)
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param insize size of the key to wrap. It must be a multiple of 8 & at least
+ * 16.
+ * @param out pointer to memory where the wrapped key (insize + 8 bytes) must be
+ * written to. It may be equal to in.
+ * @param in pointer to the key to wrap
+ * @return 0 on success, -1 if insize is invalid
+ */
+int aes_kw_wrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                const unsigned char *in);
+
+/**
+ * @brief Unwrap a key using AES-KW (RFC 3394)
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param insize size of the wrapped key. It must be a multiple of 8 & at least
+ * 24.
+ * @param out pointer to memory where the key (insize - 8 bytes) must be written
+ * to. It is zeroed if the integrity check fails.
+ * @param in pointer to the wrapped key
+ * @return 0 on success, -1 if insize is invalid or the integrity check fails
+ */
+int aes_kw_unwrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                  const unsigned char *in);
+
+/**
+ * @brief Wrap a key using AES-KWP (RFC 5649)
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param insize size of the key to wrap, from 1 to 2^32 - 1
+ * @param out pointer to memory where the wrapped key (insize rounded up to a
+ * multiple of 8, plus 8 bytes) must be written to
+ * @param in pointer to the key to wrap
+ * @return 0 on success, -1 if insize is invalid
+ */
+int aes_kwp_wrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                 const unsigned char *in);
+
+/**
+ * @brief Unwrap a key using AES-KWP (RFC 5649)
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param insize size of the wrapped key. It must be a multiple of 8 & at least
+ * 16.
+ * @param out pointer to memory of insize - 8 bytes where the key (followed by
+ * its padding) must be written to. It is zeroed if the integrity check fails.
+ * @param outsize pointer where the size of the key must be written to
+ * @param in pointer to the wrapped key
+ * @return 0 on success, -1 if insize is invalid or the integrity check fails
+ */
+int aes_kwp_unwrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                   size_t *outsize, const unsigned char *in);
+
+/**
+ * @brief Wrap several keys using AES-KW
+ *
+ * Up to 8 keys are wrapped together, so many small keys are wrapped at the
+ * throughput of the cipher instead of its latency. The same applies to
+ * aes_kw_unwrap_multi(), aes_kwp_wrap_multi() & aes_kwp_unwrap_multi().
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param nitems number of keys
+ * @param items the keys
+ * @param results if not NULL, receives 0 or -1 for each key
+ * @return 0 if all keys are processed successfully, -1 otherwise
+ */
+int aes_kw_wrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                      int *results);
+
+/**
+ * @brief Unwrap several keys using AES-KW
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param nitems number of keys
+ * @param items the keys
+ * @param results if not NULL, receives 0 or -1 for each key
+ * @return 0 if all keys are processed successfully, -1 otherwise
+ */
+int aes_kw_unwrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                        int *results);
+
+/**
+ * @brief Wrap several keys using AES-KWP
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param nitems number of keys
+ * @param items the keys
+ * @param results if not NULL, receives 0 or -1 for each key
+ * @return 0 if all keys are processed successfully, -1 otherwise
+ */
+int aes_kwp_wrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                       int *results);
+
+/**
+ * @brief Unwrap several keys using AES-KWP
+ *
+ * @param ctx pointer to AES key wrap state
+ * @param nitems number of keys
+ * @param items the keys
+ * @param results if not NULL, receives 0 or -1 for each key
+ * @return 0 if all keys are processed successfully, -1 otherwise
+ */
+int aes_kwp_unwrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                         int *results);
+
+/**
+ * @brief Structure for storing internal information needed by the AES-SIV
+ * functions
+ */
+typedef struct AesSivContext AesSivContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesSivContext {
+  AesCmacContext mac;
+  /* CTR key; the 64-bit counter kernels of CCM fit the masked SIV counter */
+  AesCcmContext ctr;
+  /* CMAC of the zero block, the start of S2V */
+  unsigned char d0[16];
+};
+/** @endcond */
+
+/**
+ * @brief One string of the associated data vector of AES-SIV
+ */
+typedef struct AesSivData {
+  size_t size;               /**< Size of the string */
+  const unsigned char *data; /**< String. Can be NULL if size is 0. */
+} AesSivData;
+
+/**
+ * @brief Initialize the AES-SIV context (RFC 5297).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use for each of the two keys
+ * @param key Pointer to the MAC key followed by the CTR key, each
+ * `key_type / 8` bytes long
+ */
+void aes_siv_init(AesSivContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key);
+
+/**
+ * @brief Encrypt plain_text using AES-SIV and store the encrypted data to
+ * cipher_text
+ *
+ * Encryption is deterministic: the same plain text & associated data always
+ * give the same synthetic IV & cipher text. For nonce-based use, pass the
+ * nonce as the last string of `ad`.
+ *
+ * @param ctx pointer to AES-SIV state
+ * @param textsize size of data to be encrypted
+ * @param cipher_text pointer to memory where encrypted data must be written
+ * to. Size of cipher_text must be >= textsize. It may be equal to plain_text.
+ * @param plain_text pointer to data to be encrypted
+ * @param nad number of strings of associated data, at most 126
+ * @param ad the strings of associated data. Can be NULL if nad is 0.
+ * @param siv pointer to 16 bytes where the synthetic IV must be written to
+ * @return 0 on success, -1 if nad is too large
+ */
+int aes_siv_seal(AesSivContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t nad, const AesSivData *ad, unsigned char siv[16]);
+
+/**
+ * @brief Verify & decrypt cipher_text using AES-SIV and store the decrypted
+ * data to plain_text
+ *
+ * @param ctx pointer to AES-SIV state
+ * @param textsize size of data to be decrypted
+ * @param plain_text pointer to memory where decrypted data must be written to.
+ * Size of plain_text must be >= textsize. It is zeroed if authentication
+ * fails.
+ * @param cipher_text pointer to data to be decrypted
+ * @param nad number of strings of associated data, at most 126
+ * @param ad the strings of associated data. Can be NULL if nad is 0.
+ * @param siv pointer to the synthetic IV to be verified
+ * @return 0 if the synthetic IV is valid, -1 otherwise
+ */
+int aes_siv_open(AesSivContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t nad,
+                 const AesSivData *ad, const unsigned char siv[16]);
+
+/**
+ * @brief Structure for storing internal information needed by the AES
+ * CTR_DRBG functions
+ */
+typedef struct AesCtrDrbgContext AesCtrDrbgContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesCtrDrbgContext {
+  AesCcmContext ctr;
+  unsigned char v[16];
+  uint64_t reseed_counter;
+};
+/** @endcond */
+
+/**
+ * @brief Instantiate an AES-256 CTR_DRBG (NIST SP 800-90A, without derivation
+ * function, with a 64-bit counter)
+ *
+ * An instance has no shared state, so each thread can own one & generate
+ * without locking; see aes_ctr_drbg_spawn().
+ *
+ * @param ctx Pointer to context
+ * @param entropy 48 bytes of full-entropy input
+ * @param perssize size of the personalization string, at most 48 bytes
+ * @param pers pointer to the personalization string. Can be NULL if perssize
+ * is 0.
+ * @return 0 on success, -1 if perssize is too large
+ */
+int aes_ctr_drbg_init(AesCtrDrbgContext *ctx, const unsigned char entropy[48],
+                      size_t perssize, const unsigned char *pers);
+
+/**
+ * @brief Reseed an AES CTR_DRBG instance
+ *
+ * @param ctx pointer to AES CTR_DRBG state
+ * @param entropy 48 bytes of full-entropy input
+ * @param addsize size of additional input, at most 48 bytes
+ * @param add pointer to additional input. Can be NULL if addsize is 0.
+ * @return 0 on success, -1 if addsize is too large
+ */
+int aes_ctr_drbg_reseed(AesCtrDrbgContext *ctx, const unsigned char entropy[48],
+                        size_t addsize, const unsigned char *add);
+
+/**
+ * @brief Generate random bytes using AES CTR_DRBG
+ *
+ * Outputs larger than the limit of one SP 800-90A request (64 KiB) are split
+ * into several requests; the additional input only goes into the first one.
+ *
+ * @param ctx pointer to AES CTR_DRBG state
+ * @param size number of bytes to generate
+ * @param out pointer to memory where the random bytes must be written to
+ * @param addsize size of additional input, at most 48 bytes
+ * @param add pointer to additional input. Can be NULL if addsize is 0.
+ * @return 0 on success, -1 if addsize is too large or the instance has to be
+ * reseeded first (after 2^48 requests). Nothing is generated then.
+ */
+int aes_ctr_drbg_generate(AesCtrDrbgContext *ctx, size_t size,
+                          unsigned char *out, size_t addsize,
+                          const unsigned char *add);
+
+/**
+ * @brief Instantiate a new AES CTR_DRBG from an existing one
+ *
+ * The entropy input of `child` is generated by `parent`, e.g. to give each
+ * thread its own instance from one seeded instance.
+ *
+ * @param parent pointer to the AES CTR_DRBG state to seed from
+ * @param child pointer to the context to instantiate
+ * @param perssize size of the personalization string of `child`, at most 48
+ * bytes
+ * @param pers pointer to the personalization string, e.g. a thread identifier.
+ * Can be NULL if perssize is 0.
+ * @return 0 on success, -1 otherwise
+ */
+int aes_ctr_drbg_spawn(AesCtrDrbgContext *parent, AesCtrDrbgContext *child,
+                       size_t perssize, const unsigned char *pers);
+
+/**
+ * @brief Structure for storing internal information needed by the fixed-key
+ * AES hashing functions
+ */
+typedef struct AesFixedKeyContext AesFixedKeyContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesFixedKeyContext {
+  AesContext aes;
+  struct aes_fixed_key_vtable *fixed_key_vtable;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the context of the fixed-key AES hashes, which are used
+ * e.g. to garble circuits. The key is expanded once & the permutation
+ * pi(x) = AES(key, x) is reused by every call.
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to the fixed AES key
+ */
+void aes_fixed_key_init(AesFixedKeyContext *ctx, enum AesKeyType key_type,
+                        const unsigned char *key);
+
+/**
+ * @brief Hash an array of 16-byte blocks with the correlation-robust hash
+ * pi(x) ^ x
+ *
+ * @param ctx pointer to fixed-key AES state
+ * @param textsize size of the array. It must be divisible by 16.
+ * @param out pointer to memory where the hashes must be written to. It may be
+ * equal to in.
+ * @param in pointer to the blocks to hash
+ */
+void aes_fixed_key_cr(AesFixedKeyContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in);
+
+/**
+ * @brief Hash an array of 16-byte blocks with the circular
+ * correlation-robust hash pi(sigma(x)) ^ sigma(x)
+ *
+ * sigma(L || R) = (L ^ R) || L, L being the first 8 bytes of a block.
+ *
+ * @param ctx pointer to fixed-key AES state
+ * @param textsize size of the array. It must be divisible by 16.
+ * @param out pointer to memory where the hashes must be written to. It may be
+ * equal to in.
+ * @param in pointer to the blocks to hash
+ */
+void aes_fixed_key_ccr(AesFixedKeyContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in);
+
+/**
+ * @brief Hash an array of 16-byte blocks with the tweakable circular
+ * correlation-robust hash pi(pi(x) ^ i) ^ pi(x)
+ *
+ * @param ctx pointer to fixed-key AES state
+ * @param textsize size of the array. It must be divisible by 16.
+ * @param out pointer to memory where the hashes must be written to. It may be
+ * equal to in.
+ * @param in pointer to the blocks to hash
+ * @param tweak tweak of the first block. Block j uses tweak + j, as 8
+ * little-endian bytes followed by 8 zero bytes.
+ */
+void aes_fixed_key_tccr(AesFixedKeyContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        uint64_t tweak);
+
+/**
+ * @brief Structure for storing internal information needed by the keyed
+ * Haraka hashing functions
+ */
+typedef struct AesHarakaContext AesHarakaContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesHarakaContext {
+  struct aes_haraka_vtable *haraka_vtable;
+  AY_AES_ALIGNAS(16)
+  unsigned char rc[NUM_HARAKA_ROUND_CONSTANTS * SIZE_OF_AES_ROUND_KEY];
+};
+/** @endcond */
+
+/**
+ * @brief One message of aes_haraka_hash_multi()
+ */
+typedef struct AesHarakaMessage {
+  size_t size;               /**< Size of the message */
+  const unsigned char *data; /**< Message */
+  unsigned char *digest;     /**< 32-byte digest */
+} AesHarakaMessage;
+
+/**
+ * @brief Initialize the context of the keyed Haraka v2 hashes.
+ *
+ * They are short-input hashes made of AES rounds, meant for hash tables &
+ * deduplication fingerprints: a secret key makes the outputs unpredictable,
+ * but they are not MACs. The round constants are AES-128 encryptions of
+ * 0, 1, ..., 39 (little-endian) under the key, instead of the fixed constants
+ * of Haraka v2, so the digests differ from unkeyed Haraka.
+ *
+ * @param ctx Pointer to context
+ * @param key Pointer to the 16-byte key
+ */
+void aes_haraka_init(AesHarakaContext *ctx, const unsigned char key[16]);
+
+/**
+ * @brief Hash an array of 32-byte inputs with Haraka-256
+ *
+ * @param ctx pointer to keyed Haraka state
+ * @param count number of inputs
+ * @param out pointer to memory where the 32-byte digests must be written to.
+ * It may be equal to in.
+ * @param in pointer to the inputs
+ */
+void aes_haraka256(AesHarakaContext *ctx, size_t count, unsigned char *out,
+                   const unsigned char *in);
+
+/**
+ * @brief Hash an array of 64-byte inputs with Haraka-512
+ *
+ * @param ctx pointer to keyed Haraka state
+ * @param count number of inputs
+ * @param out pointer to memory where the 32-byte digests must be written to.
+ * It may be equal to in.
+ * @param in pointer to the inputs
+ */
+void aes_haraka512(AesHarakaContext *ctx, size_t count, unsigned char *out,
+                   const unsigned char *in);
+
+/**
+ * @brief Hash a message of any size
+ *
+ * The message is zero-padded to 32-byte blocks, followed by a last block of
+ * LE64(size) & 24 zero bytes. The blocks are absorbed in turn by
+ * h = Haraka-512(h || block), starting from h = 0. The digest is the last h.
+ *
+ * @param ctx pointer to keyed Haraka state
+ * @param size size of the message
+ * @param data pointer to the message. Can be NULL if size is 0.
+ * @param digest pointer to memory where the 32-byte digest must be written to
+ */
+void aes_haraka_hash(AesHarakaContext *ctx, size_t size,
+                     const unsigned char *data, unsigned char digest[32]);
+
+/**
+ * @brief Hash several messages, as aes_haraka_hash() does
+ *
+ * Messages go through the kernel side by side, which fills the AES units that
+ * the serial chain of a single message leaves idle: from about 15% faster
+ * than aes_haraka_hash() on 16-byte keys up to 1.5 times on long messages.
+ *
+ * @param ctx pointer to keyed Haraka state
+ * @param nmessages number of messages
+ * @param messages the messages
+ */
+void aes_haraka_hash_multi(AesHarakaContext *ctx, size_t nmessages,
+                           const AesHarakaMessage *messages);
+
+/**
+ * @brief Structure for storing internal information needed by the streaming
+ * Haraka hash, including the state of the current message
+ */
+typedef struct AesHarakaStreamContext AesHarakaStreamContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesHarakaStreamContext {
+  AesHarakaContext haraka;
+  /* Chaining value, & the bytes of a block split between two parts */
+  unsigned char h[32];
+  unsigned char buffer[32];
+  size_t buffered;
+  /* Size hashed so far, absorbed in the last block */
+  uint64_t size;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the streaming Haraka context & start a message.
+ *
+ * @param ctx Pointer to context
+ * @param key Pointer to the 16-byte key
+ */
+void aes_haraka_stream_init(AesHarakaStreamContext *ctx,
+                            const unsigned char key[16]);
+
+/**
+ * @brief Start a new message with the key of ctx.
+ *
+ * The size of the message is absorbed by aes_haraka_stream_final(), so it
+ * need not be known in advance.
+ *
+ * @param ctx Pointer to context
+ */
+void aes_haraka_stream_start(AesHarakaStreamContext *ctx);
+
+/**
+ * @brief Hash the next part of a message
+ *
+ * Parts may have any size: the bytes of a block split between two parts are
+ * buffered, and the whole blocks of a part go through the kernel in place.
+ *
+ * @param ctx pointer to streaming Haraka state
+ * @param size size of the part
+ * @param data pointer to the part. Can be NULL if size is 0.
+ */
+void aes_haraka_stream_update(AesHarakaStreamContext *ctx, size_t size,
+                              const unsigned char *data);
+
+/**
+ * @brief Finish the message & write its digest
+ *
+ * The digest is the one aes_haraka_hash() gives for the whole message.
+ *
+ * @param ctx pointer to streaming Haraka state
+ * @param digest pointer to memory where the 32-byte digest must be written to
+ */
+void aes_haraka_stream_final(AesHarakaStreamContext *ctx,
+                             unsigned char digest[32]);
+
+/**
+ * @brief Structure for storing internal information needed by the GHASH &
+ * POLYVAL functions, including the state of the current message
+ */
+typedef struct AesGhashContext AesGhashContext;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesGhashContext {
+  struct aes_ghash_vtable *ghash_vtable;
+  /* Powers of the hash key in the layout of the selected engine, as in
+   * AesGcmContext. */
+  AY_AES_ALIGNAS(16)
+  unsigned char h_table[NUM_GHASH_TABLE_ENTRIES * 16];
+  unsigned char s[16];
+  unsigned char buffer[16];
+  size_t buffersize;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the context for GHASH (NIST SP 800-38D) with the hash key
+ * h, e.g. the encryption of the zero block under a GCM key
+ *
+ * The powers of h are computed once here, so that updates hash several blocks
+ * per reduction with the GCM kernels.
+ *
+ * @param ctx Pointer to context
+ * @param h Pointer to the 16-byte hash key
+ */
+void aes_ghash_init(AesGhashContext *ctx, const unsigned char h[16]);
+
+/**
+ * @brief Initialize the context for POLYVAL (RFC 8452) with the hash key h
+ *
+ * @param ctx Pointer to context
+ * @param h Pointer to the 16-byte hash key
+ */
+void aes_polyval_init(AesGhashContext *ctx, const unsigned char h[16]);
+
+/**
+ * @brief Start a new message with the same hash key
+ *
+ * @param ctx pointer to GHASH/POLYVAL state
+ */
+void aes_ghash_reset(AesGhashContext *ctx);
+
+/**
+ * @brief Absorb data into the current message
+ *
+ * A message can be absorbed in parts of any size.
+ *
+ * @param ctx pointer to GHASH/POLYVAL state
+ * @param size size of data
+ * @param in pointer to data
+ */
+void aes_ghash_update(AesGhashContext *ctx, size_t size,
+                      const unsigned char *in);
+
+/**
+ * @brief Pad the data absorbed so far with zeros to a multiple of 16 bytes,
+ * e.g. between the AAD & the cipher text of GCM
+ *
+ * @param ctx pointer to GHASH/POLYVAL state
+ */
+void aes_ghash_pad(AesGhashContext *ctx);
+
+/**
+ * @brief Compute the hash of the data absorbed so far, zero-padded to a
+ * multiple of 16 bytes
+ *
+ * The state is not modified, so more data can be absorbed afterwards.
+ *
+ * @param ctx pointer to GHASH/POLYVAL state
+ * @param out pointer to 16 bytes where the hash must be written to
+ */
+void aes_ghash_final(const AesGhashContext *ctx, unsigned char out[16]);
+
+/** Largest radix of FF1 & FF3-1 */
+#define AES_FPE_MAX_RADIX 65536
+/** Largest number of numerals in an FF1 token */
+#define AES_FF1_MAX_LEN 256
+
+/**
+ * @brief One token of the FF1 & FF3-1 batch functions
+ *
+ * Tokens are strings of numerals, each less than the radix, most significant
+ * first.
+ */
+typedef struct AesFpeToken {
+  uint16_t *out;              /**< Output numerals. May be equal to `in`. */
+  const uint16_t *in;         /**< Input numerals */
+  const unsigned char *tweak; /**< Tweak. Can be NULL if it is empty. */
+} AesFpeToken;
+
+/**
+ * @brief Structure for storing internal information needed by the FF1
+ * functions
+ */
+typedef struct AesFf1Context AesFf1Context;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesFf1Context {
+  AesContext aes;
+  struct aes_fpe_vtable *fpe_vtable;
+  unsigned radix;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the FF1 context (NIST SP 800-38G).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ * @param radix radix of the numerals, from 2 to AES_FPE_MAX_RADIX
+ * @return 0 on success, -1 if radix is out of range
+ */
+int aes_ff1_init(AesFf1Context *ctx, enum AesKeyType key_type,
+                 const unsigned char *key, unsigned radix);
+
+/**
+ * @brief Encrypt a string of numerals using FF1
+ *
+ * @param ctx pointer to FF1 state
+ * @param n number of numerals, at least 2 & at most AES_FF1_MAX_LEN, with
+ * radix^n >= 1000000
+ * @param out pointer to memory where the n encrypted numerals must be written
+ * to. It may be equal to in.
+ * @param in pointer to the numerals to be encrypted
+ * @param tweaksize size of the tweak
+ * @param tweak pointer to the tweak. Can be NULL if tweaksize is 0.
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix
+ */
+int aes_ff1_encrypt(AesFf1Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, size_t tweaksize,
+                    const unsigned char *tweak);
+
+/**
+ * @brief Decrypt a string of numerals using FF1
+ *
+ * @param ctx pointer to FF1 state
+ * @param n number of numerals, as for aes_ff1_encrypt()
+ * @param out pointer to memory where the n decrypted numerals must be written
+ * to. It may be equal to in.
+ * @param in pointer to the numerals to be decrypted
+ * @param tweaksize size of the tweak
+ * @param tweak pointer to the tweak. Can be NULL if tweaksize is 0.
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix
+ */
+int aes_ff1_decrypt(AesFf1Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, size_t tweaksize,
+                    const unsigned char *tweak);
+
+/**
+ * @brief Encrypt several tokens of the same size using FF1
+ *
+ * The Feistel rounds of up to 8 tokens run in lockstep, so their CBC-MACs
+ * fill the AES pipeline instead of waiting on its latency.
+ *
+ * @param ctx pointer to FF1 state
+ * @param ntokens number of tokens
+ * @param tokens the tokens
+ * @param n number of numerals of every token, as for aes_ff1_encrypt()
+ * @param tweaksize size of the tweak of every token
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix, in which case no token is processed
+ */
+int aes_ff1_encrypt_multi(AesFf1Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n,
+                          size_t tweaksize);
+
+/**
+ * @brief Decrypt several tokens of the same size using FF1
+ *
+ * @param ctx pointer to FF1 state
+ * @param ntokens number of tokens
+ * @param tokens the tokens
+ * @param n number of numerals of every token, as for aes_ff1_encrypt()
+ * @param tweaksize size of the tweak of every token
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix, in which case no token is processed
+ */
+int aes_ff1_decrypt_multi(AesFf1Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n,
+                          size_t tweaksize);
+
+/**
+ * @brief Structure for storing internal information needed by the FF3-1
+ * functions
+ */
+typedef struct AesFf3Context AesFf3Context;
+
+/** @cond
+ * **PRIVATE**: Do not use any private field of this structure
+ */
+struct AesFf3Context {
+  AesContext aes;
+  struct aes_fpe_vtable *fpe_vtable;
+  unsigned radix;
+};
+/** @endcond */
+
+/**
+ * @brief Initialize the FF3-1 context (NIST SP 800-38G Rev. 1).
+ *
+ * @param ctx Pointer to context
+ * @param key_type Variant of AES to use
+ * @param key Pointer to AES key
+ * @param radix radix of the numerals, from 2 to AES_FPE_MAX_RADIX
+ * @return 0 on success, -1 if radix is out of range
+ */
+int aes_ff3_init(AesFf3Context *ctx, enum AesKeyType key_type,
+                 const unsigned char *key, unsigned radix);
+
+/**
+ * @brief Encrypt a string of numerals using FF3-1
+ *
+ * @param ctx pointer to FF3-1 state
+ * @param n number of numerals, at least 2 & at most
+ * 2 * floor(log_radix(2^96)), with radix^n >= 1000000
+ * @param out pointer to memory where the n encrypted numerals must be written
+ * to. It may be equal to in.
+ * @param in pointer to the numerals to be encrypted
+ * @param tweak pointer to the 56-bit tweak
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix
+ */
+int aes_ff3_encrypt(AesFf3Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, const unsigned char tweak[7]);
+
+/**
+ * @brief Decrypt a string of numerals using FF3-1
+ *
+ * @param ctx pointer to FF3-1 state
+ * @param n number of numerals, as for aes_ff3_encrypt()
+ * @param out pointer to memory where the n decrypted numerals must be written
+ * to. It may be equal to in.
+ * @param in pointer to the numerals to be decrypted
+ * @param tweak pointer to the 56-bit tweak
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix
+ */
+int aes_ff3_decrypt(AesFf3Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, const unsigned char tweak[7]);
+
+/**
+ * @brief Encrypt several tokens of the same size using FF3-1
+ *
+ * The Feistel rounds of up to 8 tokens run in lockstep, so each round is a
+ * single multi-block call to the cipher.
+ *
+ * @param ctx pointer to FF3-1 state
+ * @param ntokens number of tokens
+ * @param tokens the tokens, each with a 7-byte tweak
+ * @param n number of numerals of every token, as for aes_ff3_encrypt()
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix, in which case no token is processed
+ */
+int aes_ff3_encrypt_multi(AesFf3Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n);
+
+/**
+ * @brief Decrypt several tokens of the same size using FF3-1
+ *
+ * @param ctx pointer to FF3-1 state
+ * @param ntokens number of tokens
+ * @param tokens the tokens, each with a 7-byte tweak
+ * @param n number of numerals of every token, as for aes_ff3_encrypt()
+ * @return 0 on success, -1 if n is out of range or a numeral is not less than
+ * the radix, in which case no token is processed
+ */
+int aes_ff3_decrypt_multi(AesFf3Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n);
+
 #undef SIZE_OF_AES_ROUND_KEY
 #undef NUM_ROUND_KEYS_IN_ARRAY
+#undef NUM_GHASH_TABLE_ENTRIES
+#undef NUM_OCB_L_TABLE_ENTRIES
+#undef NUM_HARAKA_ROUND_CONSTANTS
 
 HEDLEY_END_C_DECLS
 
@@ -0,0 +1,86 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* Tags are 128 or 256 bits; the latter is not a longer form of the former. */
+static int aegis_tagsize_is_valid(size_t tagsize) {
+  return tagsize == 16 || tagsize == 32;
+}
+
+/* Checks the tag computed by a decryption kernel, zeroing the plain text if
+ * it doesn't match. */
+static int aegis_verify(size_t textsize, unsigned char *plain_text,
+                        size_t tagsize, const unsigned char *expected_tag,
+                        const unsigned char *tag) {
+  if (aes_ct_memcmp(expected_tag, tag, tagsize) != 0) {
+    if (textsize)
+      memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  return 0;
+}
+
+int aes_aegis128l_seal(AesAegis128lContext *ctx, size_t textsize,
+                       unsigned char *cipher_text,
+                       const unsigned char *plain_text, size_t aadsize,
+                       const unsigned char *aad,
+                       const unsigned char nonce[16], size_t tagsize,
+                       unsigned char *tag) {
+  if (!aegis_tagsize_is_valid(tagsize))
+    return -1;
+
+  ctx->aegis_vtable->aegis128l_encrypt(ctx->key, nonce, aadsize, aad, textsize,
+                                       cipher_text, plain_text, tagsize, tag);
+  return 0;
+}
+
+int aes_aegis128l_open(AesAegis128lContext *ctx, size_t textsize,
+                       unsigned char *plain_text,
+                       const unsigned char *cipher_text, size_t aadsize,
+                       const unsigned char *aad,
+                       const unsigned char nonce[16], size_t tagsize,
+                       const unsigned char *tag) {
+  unsigned char expected_tag[32];
+
+  if (!aegis_tagsize_is_valid(tagsize))
+    return -1;
+
+  ctx->aegis_vtable->aegis128l_decrypt(ctx->key, nonce, aadsize, aad, textsize,
+                                       plain_text, cipher_text, tagsize,
+                                       expected_tag);
+  return aegis_verify(textsize, plain_text, tagsize, expected_tag, tag);
+}
+
+int aes_aegis256_seal(AesAegis256Context *ctx, size_t textsize,
+                      unsigned char *cipher_text,
+                      const unsigned char *plain_text, size_t aadsize,
+                      const unsigned char *aad,
+                      const unsigned char nonce[32], size_t tagsize,
+                      unsigned char *tag) {
+  if (!aegis_tagsize_is_valid(tagsize))
+    return -1;
+
+  ctx->aegis_vtable->aegis256_encrypt(ctx->key, nonce, aadsize, aad, textsize,
+                                      cipher_text, plain_text, tagsize, tag);
+  return 0;
+}
+
+int aes_aegis256_open(AesAegis256Context *ctx, size_t textsize,
+                      unsigned char *plain_text,
+                      const unsigned char *cipher_text, size_t aadsize,
+                      const unsigned char *aad,
+                      const unsigned char nonce[32], size_t tagsize,
+                      const unsigned char *tag) {
+  unsigned char expected_tag[32];
+
+  if (!aegis_tagsize_is_valid(tagsize))
+    return -1;
+
+  ctx->aegis_vtable->aegis256_decrypt(ctx->key, nonce, aadsize, aad, textsize,
+                                      plain_text, cipher_text, tagsize,
+                                      expected_tag);
+  return aegis_verify(textsize, plain_text, tagsize, expected_tag, tag);
+}
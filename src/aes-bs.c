@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "aes-bs.h"
+#include "inner.h"
 #include <ay/aes.h>
 
 #if CHAR_BIT != 8
@@ -719,67 +720,1167 @@ void printf_16b(FILE *f, const unsigned char data[16], const char *fmt, ...) {
 }
 #endif
 
-static struct AesBsState aesbs_add_bitslice(struct AesBsState lhs,
-                                            struct AesBsState rhs) {
-  struct AesBsState result;
-  memset(&result, 0, sizeof result);
-
-  uint16_t carry = 0;
-  for (size_t i = 0; i < CHAR_BIT; ++i) {
-    result.slice[i] = lhs.slice[i] ^ rhs.slice[i] ^ carry;
-    carry = (lhs.slice[i] & rhs.slice[i]) | (lhs.slice[i] & carry) |
-            (rhs.slice[i] & carry);
+/* Adds 1 to the big-endian counter in the last width / 8 bytes of the counter
+ * block, modulo 2^width. */
+static void aesbs_increment_ctr(unsigned char counter[16],
+                                enum AesCtrWidth width) {
+  for (size_t i = 16; i-- > 16 - (size_t)width / 8;) {
+    if (++counter[i])
+      break;
   }
-
-  return result;
 }
 
-static struct AesBsState aesbs_increment_bitslice(struct AesBsState a) {
-  unsigned char bytes_one[16];
-  memset(bytes_one, 0, sizeof bytes_one);
-  bytes_one[15] = 1;
+void aesbs_ctr_width_xcrypt(AesContext *ctx, enum AesCtrWidth width,
+                            size_t textsize, unsigned char *out,
+                            const unsigned char *in, unsigned char next_iv[16],
+                            const unsigned char iv[16]) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  unsigned char counter_block[16];
+  memcpy(counter_block, iv, 16);
+
+  for (size_t i = 0; i < textsize; i += 16) {
+    size_t size = textsize - i < 16 ? textsize - i : 16;
+    unsigned char stream_bytes[16];
 
-  struct AesBsState bitslice_one = store_bytes_to_bitslice(bytes_one);
+    struct AesBsState stream_block = aesbs_enc_block(
+        Nr, round_keys, store_bytes_to_bitslice(counter_block));
+    save_bitslice_to_bytes(stream_bytes, stream_block);
 
-  return aesbs_add_bitslice(a, bitslice_one);
+    for (size_t j = 0; j < size; ++j)
+      out[i + j] = in[i + j] ^ stream_bytes[j];
+
+    /* A partial last block does not consume its counter. */
+    if (size == 16)
+      aesbs_increment_ctr(counter_block, width);
+  }
+
+  if (next_iv)
+    memcpy(next_iv, counter_block, 16);
 }
 
 void aesbs_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
                       const unsigned char *in, unsigned char next_iv[16],
                       const unsigned char iv[16]) {
-  struct AesBsState iv_bitslice = store_bytes_to_bitslice(iv);
+  aesbs_ctr_width_xcrypt(ctx, AES_CTR_WIDTH_128, textsize, out, in, next_iv,
+                         iv);
+}
+
+void aesbs_xctr_xcrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char iv[16]) {
   enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  uint64_t index = 1;
+  for (size_t i = 0; i < textsize; i += 16, ++index) {
+    size_t size = textsize - i < 16 ? textsize - i : 16;
+    unsigned char counter_block[16], stream_bytes[16];
+
+    memcpy(counter_block, iv, 16);
+    for (size_t j = 0; j < 8; ++j)
+      counter_block[j] ^= (unsigned char)(index >> (8 * j));
 
+    struct AesBsState stream_block = aesbs_enc_block(
+        Nr, round_keys, store_bytes_to_bitslice(counter_block));
+    save_bitslice_to_bytes(stream_bytes, stream_block);
+
+    for (size_t j = 0; j < size; ++j)
+      out[i + j] = in[i + j] ^ stream_bytes[j];
+  }
+}
+
+/*
+ * AES-GCM
+ */
+
+static uint64_t load_u64_be(const unsigned char *src) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i)
+    value = (value << 8) | src[i];
+
+  return value;
+}
+
+static void store_u64_be(unsigned char *dest, uint64_t value) {
+  for (size_t i = 0; i < 8; ++i)
+    dest[i] = (unsigned char)(value >> (56 - 8 * i));
+}
+
+/*
+ * Constant-time GHASH without carry-less multiplication instructions, after
+ * ghash_ctmul64 of BearSSL: 64x64 carry-less products are computed with
+ * ordinary integer multiplications of operands with "holes" (one data bit in
+ * every four), so that carries never reach a data bit. The upper half of each
+ * 128-bit product is obtained from the product of the bit-reversed operands.
+ *
+ * Every step before the reduction is linear, so the products of up to
+ * GHASH_BS_AGGREGATE blocks by the matching powers of H are accumulated and
+ * reduced once.
+ */
+
+/** @brief Number of blocks hashed per reduction */
+#define GHASH_BS_AGGREGATE 8
+
+/** @brief Power of H, split for Karatsuba, with its bit-reversed halves */
+struct aesbs_ghash_key {
+  uint64_t h0, h1, h2, h0r, h1r, h2r;
+};
+
+static inline uint64_t aesbs_bmul64(uint64_t x, uint64_t y) {
+  const uint64_t m0 = UINT64_C(0x1111111111111111);
+  const uint64_t m1 = UINT64_C(0x2222222222222222);
+  const uint64_t m2 = UINT64_C(0x4444444444444444);
+  const uint64_t m3 = UINT64_C(0x8888888888888888);
+
+  uint64_t x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+  uint64_t y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+
+  uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+  uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+  uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+  uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+  return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+static inline uint64_t aesbs_rev64(uint64_t x) {
+  x = ((x & UINT64_C(0x5555555555555555)) << 1) |
+      ((x >> 1) & UINT64_C(0x5555555555555555));
+  x = ((x & UINT64_C(0x3333333333333333)) << 2) |
+      ((x >> 2) & UINT64_C(0x3333333333333333));
+  x = ((x & UINT64_C(0x0f0f0f0f0f0f0f0f)) << 4) |
+      ((x >> 4) & UINT64_C(0x0f0f0f0f0f0f0f0f));
+  x = ((x & UINT64_C(0x00ff00ff00ff00ff)) << 8) |
+      ((x >> 8) & UINT64_C(0x00ff00ff00ff00ff));
+  x = ((x & UINT64_C(0x0000ffff0000ffff)) << 16) |
+      ((x >> 16) & UINT64_C(0x0000ffff0000ffff));
+
+  return (x << 32) | (x >> 32);
+}
+
+static struct aesbs_ghash_key aesbs_ghash_key_from(uint64_t h1, uint64_t h0) {
+  struct aesbs_ghash_key key;
+  key.h0 = h0;
+  key.h1 = h1;
+  key.h2 = h0 ^ h1;
+  key.h0r = aesbs_rev64(h0);
+  key.h1r = aesbs_rev64(h1);
+  key.h2r = key.h0r ^ key.h1r;
+
+  return key;
+}
+
+/* y = (y ^ x_0) * H^n ^ x_1 * H^(n-1) ^ ... ^ x_(n-1) * H, with the key of
+ * H^k at keys[k - 1], and y[1] & y[0] the high & low halves of Y. */
+static void aesbs_ghash_chunk(const struct aesbs_ghash_key *keys, uint64_t y[2],
+                              size_t n, const unsigned char *in) {
+  uint64_t z0 = 0, z1 = 0, z2 = 0, z0h = 0, z1h = 0, z2h = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    const struct aesbs_ghash_key *key = &keys[n - 1 - i];
+    uint64_t x1 = load_u64_be(&in[i * 16]);
+    uint64_t x0 = load_u64_be(&in[i * 16 + 8]);
+    if (i == 0) {
+      x1 ^= y[1];
+      x0 ^= y[0];
+    }
+
+    uint64_t x0r = aesbs_rev64(x0), x1r = aesbs_rev64(x1);
+
+    z0 ^= aesbs_bmul64(x0, key->h0);
+    z1 ^= aesbs_bmul64(x1, key->h1);
+    z2 ^= aesbs_bmul64(x0 ^ x1, key->h2);
+    z0h ^= aesbs_bmul64(x0r, key->h0r);
+    z1h ^= aesbs_bmul64(x1r, key->h1r);
+    z2h ^= aesbs_bmul64(x0r ^ x1r, key->h2r);
+  }
+
+  z2 ^= z0 ^ z1;
+  z2h ^= z0h ^ z1h;
+  z0h = aesbs_rev64(z0h) >> 1;
+  z1h = aesbs_rev64(z1h) >> 1;
+  z2h = aesbs_rev64(z2h) >> 1;
+
+  /* 256-bit bit-reflected product, shifted by one to line it up with the
+   * GHASH bit order, then reduced modulo x^128 + x^7 + x^2 + x + 1. */
+  uint64_t v0 = z0, v1 = z0h ^ z2, v2 = z1 ^ z2h, v3 = z1h;
+
+  v3 = (v3 << 1) | (v2 >> 63);
+  v2 = (v2 << 1) | (v1 >> 63);
+  v1 = (v1 << 1) | (v0 >> 63);
+  v0 = (v0 << 1);
+
+  v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+  v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+  v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+  v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+  y[0] = v2;
+  y[1] = v3;
+}
+
+static void aesbs_ghash_load_keys(struct aesbs_ghash_key *keys,
+                                  const unsigned char *h_table) {
+  memcpy(keys, h_table, GHASH_BS_AGGREGATE * sizeof *keys);
+}
+
+static void aesbs_increment_ctr32(unsigned char counter[16]) {
+  uint32_t ctr = ((uint32_t)counter[12] << 24) | ((uint32_t)counter[13] << 16) |
+                 ((uint32_t)counter[14] << 8) | counter[15];
+  ++ctr;
+  counter[12] = (unsigned char)(ctr >> 24);
+  counter[13] = (unsigned char)(ctr >> 16);
+  counter[14] = (unsigned char)(ctr >> 8);
+  counter[15] = (unsigned char)ctr;
+}
+
+/* Fills h_table with the keys of H^1, ..., H^GHASH_BS_AGGREGATE, in order. */
+void aesbs_ghash_init(unsigned char *h_table, const unsigned char h[16]) {
+  struct aesbs_ghash_key keys[GHASH_BS_AGGREGATE];
+#if __STDC_VERSION__ >= 201112L
+  static_assert(sizeof keys <= AES_HTABLE_SIZE, "");
+#else
+  assert(sizeof keys <= AES_HTABLE_SIZE);
+#endif
+
+  keys[0] = aesbs_ghash_key_from(load_u64_be(h), load_u64_be(&h[8]));
+  for (size_t k = 1; k < GHASH_BS_AGGREGATE; ++k) {
+    /* H^(k+1) = (0 ^ H^k) * H */
+    unsigned char power[16];
+    uint64_t y[2] = {0, 0};
+    store_u64_be(power, keys[k - 1].h1);
+    store_u64_be(&power[8], keys[k - 1].h0);
+    aesbs_ghash_chunk(keys, y, 1, power);
+    keys[k] = aesbs_ghash_key_from(y[1], y[0]);
+  }
+
+  memcpy(h_table, keys, sizeof keys);
+}
+
+void aesbs_gcm_init(AesGcmContext *ctx) {
+  const unsigned char zero[16] = {0};
+  unsigned char h[16];
+  aesbs_ecb_encrypt(&ctx->aes, 16, h, zero);
+  aesbs_ghash_init(ctx->h_table, h);
+}
+
+static void aesbs_ghash_blocks(const struct aesbs_ghash_key *keys,
+                               uint64_t y[2], size_t nblocks,
+                               const unsigned char *in) {
+  while (nblocks) {
+    size_t n = nblocks < GHASH_BS_AGGREGATE ? nblocks : GHASH_BS_AGGREGATE;
+    aesbs_ghash_chunk(keys, y, n, in);
+    in += n * 16;
+    nblocks -= n;
+  }
+}
+
+void aesbs_ghash(const unsigned char *h_table, unsigned char xi[16],
+                 size_t textsize, const unsigned char *in) {
+  struct aesbs_ghash_key keys[GHASH_BS_AGGREGATE];
+  aesbs_ghash_load_keys(keys, h_table);
+
+  uint64_t y[2] = {load_u64_be(&xi[8]), load_u64_be(xi)};
+  aesbs_ghash_blocks(keys, y, textsize / 16, in);
+  store_u64_be(xi, y[1]);
+  store_u64_be(&xi[8], y[0]);
+}
+
+void aesbs_gcm_ghash(const AesGcmContext *ctx, unsigned char xi[16],
+                     size_t textsize, const unsigned char *in) {
+  aesbs_ghash(ctx->h_table, xi, textsize, in);
+}
+
+/*
+ * CTR with the 32-bit counter of GCM, in chunks of GHASH_BS_AGGREGATE blocks:
+ * the key stream of a chunk is generated by the bitsliced cipher, and the
+ * cipher text of the chunk is hashed with a single reduction.
+ */
+static void aesbs_gcm_ctr32_xcrypt(const AesGcmContext *ctx, size_t textsize,
+                                   unsigned char *out, const unsigned char *in,
+                                   unsigned char counter[16],
+                                   unsigned char xi[16], bool encrypt) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->aes.key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->aes.enc_round_keys, sizeof round_keys);
+
+  struct aesbs_ghash_key keys[GHASH_BS_AGGREGATE];
+  aesbs_ghash_load_keys(keys, ctx->h_table);
+  uint64_t y[2] = {load_u64_be(&xi[8]), load_u64_be(xi)};
+
+  unsigned char chunk[GHASH_BS_AGGREGATE * 16];
+  for (size_t i = 0; i < textsize; i += sizeof chunk) {
+    size_t size = textsize - i < sizeof chunk ? textsize - i : sizeof chunk;
+    size_t nblocks = (size + 15) / 16;
+
+    /* The partial block at the end is hashed zero-padded. */
+    memset(chunk, 0, sizeof chunk);
+    memcpy(chunk, &in[i], size);
+
+    if (!encrypt)
+      aesbs_ghash_chunk(keys, y, nblocks, chunk);
+
+    for (size_t j = 0; j < nblocks; ++j) {
+      struct AesBsState stream_block =
+          aesbs_enc_block(Nr, round_keys, store_bytes_to_bitslice(counter));
+      aesbs_increment_ctr32(counter);
+
+      unsigned char stream_bytes[16];
+      save_bitslice_to_bytes(stream_bytes, stream_block);
+      for (size_t k = 0; k < 16; ++k)
+        chunk[j * 16 + k] ^= stream_bytes[k];
+    }
+    memset(&chunk[size], 0, nblocks * 16 - size);
+    memcpy(&out[i], chunk, size);
+
+    if (encrypt)
+      aesbs_ghash_chunk(keys, y, nblocks, chunk);
+  }
+
+  store_u64_be(xi, y[1]);
+  store_u64_be(&xi[8], y[0]);
+}
+
+void aesbs_gcm_ctr32_encrypt(const AesGcmContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char counter[16], unsigned char xi[16]) {
+  aesbs_gcm_ctr32_xcrypt(ctx, textsize, out, in, counter, xi, true);
+}
+
+void aesbs_gcm_ctr32_decrypt(const AesGcmContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char counter[16], unsigned char xi[16]) {
+  aesbs_gcm_ctr32_xcrypt(ctx, textsize, out, in, counter, xi, false);
+}
+
+/*
+ * AES-GCM-SIV
+ */
+
+static void aesbs_byte_reverse(unsigned char dest[16],
+                               const unsigned char src[16]) {
+  for (size_t i = 0; i < 16; ++i)
+    dest[i] = src[15 - i];
+}
+
+void aesbs_gcm_siv_derive_keys(AesContext *ctx, const unsigned char nonce[12],
+                               unsigned char auth_key[16],
+                               unsigned char enc_key[32]) {
+  size_t nblocks = ctx->key_size == KEY_TYPE_AES256 ? 6 : 4;
+  unsigned char blocks[6 * 16] = {0};
+
+  for (size_t i = 0; i < nblocks; ++i) {
+    blocks[i * 16] = (unsigned char)i;
+    memcpy(&blocks[i * 16 + 4], nonce, 12);
+  }
+  aesbs_ecb_encrypt(ctx, nblocks * 16, blocks, blocks);
+
+  /* The first 8 bytes of each encrypted block form the keys. */
+  memcpy(auth_key, blocks, 8);
+  memcpy(&auth_key[8], &blocks[16], 8);
+  for (size_t i = 2; i < nblocks; ++i)
+    memcpy(&enc_key[(i - 2) * 8], &blocks[i * 16], 8);
+}
+
+/*
+ * POLYVAL through GHASH (RFC 8452, Appendix A):
+ *
+ *   POLYVAL(H, X_1, ..., X_n) = ByteReverse(GHASH(mulX_GHASH(ByteReverse(H)),
+ *                                           ByteReverse(X_1), ...,
+ *                                           ByteReverse(X_n)))
+ */
+void aesbs_polyval_init(unsigned char *h_table, const unsigned char h[16]) {
+  unsigned char ghash_h[16];
+  aesbs_byte_reverse(ghash_h, h);
+
+  /* mulX_GHASH: shift right by one bit in GHASH order & reduce. */
+  uint64_t h_hi = load_u64_be(ghash_h), h_lo = load_u64_be(&ghash_h[8]);
+  uint64_t lsb_mask = (uint64_t)0 - (h_lo & 1);
+  h_lo = (h_lo >> 1) | (h_hi << 63);
+  h_hi = (h_hi >> 1) ^ (UINT64_C(0xe100000000000000) & lsb_mask);
+  store_u64_be(ghash_h, h_hi);
+  store_u64_be(&ghash_h[8], h_lo);
+
+  aesbs_ghash_init(h_table, ghash_h);
+}
+
+void aesbs_polyval(const unsigned char *h_table, unsigned char s[16],
+                   size_t textsize, const unsigned char *in) {
+  struct aesbs_ghash_key keys[GHASH_BS_AGGREGATE];
+  aesbs_ghash_load_keys(keys, h_table);
+
+  unsigned char block[16];
+  aesbs_byte_reverse(block, s);
+  uint64_t y[2] = {load_u64_be(&block[8]), load_u64_be(block)};
+
+  unsigned char chunk[GHASH_BS_AGGREGATE * 16];
+  size_t nblocks = textsize / 16;
+  while (nblocks) {
+    size_t n = nblocks < GHASH_BS_AGGREGATE ? nblocks : GHASH_BS_AGGREGATE;
+    for (size_t j = 0; j < n; ++j)
+      aesbs_byte_reverse(&chunk[j * 16], &in[j * 16]);
+
+    aesbs_ghash_chunk(keys, y, n, chunk);
+    in += n * 16;
+    nblocks -= n;
+  }
+
+  store_u64_be(block, y[1]);
+  store_u64_be(&block[8], y[0]);
+  aesbs_byte_reverse(s, block);
+}
+
+void aesbs_gcm_siv_ctr32le_xcrypt(AesContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  const unsigned char counter[16]) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
   struct AesBsState round_keys[15];
   memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
-  size_t i = 0;
 
-  for (; i < textsize / 16; ++i) {
-    struct AesBsState stream_block =
-        aesbs_enc_block(Nr, round_keys, iv_bitslice);
-    struct AesBsState in_block = store_bytes_to_bitslice(&in[i * 16]);
-    struct AesBsState out_block = aes__xor_state(stream_block, in_block);
+  unsigned char counter_block[16];
+  memcpy(counter_block, counter, 16);
+  uint32_t ctr = (uint32_t)counter[0] | ((uint32_t)counter[1] << 8) |
+                 ((uint32_t)counter[2] << 16) | ((uint32_t)counter[3] << 24);
+
+  for (size_t i = 0; i < textsize; i += 16) {
+    size_t size = textsize - i < 16 ? textsize - i : 16;
+
+    struct AesBsState stream_block = aesbs_enc_block(
+        Nr, round_keys, store_bytes_to_bitslice(counter_block));
+    unsigned char stream_bytes[16];
+    save_bitslice_to_bytes(stream_bytes, stream_block);
+    for (size_t j = 0; j < size; ++j)
+      out[i + j] = in[i + j] ^ stream_bytes[j];
+
+    ++ctr;
+    for (size_t j = 0; j < 4; ++j)
+      counter_block[j] = (unsigned char)(ctr >> (8 * j));
+  }
+}
+
+static void aesbs_xts_crypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            unsigned char tweak[16], bool encrypt) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    struct AesBsState t = store_bytes_to_bitslice(tweak);
+    struct AesBsState block =
+        aes__xor_state(store_bytes_to_bitslice(&in[i * 16]), t);
+    block = encrypt ? aesbs_enc_block(Nr, round_keys, block)
+                    : aesbs_dec_block(Nr, round_keys, block);
+    save_bitslice_to_bytes(&out[i * 16], aes__xor_state(block, t));
+
+    aes_xts_mul_alpha(tweak);
+  }
+}
+
+void aesbs_xts_encrypt_blocks(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              unsigned char tweak[16]) {
+  aesbs_xts_crypt(ctx, textsize, out, in, tweak, true);
+}
 
-    iv_bitslice = aesbs_increment_bitslice(iv_bitslice);
+void aesbs_xts_decrypt_blocks(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              unsigned char tweak[16]) {
+  aesbs_xts_crypt(ctx, textsize, out, in, tweak, false);
+}
+
+static void aesbs_xor_block(unsigned char dest[16], const unsigned char a[16],
+                            const unsigned char b[16]) {
+  for (size_t i = 0; i < 16; ++i)
+    dest[i] = a[i] ^ b[i];
+}
 
-    save_bitslice_to_bytes(&out[i * 16], out_block);
+static void aesbs_ocb_crypt(const AesOcbContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            uint64_t block_index, unsigned char offset[16],
+                            unsigned char checksum[16], bool encrypt) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->aes.key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->aes.enc_round_keys, sizeof round_keys);
+
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    size_t l_index = 2 + aes_ntz64(block_index + i);
+    aesbs_xor_block(offset, offset, &ctx->l_table[l_index * 16]);
+
+    unsigned char block[16];
+    aesbs_xor_block(block, &in[i * 16], offset);
+    struct AesBsState state = store_bytes_to_bitslice(block);
+    state = encrypt ? aesbs_enc_block(Nr, round_keys, state)
+                    : aesbs_dec_block(Nr, round_keys, state);
+    save_bitslice_to_bytes(block, state);
+
+    if (encrypt)
+      aesbs_xor_block(checksum, checksum, &in[i * 16]);
+    aesbs_xor_block(&out[i * 16], block, offset);
+    if (!encrypt)
+      aesbs_xor_block(checksum, checksum, &out[i * 16]);
   }
+}
+
+void aesbs_ocb_encrypt_blocks(const AesOcbContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t block_index, unsigned char offset[16],
+                              unsigned char checksum[16]) {
+  aesbs_ocb_crypt(ctx, textsize, out, in, block_index, offset, checksum, true);
+}
+
+void aesbs_ocb_decrypt_blocks(const AesOcbContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t block_index, unsigned char offset[16],
+                              unsigned char checksum[16]) {
+  aesbs_ocb_crypt(ctx, textsize, out, in, block_index, offset, checksum,
+                  false);
+}
+
+void aesbs_ocb_hash_blocks(const AesOcbContext *ctx, size_t textsize,
+                           const unsigned char *in, uint64_t block_index,
+                           unsigned char offset[16], unsigned char sum[16]) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->aes.key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->aes.enc_round_keys, sizeof round_keys);
+
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    size_t l_index = 2 + aes_ntz64(block_index + i);
+    aesbs_xor_block(offset, offset, &ctx->l_table[l_index * 16]);
+
+    unsigned char block[16];
+    aesbs_xor_block(block, &in[i * 16], offset);
+    struct AesBsState state =
+        aesbs_enc_block(Nr, round_keys, store_bytes_to_bitslice(block));
+    save_bitslice_to_bytes(block, state);
+    aesbs_xor_block(sum, sum, block);
+  }
+}
+
+static void aesbs_ccm_increment_ctr64(unsigned char counter[16]) {
+  store_u64_be(&counter[8], load_u64_be(&counter[8]) + 1);
+}
+
+void aesbs_ccm_cbc_mac_lanes(const AesContext *ctx, size_t nlanes,
+                             size_t nblocks, const unsigned char *const *in,
+                             unsigned char *macs) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  for (size_t j = 0; j < nlanes; ++j) {
+    struct AesBsState chain = store_bytes_to_bitslice(&macs[j * 16]);
+    for (size_t i = 0; i < nblocks; ++i) {
+      chain = aes__xor_state(chain, store_bytes_to_bitslice(&in[j][i * 16]));
+      chain = aesbs_enc_block(Nr, round_keys, chain);
+    }
+    save_bitslice_to_bytes(&macs[j * 16], chain);
+  }
+}
+
+static void aesbs_ccm_crypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            const unsigned char counter[16],
+                            unsigned char mac[16], bool encrypt) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  unsigned char counter_block[16];
+  memcpy(counter_block, counter, 16);
+  struct AesBsState chain = store_bytes_to_bitslice(mac);
+
+  for (size_t i = 0; i < textsize; i += 16) {
+    size_t size = textsize - i < 16 ? textsize - i : 16;
+    unsigned char stream_bytes[16], plain_block[16] = {0};
+
+    struct AesBsState stream_block = aesbs_enc_block(
+        Nr, round_keys, store_bytes_to_bitslice(counter_block));
+    save_bitslice_to_bytes(stream_bytes, stream_block);
+    aesbs_ccm_increment_ctr64(counter_block);
+
+    for (size_t j = 0; j < size; ++j) {
+      unsigned char in_byte = in[i + j];
+      out[i + j] = in_byte ^ stream_bytes[j];
+      plain_block[j] = encrypt ? in_byte : out[i + j];
+    }
+
+    chain = aes__xor_state(chain, store_bytes_to_bitslice(plain_block));
+    chain = aesbs_enc_block(Nr, round_keys, chain);
+  }
+
+  save_bitslice_to_bytes(mac, chain);
+}
+
+void aesbs_ccm_encrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  aesbs_ccm_crypt(ctx, textsize, out, in, counter, mac, true);
+}
+
+void aesbs_ccm_decrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  aesbs_ccm_crypt(ctx, textsize, out, in, counter, mac, false);
+}
+
+void aesbs_ccm_ctr64_xcrypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            const unsigned char counter[16]) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  unsigned char counter_block[16];
+  memcpy(counter_block, counter, 16);
+
+  for (size_t i = 0; i < textsize; i += 16) {
+    size_t size = textsize - i < 16 ? textsize - i : 16;
+    unsigned char stream_bytes[16];
+
+    struct AesBsState stream_block = aesbs_enc_block(
+        Nr, round_keys, store_bytes_to_bitslice(counter_block));
+    save_bitslice_to_bytes(stream_bytes, stream_block);
+    aesbs_ccm_increment_ctr64(counter_block);
+
+    for (size_t j = 0; j < size; ++j)
+      out[i + j] = in[i + j] ^ stream_bytes[j];
+  }
+}
+
+/* EAX: CTR with a 128-bit counter, together with the OMAC chain of every
+ * block of cipher text but the last one. */
+static void aesbs_eax_crypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            const unsigned char counter[16],
+                            unsigned char mac[16], bool encrypt) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  unsigned char counter_block[16];
+  memcpy(counter_block, counter, 16);
+  struct AesBsState chain = store_bytes_to_bitslice(mac);
+
+  for (size_t i = 0; i < textsize; i += 16) {
+    size_t size = textsize - i < 16 ? textsize - i : 16;
+    unsigned char stream_bytes[16], cipher_block[16];
+
+    struct AesBsState stream_block = aesbs_enc_block(
+        Nr, round_keys, store_bytes_to_bitslice(counter_block));
+    save_bitslice_to_bytes(stream_bytes, stream_block);
+    aesbs_increment_ctr(counter_block, AES_CTR_WIDTH_128);
+
+    for (size_t j = 0; j < size; ++j) {
+      unsigned char in_byte = in[i + j];
+      out[i + j] = in_byte ^ stream_bytes[j];
+      cipher_block[j] = encrypt ? out[i + j] : in_byte;
+    }
+
+    if (i + 16 < textsize) {
+      chain = aes__xor_state(chain, store_bytes_to_bitslice(cipher_block));
+      chain = aesbs_enc_block(Nr, round_keys, chain);
+    }
+  }
+
+  save_bitslice_to_bytes(mac, chain);
+}
+
+void aesbs_eax_encrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  aesbs_eax_crypt(ctx, textsize, out, in, counter, mac, true);
+}
+
+void aesbs_eax_decrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  aesbs_eax_crypt(ctx, textsize, out, in, counter, mac, false);
+}
+
+/* CFB with `segment_size`-byte segments: 16 for CFB128, 1 for CFB8. */
+static void aesbs_cfb_crypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            unsigned char iv[16], size_t segment_size,
+                            bool encrypt) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  for (size_t i = 0; i + segment_size <= textsize; i += segment_size) {
+    unsigned char stream_bytes[16], cipher_bytes[16];
 
-  if (textsize % 16) {
     struct AesBsState stream_block =
-        aesbs_enc_block(Nr, round_keys, iv_bitslice);
-    struct AesBsState in_block;
-    memset(&in_block, 0, sizeof in_block);
-    for (size_t j = 0; j < textsize % 16; ++j) {
-      store_byte_to_bitslice(&in_block, in[i * 16 + j], j % 4, j / 4);
+        aesbs_enc_block(Nr, round_keys, store_bytes_to_bitslice(iv));
+    save_bitslice_to_bytes(stream_bytes, stream_block);
+
+    /* Read the cipher text before it can be overwritten when out == in. */
+    if (!encrypt)
+      memcpy(cipher_bytes, &in[i], segment_size);
+    for (size_t j = 0; j < segment_size; ++j)
+      out[i + j] = in[i + j] ^ stream_bytes[j];
+    if (encrypt)
+      memcpy(cipher_bytes, &out[i], segment_size);
+
+    memmove(iv, &iv[segment_size], 16 - segment_size);
+    memcpy(&iv[16 - segment_size], cipher_bytes, segment_size);
+  }
+}
+
+void aesbs_cfb128_encrypt(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char iv[16]) {
+  aesbs_cfb_crypt(ctx, textsize, out, in, iv, 16, true);
+}
+
+void aesbs_cfb128_decrypt(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char iv[16]) {
+  aesbs_cfb_crypt(ctx, textsize, out, in, iv, 16, false);
+}
+
+void aesbs_cfb8_encrypt(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char iv[16]) {
+  aesbs_cfb_crypt(ctx, textsize, out, in, iv, 1, true);
+}
+
+void aesbs_cfb8_decrypt(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char iv[16]) {
+  aesbs_cfb_crypt(ctx, textsize, out, in, iv, 1, false);
+}
+
+void aesbs_ofb_keystream(const AesContext *ctx, size_t size,
+                         unsigned char *out, unsigned char iv[16]) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  struct AesBsState block = store_bytes_to_bitslice(iv);
+  for (size_t i = 0; i < size / 16; ++i) {
+    block = aesbs_enc_block(Nr, round_keys, block);
+    save_bitslice_to_bytes(&out[i * 16], block);
+  }
+
+  save_bitslice_to_bytes(iv, block);
+}
+
+void aesbs_ofb_xcrypt(const AesContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char iv[16]) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  struct AesBsState block = store_bytes_to_bitslice(iv);
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    unsigned char stream_bytes[16];
+    block = aesbs_enc_block(Nr, round_keys, block);
+    save_bitslice_to_bytes(stream_bytes, block);
+    aesbs_xor_block(&out[i * 16], &in[i * 16], stream_bytes);
+  }
+
+  save_bitslice_to_bytes(iv, block);
+}
+
+static void aesbs_kw_lanes(const AesContext *ctx, size_t nlanes,
+                           struct aes_kw_lane *lanes, size_t nsteps,
+                           bool wrap) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  for (size_t step = 0; step < nsteps; ++step) {
+    for (size_t j = 0; j < nlanes; ++j) {
+      struct aes_kw_lane *lane = &lanes[j];
+      unsigned char *r = &lane->r[lane->i * 8];
+      unsigned char block[16];
+
+      memcpy(block, lane->a, 8);
+      memcpy(&block[8], r, 8);
+      if (!wrap)
+        store_u64_be(block, load_u64_be(block) ^ lane->t);
+
+      struct AesBsState state = store_bytes_to_bitslice(block);
+      state = wrap ? aesbs_enc_block(Nr, round_keys, state)
+                   : aesbs_dec_block(Nr, round_keys, state);
+      save_bitslice_to_bytes(block, state);
+
+      memcpy(r, &block[8], 8);
+      if (wrap) {
+        store_u64_be(lane->a, load_u64_be(block) ^ lane->t++);
+        lane->i = lane->i + 1 == lane->n ? 0 : lane->i + 1;
+      } else {
+        memcpy(lane->a, block, 8);
+        --lane->t;
+        lane->i = lane->i == 0 ? lane->n - 1 : lane->i - 1;
+      }
+    }
+  }
+}
+
+void aesbs_kw_wrap_lanes(const AesContext *ctx, size_t nlanes,
+                         struct aes_kw_lane *lanes, size_t nsteps) {
+  aesbs_kw_lanes(ctx, nlanes, lanes, nsteps, true);
+}
+
+void aesbs_kw_unwrap_lanes(const AesContext *ctx, size_t nlanes,
+                           struct aes_kw_lane *lanes, size_t nsteps) {
+  aesbs_kw_lanes(ctx, nlanes, lanes, nsteps, false);
+}
+
+static void aesbs_fixed_key_hash(const AesContext *ctx, size_t textsize,
+                                 unsigned char *out, const unsigned char *in,
+                                 uint64_t tweak, enum aes_fixed_key_hash hash) {
+  enum AesBsNr Nr = aesbs_key_size_to_nr(ctx->key_size);
+  struct AesBsState round_keys[15];
+  memcpy(round_keys, ctx->enc_round_keys, sizeof round_keys);
+
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    unsigned char block[16];
+    memcpy(block, &in[i * 16], 16);
+
+    if (hash == AES_FIXED_KEY_CCR) {
+      /* sigma(L || R) = (L ^ R) || L */
+      for (size_t j = 0; j < 8; ++j) {
+        unsigned char l = block[j];
+        block[j] ^= block[j + 8];
+        block[j + 8] = l;
+      }
+    }
+
+    struct AesBsState x = store_bytes_to_bitslice(block);
+    struct AesBsState y = aesbs_enc_block(Nr, round_keys, x);
+
+    if (hash == AES_FIXED_KEY_TCCR) {
+      unsigned char tweak_block[16] = {0};
+      for (size_t j = 0; j < 8; ++j)
+        tweak_block[j] = (unsigned char)((tweak + i) >> (8 * j));
+
+      x = y;
+      y = aesbs_enc_block(
+          Nr, round_keys,
+          aes__xor_state(y, store_bytes_to_bitslice(tweak_block)));
+    }
+
+    save_bitslice_to_bytes(&out[i * 16], aes__xor_state(y, x));
+  }
+}
+
+void aesbs_fixed_key_cr(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in) {
+  aesbs_fixed_key_hash(ctx, textsize, out, in, 0, AES_FIXED_KEY_CR);
+}
+
+void aesbs_fixed_key_ccr(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in) {
+  aesbs_fixed_key_hash(ctx, textsize, out, in, 0, AES_FIXED_KEY_CCR);
+}
+
+void aesbs_fixed_key_tccr(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          uint64_t tweak) {
+  aesbs_fixed_key_hash(ctx, textsize, out, in, tweak, AES_FIXED_KEY_TCCR);
+}
+
+static struct AesBsState aes__and_state(struct AesBsState lhs,
+                                        struct AesBsState rhs) {
+  struct AesBsState result;
+  for (size_t i = 0; i < CHAR_BIT; ++i) {
+    result.slice[i] = lhs.slice[i] & rhs.slice[i];
+  }
+  return result;
+}
+
+/* AESENC: one full round of state keyed by round_key. */
+static struct AesBsState aesbs_aes_round(struct AesBsState state,
+                                         struct AesBsState round_key) {
+  aesbs_SubBytes(&state, &state);
+  state = aesbs_ShiftRows(state);
+  state = aesbs_MixColumns(state);
+  return aesbs_AddRoundKey(state, round_key);
+}
+
+/*
+ * AEGIS-128L (8 state blocks, absorbing 2 blocks per update into S[0] & S[4])
+ * & AEGIS-256 (6 state blocks, absorbing 1 block into S[0]). The state stays
+ * bitsliced: the key stream only uses XOR & AND, which commute with the
+ * bitslicing, so only the message & the key stream are converted.
+ */
+static void aesbs_aegis_update(struct AesBsState *s, size_t nblocks,
+                               const struct AesBsState m[2]) {
+  struct AesBsState last = s[nblocks - 1];
+  for (size_t i = nblocks - 1; i > 0; --i) {
+    struct AesBsState round_key =
+        nblocks == 8 && i == 4 ? aes__xor_state(s[i], m[1]) : s[i];
+    s[i] = aesbs_aes_round(s[i - 1], round_key);
+  }
+  s[0] = aesbs_aes_round(last, aes__xor_state(s[0], m[0]));
+}
+
+/* Absorbs `size` bytes (at most the rate), zero-padded. */
+static void aesbs_aegis_absorb(struct AesBsState *s, size_t nblocks,
+                               size_t size, const unsigned char *in) {
+  unsigned char pad[32] = {0};
+  memcpy(pad, in, size);
+
+  struct AesBsState m[2] = {store_bytes_to_bitslice(pad),
+                            store_bytes_to_bitslice(&pad[16])};
+  aesbs_aegis_update(s, nblocks, m);
+}
+
+static void aesbs_aegis_keystream(const struct AesBsState *s, size_t nblocks,
+                                  unsigned char z[32]) {
+  if (nblocks == 8) {
+    save_bitslice_to_bytes(z, aes__xor_state(aes__xor_state(s[6], s[1]),
+                                             aes__and_state(s[2], s[3])));
+    save_bitslice_to_bytes(&z[16], aes__xor_state(aes__xor_state(s[2], s[5]),
+                                                  aes__and_state(s[6], s[7])));
+  } else {
+    save_bitslice_to_bytes(
+        z, aes__xor_state(aes__xor_state(s[1], s[4]),
+                          aes__xor_state(s[5], aes__and_state(s[2], s[3]))));
+  }
+}
+
+static void aesbs_aegis_init(struct AesBsState *s, size_t nblocks,
+                             const unsigned char *key,
+                             const unsigned char *nonce) {
+  static const unsigned char c0_bytes[16] = {
+      0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x08, 0x0d,
+      0x15, 0x22, 0x37, 0x59, 0x90, 0xe9, 0x79, 0x62};
+  static const unsigned char c1_bytes[16] = {
+      0xdb, 0x3d, 0x18, 0x55, 0x6d, 0xc2, 0x2f, 0xf1,
+      0x20, 0x11, 0x31, 0x42, 0x73, 0xb5, 0x28, 0xdd};
+  struct AesBsState c0 = store_bytes_to_bitslice(c0_bytes);
+  struct AesBsState c1 = store_bytes_to_bitslice(c1_bytes);
+  struct AesBsState k0 = store_bytes_to_bitslice(key);
+
+  if (nblocks == 8) {
+    struct AesBsState m[2] = {store_bytes_to_bitslice(nonce), k0};
+    s[0] = s[4] = aes__xor_state(k0, m[0]);
+    s[1] = s[3] = c1;
+    s[2] = c0;
+    s[5] = s[7] = aes__xor_state(k0, c0);
+    s[6] = aes__xor_state(k0, c1);
+    for (size_t i = 0; i < 10; ++i)
+      aesbs_aegis_update(s, nblocks, m);
+  } else {
+    struct AesBsState k1 = store_bytes_to_bitslice(&key[16]);
+    struct AesBsState m[4][2] = {
+        {k0},
+        {k1},
+        {aes__xor_state(k0, store_bytes_to_bitslice(nonce))},
+        {aes__xor_state(k1, store_bytes_to_bitslice(&nonce[16]))}};
+    s[0] = m[2][0];
+    s[1] = m[3][0];
+    s[2] = c1;
+    s[3] = c0;
+    s[4] = aes__xor_state(k0, c0);
+    s[5] = aes__xor_state(k1, c1);
+    for (size_t i = 0; i < 16; ++i)
+      aesbs_aegis_update(s, nblocks, m[i % 4]);
+  }
+}
+
+static void aesbs_aegis_final(struct AesBsState *s, size_t nblocks,
+                              size_t aadsize, size_t textsize, size_t tagsize,
+                              unsigned char *tag) {
+  unsigned char lengths[16];
+  for (size_t i = 0; i < 8; ++i) {
+    lengths[i] = (unsigned char)((uint64_t)aadsize * 8 >> (8 * i));
+    lengths[8 + i] = (unsigned char)((uint64_t)textsize * 8 >> (8 * i));
+  }
+
+  struct AesBsState t = aes__xor_state(s[nblocks == 8 ? 2 : 3],
+                                       store_bytes_to_bitslice(lengths));
+  struct AesBsState m[2] = {t, t};
+  for (size_t i = 0; i < 7; ++i)
+    aesbs_aegis_update(s, nblocks, m);
+
+  /* A 128-bit tag leaves S[7] of AEGIS-128L out; a 256-bit tag is the XOR
+   * of each half of the state. */
+  if (tagsize == 32) {
+    struct AesBsState halves[2] = {s[0], s[nblocks / 2]};
+    for (size_t i = 1; i < nblocks / 2; ++i) {
+      halves[0] = aes__xor_state(halves[0], s[i]);
+      halves[1] = aes__xor_state(halves[1], s[nblocks / 2 + i]);
     }
+    save_bitslice_to_bytes(tag, halves[0]);
+    save_bitslice_to_bytes(&tag[16], halves[1]);
+  } else {
+    struct AesBsState sum = s[0];
+    for (size_t i = 1; i < (nblocks == 8 ? 7 : nblocks); ++i)
+      sum = aes__xor_state(sum, s[i]);
+    save_bitslice_to_bytes(tag, sum);
+  }
+}
 
-    struct AesBsState out_block = aes__xor_state(stream_block, in_block);
+static void aesbs_aegis_crypt(size_t nblocks, const unsigned char *key,
+                              const unsigned char *nonce, size_t aadsize,
+                              const unsigned char *aad, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              size_t tagsize, unsigned char *tag,
+                              bool encrypt) {
+  struct AesBsState s[8];
+  size_t rate = nblocks == 8 ? 32 : 16;
+
+  aesbs_aegis_init(s, nblocks, key, nonce);
+  for (size_t i = 0; i < aadsize; i += rate) {
+    size_t size = aadsize - i < rate ? aadsize - i : rate;
+    aesbs_aegis_absorb(s, nblocks, size, &aad[i]);
+  }
 
-    unsigned char out_bytes[16];
-    save_bitslice_to_bytes(out_bytes, out_block);
-    memcpy(&out[i * 16], out_bytes, textsize % 16);
+  for (size_t i = 0; i < textsize; i += rate) {
+    size_t size = textsize - i < rate ? textsize - i : rate;
+    unsigned char z[32], block[32];
+
+    aesbs_aegis_keystream(s, nblocks, z);
+    for (size_t j = 0; j < size; ++j)
+      block[j] = in[i + j] ^ z[j];
+
+    /* The plain text is absorbed; `in` is read before `out` is written. */
+    aesbs_aegis_absorb(s, nblocks, size, encrypt ? &in[i] : block);
+    memcpy(&out[i], block, size);
   }
 
-  save_bitslice_to_bytes(next_iv, iv_bitslice);
+  aesbs_aegis_final(s, nblocks, aadsize, textsize, tagsize, tag);
+}
+
+void aesbs_aegis128l_encrypt(const unsigned char key[16],
+                             const unsigned char nonce[16], size_t aadsize,
+                             const unsigned char *aad, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             size_t tagsize, unsigned char *tag) {
+  aesbs_aegis_crypt(8, key, nonce, aadsize, aad, textsize, out, in, tagsize,
+                    tag, true);
+}
+
+void aesbs_aegis128l_decrypt(const unsigned char key[16],
+                             const unsigned char nonce[16], size_t aadsize,
+                             const unsigned char *aad, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             size_t tagsize, unsigned char *tag) {
+  aesbs_aegis_crypt(8, key, nonce, aadsize, aad, textsize, out, in, tagsize,
+                    tag, false);
+}
+
+void aesbs_aegis256_encrypt(const unsigned char key[32],
+                            const unsigned char nonce[32], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag) {
+  aesbs_aegis_crypt(6, key, nonce, aadsize, aad, textsize, out, in, tagsize,
+                    tag, true);
+}
+
+void aesbs_aegis256_decrypt(const unsigned char key[32],
+                            const unsigned char nonce[32], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag) {
+  aesbs_aegis_crypt(6, key, nonce, aadsize, aad, textsize, out, in, tagsize,
+                    tag, false);
+}
+
+/*
+ * Keyed Haraka v2 on `nwords` (2 or 4) state blocks. The two AES rounds of a
+ * step run bitsliced; the MIX only moves whole 32-bit words, so it is applied
+ * to the bytes in between.
+ */
+static void aesbs_haraka_unpack(uint32_t out[4], const uint32_t a[4],
+                                const uint32_t b[4], size_t half) {
+  uint32_t result[4] = {a[2 * half], b[2 * half], a[2 * half + 1],
+                        b[2 * half + 1]};
+  memcpy(out, result, sizeof result);
+}
+
+static void aesbs_haraka_mix(size_t nwords, uint32_t s[4][4]) {
+  uint32_t tmp[4];
+
+  if (nwords == 2) {
+    aesbs_haraka_unpack(tmp, s[0], s[1], 0);
+    aesbs_haraka_unpack(s[1], s[0], s[1], 1);
+    memcpy(s[0], tmp, sizeof tmp);
+    return;
+  }
+
+  aesbs_haraka_unpack(tmp, s[0], s[1], 0);
+  aesbs_haraka_unpack(s[0], s[0], s[1], 1);
+  aesbs_haraka_unpack(s[1], s[2], s[3], 0);
+  aesbs_haraka_unpack(s[2], s[2], s[3], 1);
+  aesbs_haraka_unpack(s[3], s[0], s[2], 0);
+  aesbs_haraka_unpack(s[0], s[0], s[2], 1);
+  aesbs_haraka_unpack(s[2], s[1], tmp, 1);
+  aesbs_haraka_unpack(s[1], s[1], tmp, 0);
+}
+
+/* Permutes the nwords * 16 bytes of block, then XORs the input back in. */
+static void aesbs_haraka_permute(const unsigned char *rc, size_t nwords,
+                                 unsigned char block[64]) {
+  uint32_t s[4][4];
+  memcpy(s, block, nwords * 16);
+
+  for (size_t r = 0; r < 5; ++r) {
+    for (size_t b = 0; b < nwords; ++b) {
+      struct AesBsState x = store_bytes_to_bitslice((unsigned char *)s[b]);
+      for (size_t k = 0; k < 2; ++k)
+        x = aesbs_aes_round(x, store_bytes_to_bitslice(
+                                   &rc[((2 * r + k) * nwords + b) * 16]));
+      save_bitslice_to_bytes((unsigned char *)s[b], x);
+    }
+
+    aesbs_haraka_mix(nwords, s);
+  }
+
+  for (size_t i = 0; i < nwords * 16; ++i)
+    block[i] ^= ((unsigned char *)s)[i];
+}
+
+/* Haraka-512 of block, truncated to its bytes 8-15, 24-31, 32-39 & 48-55. */
+static void aesbs_haraka512_block(const unsigned char *rc,
+                                  unsigned char digest[32],
+                                  unsigned char block[64]) {
+  aesbs_haraka_permute(rc, 4, block);
+  memcpy(digest, &block[8], 8);
+  memcpy(&digest[8], &block[24], 8);
+  memcpy(&digest[16], &block[32], 8);
+  memcpy(&digest[24], &block[48], 8);
+}
+
+void aesbs_haraka256(const unsigned char *rc, size_t count,
+                     unsigned char *out, const unsigned char *in) {
+  for (size_t i = 0; i < count; ++i) {
+    unsigned char block[64];
+    memcpy(block, &in[i * 32], 32);
+    aesbs_haraka_permute(rc, 2, block);
+    memcpy(&out[i * 32], block, 32);
+  }
+}
+
+void aesbs_haraka512(const unsigned char *rc, size_t count,
+                     unsigned char *out, const unsigned char *in) {
+  for (size_t i = 0; i < count; ++i) {
+    unsigned char block[64];
+    memcpy(block, &in[i * 64], 64);
+    aesbs_haraka512_block(rc, &out[i * 32], block);
+  }
+}
+
+void aesbs_haraka_chain(const unsigned char *rc, size_t nlanes,
+                        unsigned char *h, size_t nblocks,
+                        const unsigned char *const *blocks) {
+  for (size_t j = 0; j < nlanes; ++j) {
+    for (size_t i = 0; i < nblocks; ++i) {
+      unsigned char block[64];
+      memcpy(block, &h[j * 32], 32);
+      memcpy(&block[32], &blocks[j][i * 32], 32);
+      aesbs_haraka512_block(rc, &h[j * 32], block);
+    }
+  }
 }
@@ -17,6 +17,13 @@ void aesbs_init(AesContext *ctx, enum AesKeyType key_size,
 void aesbs_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
                       const unsigned char *in, unsigned char next_iv[16],
                       const unsigned char iv[16]);
+void aesbs_ctr_width_xcrypt(AesContext *ctx, enum AesCtrWidth width,
+                            size_t textsize, unsigned char *out,
+                            const unsigned char *in, unsigned char next_iv[16],
+                            const unsigned char iv[16]);
+void aesbs_xctr_xcrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char iv[16]);
 
 /**
  * @brief Encrypt data in plain_text using AES ECB mode and store the
@@ -56,4 +63,151 @@ void aesbs_cbc_decrypt(AesContext *ctx, size_t textsize,
                        const unsigned char *cipher_text,
                        const unsigned char iv[16]);
 
+void aesbs_ghash_init(unsigned char *h_table, const unsigned char h[16]);
+
+void aesbs_ghash(const unsigned char *h_table, unsigned char xi[16],
+                 size_t textsize, const unsigned char *in);
+
+void aesbs_gcm_init(AesGcmContext *ctx);
+
+void aesbs_gcm_ghash(const AesGcmContext *ctx, unsigned char xi[16],
+                     size_t textsize, const unsigned char *in);
+
+void aesbs_gcm_ctr32_encrypt(const AesGcmContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char counter[16], unsigned char xi[16]);
+
+void aesbs_gcm_ctr32_decrypt(const AesGcmContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char counter[16], unsigned char xi[16]);
+
+void aesbs_gcm_siv_derive_keys(AesContext *ctx, const unsigned char nonce[12],
+                               unsigned char auth_key[16],
+                               unsigned char enc_key[32]);
+
+void aesbs_polyval_init(unsigned char *h_table, const unsigned char h[16]);
+
+void aesbs_polyval(const unsigned char *h_table, unsigned char s[16],
+                   size_t textsize, const unsigned char *in);
+
+void aesbs_gcm_siv_ctr32le_xcrypt(AesContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  const unsigned char counter[16]);
+
+void aesbs_aegis128l_encrypt(const unsigned char key[16],
+                             const unsigned char nonce[16], size_t aadsize,
+                             const unsigned char *aad, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             size_t tagsize, unsigned char *tag);
+void aesbs_aegis128l_decrypt(const unsigned char key[16],
+                             const unsigned char nonce[16], size_t aadsize,
+                             const unsigned char *aad, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             size_t tagsize, unsigned char *tag);
+void aesbs_aegis256_encrypt(const unsigned char key[32],
+                            const unsigned char nonce[32], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag);
+void aesbs_aegis256_decrypt(const unsigned char key[32],
+                            const unsigned char nonce[32], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag);
+
+void aesbs_xts_encrypt_blocks(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              unsigned char tweak[16]);
+
+void aesbs_xts_decrypt_blocks(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              unsigned char tweak[16]);
+
+void aesbs_ocb_encrypt_blocks(const AesOcbContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t block_index, unsigned char offset[16],
+                              unsigned char checksum[16]);
+
+void aesbs_ocb_decrypt_blocks(const AesOcbContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t block_index, unsigned char offset[16],
+                              unsigned char checksum[16]);
+
+void aesbs_ocb_hash_blocks(const AesOcbContext *ctx, size_t textsize,
+                           const unsigned char *in, uint64_t block_index,
+                           unsigned char offset[16], unsigned char sum[16]);
+
+void aesbs_ccm_cbc_mac_lanes(const AesContext *ctx, size_t nlanes,
+                             size_t nblocks, const unsigned char *const *in,
+                             unsigned char *macs);
+
+void aesbs_ccm_encrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]);
+
+void aesbs_ccm_decrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]);
+
+void aesbs_ccm_ctr64_xcrypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            const unsigned char counter[16]);
+
+void aesbs_eax_encrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]);
+
+void aesbs_eax_decrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]);
+
+void aesbs_cfb128_encrypt(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char iv[16]);
+
+void aesbs_cfb128_decrypt(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char iv[16]);
+
+void aesbs_cfb8_encrypt(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char iv[16]);
+
+void aesbs_cfb8_decrypt(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char iv[16]);
+
+void aesbs_ofb_keystream(const AesContext *ctx, size_t size,
+                         unsigned char *out, unsigned char iv[16]);
+
+void aesbs_ofb_xcrypt(const AesContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char iv[16]);
+
+struct aes_kw_lane;
+
+void aesbs_kw_wrap_lanes(const AesContext *ctx, size_t nlanes,
+                         struct aes_kw_lane *lanes, size_t nsteps);
+
+void aesbs_kw_unwrap_lanes(const AesContext *ctx, size_t nlanes,
+                           struct aes_kw_lane *lanes, size_t nsteps);
+
+void aesbs_fixed_key_cr(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in);
+
+void aesbs_fixed_key_ccr(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in);
+
+void aesbs_fixed_key_tccr(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          uint64_t tweak);
+
+void aesbs_haraka256(const unsigned char *rc, size_t count,
+                     unsigned char *out, const unsigned char *in);
+void aesbs_haraka512(const unsigned char *rc, size_t count,
+                     unsigned char *out, const unsigned char *in);
+void aesbs_haraka_chain(const unsigned char *rc, size_t nlanes,
+                        unsigned char *h, size_t nblocks,
+                        const unsigned char *const *blocks);
+
 #endif /* AY_AES_BS_H */
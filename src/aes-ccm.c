@@ -0,0 +1,392 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* Blocks of formatted associated data staged at a time. */
+#define CCM_STAGE_BLOCKS 8
+
+enum ccm_stream_state {
+  CCM_STREAM_HEADER,
+  CCM_STREAM_AAD,
+  CCM_STREAM_TEXT,
+  CCM_STREAM_TAIL,
+  CCM_STREAM_DONE
+};
+
+/*
+ * Produces the CBC-MAC input of a message (section A.2 of NIST SP 800-38C) as
+ * runs of full blocks: B0 & the associated data (with its length prepended &
+ * zero padding) are staged, full blocks of the text are read in place.
+ */
+struct ccm_mac_stream {
+  enum ccm_stream_state state;
+  const unsigned char *aad;
+  size_t aadsize;
+  const unsigned char *text;
+  size_t textsize;
+  unsigned char stage[CCM_STAGE_BLOCKS * 16];
+};
+
+/* Nonces of 7 to 13 bytes & tags of 4 to 16 bytes, in steps of 2 (section
+ * A.1 of NIST SP 800-38C); other sizes don't fit in B0. */
+static bool ccm_sizes_are_valid(size_t noncesize, size_t tagsize) {
+  return noncesize >= 7 && noncesize <= 13 && tagsize >= 4 && tagsize <= 16 &&
+         !(tagsize % 2);
+}
+
+/* The text size must fit in the q = 15 - noncesize bytes of B0: a longer text
+ * would also carry the counter into the nonce. The size of the associated
+ * data is encoded on up to 8 bytes, which holds any size_t. */
+static bool ccm_textsize_fits(size_t noncesize, size_t textsize) {
+  size_t q = 15 - noncesize;
+  return q >= 8 || !((uint64_t)textsize >> (8 * q));
+}
+
+static bool ccm_messages_fit(size_t nmessages, const AesCcmMessage *messages,
+                             size_t noncesize) {
+  for (size_t i = 0; i < nmessages; ++i) {
+    if (!ccm_textsize_fits(noncesize, messages[i].textsize))
+      return false;
+  }
+  return true;
+}
+
+/* B0 & the counter block Ctr_0 (sections A.2.1 & A.3 of NIST SP 800-38C). */
+static void ccm_format(unsigned char b0[16], unsigned char ctr0[16],
+                       size_t textsize, size_t aadsize, size_t noncesize,
+                       const unsigned char *nonce, size_t tagsize) {
+  size_t q = 15 - noncesize;
+
+  b0[0] = (unsigned char)((aadsize ? 0x40 : 0) | (((tagsize - 2) / 2) << 3) |
+                          (q - 1));
+  memcpy(&b0[1], nonce, noncesize);
+  for (size_t i = 0; i < q; ++i)
+    b0[15 - i] = (unsigned char)((uint64_t)textsize >> (8 * i));
+
+  memset(ctr0, 0, 16);
+  ctr0[0] = (unsigned char)(q - 1);
+  memcpy(&ctr0[1], nonce, noncesize);
+}
+
+static void ccm_stream_init(struct ccm_mac_stream *stream,
+                            const unsigned char b0[16], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            const unsigned char *text) {
+  stream->state = CCM_STREAM_HEADER;
+  stream->aad = aad;
+  stream->aadsize = aadsize;
+  stream->text = text;
+  stream->textsize = textsize;
+  memcpy(stream->stage, b0, 16);
+}
+
+/* Stages associated data from `pos` on, zero-padding its end. */
+static size_t ccm_stage_aad(struct ccm_mac_stream *stream, size_t pos) {
+  size_t size = sizeof stream->stage - pos;
+  if (size > stream->aadsize)
+    size = stream->aadsize;
+
+  memcpy(&stream->stage[pos], stream->aad, size);
+  stream->aad += size;
+  stream->aadsize -= size;
+  pos += size;
+
+  size_t end = (pos + 15) / 16 * 16;
+  memset(&stream->stage[pos], 0, end - pos);
+
+  stream->state = stream->aadsize ? CCM_STREAM_AAD : CCM_STREAM_TEXT;
+  return end / 16;
+}
+
+/* Points `blocks` at the next run of MAC input; returns its length in blocks,
+ * or 0 at the end of the message. */
+static size_t ccm_stream_next(struct ccm_mac_stream *stream,
+                              const unsigned char **blocks) {
+  size_t tail = stream->textsize % 16;
+  size_t pos = 16;
+
+  *blocks = stream->stage;
+  switch (stream->state) {
+  case CCM_STREAM_HEADER:
+    if (!stream->aadsize) {
+      stream->state = CCM_STREAM_TEXT;
+      return 1;
+    }
+
+    /* B0 is followed by the encoded size of the associated data. */
+    if (stream->aadsize < 0xff00) {
+      stream->stage[pos++] = (unsigned char)(stream->aadsize >> 8);
+      stream->stage[pos++] = (unsigned char)stream->aadsize;
+    } else {
+      size_t nbytes = (uint64_t)stream->aadsize >> 32 ? 8 : 4;
+      stream->stage[pos++] = 0xff;
+      stream->stage[pos++] = nbytes == 8 ? 0xff : 0xfe;
+      for (size_t i = nbytes; i > 0; --i)
+        stream->stage[pos++] =
+            (unsigned char)((uint64_t)stream->aadsize >> (8 * (i - 1)));
+    }
+    return ccm_stage_aad(stream, pos);
+
+  case CCM_STREAM_AAD:
+    return ccm_stage_aad(stream, 0);
+
+  case CCM_STREAM_TEXT:
+    stream->state = CCM_STREAM_TAIL;
+    if (stream->textsize >= 16) {
+      *blocks = stream->text;
+      return stream->textsize / 16;
+    }
+    /* fall through */
+
+  case CCM_STREAM_TAIL:
+    stream->state = CCM_STREAM_DONE;
+    if (tail) {
+      memset(stream->stage, 0, 16);
+      memcpy(stream->stage, &stream->text[stream->textsize - tail], tail);
+      return 1;
+    }
+    /* fall through */
+
+  case CCM_STREAM_DONE:
+  default:
+    return 0;
+  }
+}
+
+/* Masks the CBC-MAC with E(K, Ctr_0); the first tagsize bytes form the tag. */
+static void ccm_final(AesCcmContext *ctx, const unsigned char ctr0[16],
+                      unsigned char mac[16]) {
+  unsigned char s0[16];
+  ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, s0, ctr0);
+  for (size_t i = 0; i < 16; ++i)
+    mac[i] ^= s0[i];
+}
+
+/* Runs the CBC-MAC over B0 & the associated data of a single message. */
+static void ccm_mac_header(AesCcmContext *ctx, const unsigned char b0[16],
+                           size_t aadsize, const unsigned char *aad,
+                           unsigned char mac[16]) {
+  struct ccm_mac_stream stream;
+  const unsigned char *blocks;
+  size_t nblocks;
+
+  memset(mac, 0, 16);
+  ccm_stream_init(&stream, b0, aadsize, aad, 0, NULL);
+  while ((nblocks = ccm_stream_next(&stream, &blocks)))
+    ctx->ccm_vtable->cbc_mac_lanes(&ctx->aes, 1, nblocks, &blocks, mac);
+}
+
+int aes_ccm_seal(AesCcmContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 unsigned char *tag) {
+  unsigned char b0[16], ctr0[16], mac[16];
+
+  if (!ccm_sizes_are_valid(noncesize, tagsize) ||
+      !ccm_textsize_fits(noncesize, textsize))
+    return -1;
+
+  ccm_format(b0, ctr0, textsize, aadsize, noncesize, nonce, tagsize);
+  ccm_mac_header(ctx, b0, aadsize, aad, mac);
+
+  unsigned char ctr1[16];
+  memcpy(ctr1, ctr0, 16);
+  ctr1[15] = 1;
+  ctx->ccm_vtable->encrypt(&ctx->aes, textsize, cipher_text, plain_text, ctr1,
+                           mac);
+
+  ccm_final(ctx, ctr0, mac);
+  memcpy(tag, mac, tagsize);
+  return 0;
+}
+
+int aes_ccm_open(AesCcmContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 const unsigned char *tag) {
+  unsigned char b0[16], ctr0[16], mac[16];
+
+  if (!ccm_sizes_are_valid(noncesize, tagsize) ||
+      !ccm_textsize_fits(noncesize, textsize))
+    return -1;
+
+  ccm_format(b0, ctr0, textsize, aadsize, noncesize, nonce, tagsize);
+  ccm_mac_header(ctx, b0, aadsize, aad, mac);
+
+  unsigned char ctr1[16];
+  memcpy(ctr1, ctr0, 16);
+  ctr1[15] = 1;
+  ctx->ccm_vtable->decrypt(&ctx->aes, textsize, plain_text, cipher_text, ctr1,
+                           mac);
+
+  ccm_final(ctx, ctr0, mac);
+  if (aes_ct_memcmp(mac, tag, tagsize) != 0) {
+    if (textsize)
+      memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  return 0;
+}
+
+/* A message whose CBC-MAC chain is being advanced by aes_ccm_*_multi(). */
+struct ccm_lane {
+  bool active;
+  const AesCcmMessage *message;
+  struct ccm_mac_stream stream;
+  const unsigned char *blocks;
+  size_t nblocks;
+  unsigned char mac[16];
+};
+
+static void ccm_lane_start(struct ccm_lane *lane, const AesCcmMessage *message,
+                           size_t noncesize, size_t tagsize, bool seal) {
+  unsigned char b0[16], ctr0[16];
+  ccm_format(b0, ctr0, message->textsize, message->aadsize, noncesize,
+             message->nonce, tagsize);
+
+  lane->active = true;
+  lane->message = message;
+  ccm_stream_init(&lane->stream, b0, message->aadsize, message->aad,
+                  message->textsize, seal ? message->in : message->out);
+  lane->nblocks = ccm_stream_next(&lane->stream, &lane->blocks);
+  memset(lane->mac, 0, 16);
+}
+
+/* Computes the tag of a finished lane; writes it when sealing, checks it when
+ * opening. */
+static int ccm_lane_finish(AesCcmContext *ctx, struct ccm_lane *lane,
+                           size_t noncesize, size_t tagsize, bool seal) {
+  const AesCcmMessage *message = lane->message;
+  unsigned char b0[16], ctr0[16];
+
+  lane->active = false;
+  ccm_format(b0, ctr0, message->textsize, message->aadsize, noncesize,
+             message->nonce, tagsize);
+  ccm_final(ctx, ctr0, lane->mac);
+
+  if (seal) {
+    memcpy(message->tag, lane->mac, tagsize);
+    return 0;
+  }
+
+  if (aes_ct_memcmp(lane->mac, message->tag, tagsize) != 0) {
+    if (message->textsize)
+      memset(message->out, 0, message->textsize);
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Advances the CBC-MAC chains of up to AES_CCM_LANES messages together. Each
+ * step runs all active chains for as many blocks as the shortest current run;
+ * a lane whose message is done is refilled with the next pending message.
+ */
+static int ccm_mac_multi(AesCcmContext *ctx, size_t nmessages,
+                         const AesCcmMessage *messages, size_t noncesize,
+                         size_t tagsize, bool seal, int *results) {
+  struct ccm_lane lanes[AES_CCM_LANES];
+  size_t next_message = 0;
+  int ret = 0;
+
+  for (size_t j = 0; j < AES_CCM_LANES; ++j)
+    lanes[j].active = false;
+
+  for (;;) {
+    const unsigned char *in[AES_CCM_LANES];
+    unsigned char macs[AES_CCM_LANES * 16];
+    size_t active[AES_CCM_LANES];
+    size_t nlanes = 0, nblocks = SIZE_MAX;
+
+    for (size_t j = 0; j < AES_CCM_LANES; ++j) {
+      struct ccm_lane *lane = &lanes[j];
+
+      /* Finish messages whose MAC input has run out & refill their lane. */
+      while (lane->active ? !lane->nblocks : next_message < nmessages) {
+        if (lane->active) {
+          size_t index = (size_t)(lane->message - messages);
+          int result = ccm_lane_finish(ctx, lane, noncesize, tagsize, seal);
+          if (results)
+            results[index] = result;
+          ret |= result;
+        } else {
+          ccm_lane_start(lane, &messages[next_message++], noncesize, tagsize,
+                         seal);
+        }
+      }
+
+      if (!lane->active)
+        continue;
+
+      in[nlanes] = lane->blocks;
+      memcpy(&macs[nlanes * 16], lane->mac, 16);
+      active[nlanes++] = j;
+      if (lane->nblocks < nblocks)
+        nblocks = lane->nblocks;
+    }
+
+    if (!nlanes)
+      return ret;
+
+    ctx->ccm_vtable->cbc_mac_lanes(&ctx->aes, nlanes, nblocks, in, macs);
+
+    for (size_t i = 0; i < nlanes; ++i) {
+      struct ccm_lane *lane = &lanes[active[i]];
+      memcpy(lane->mac, &macs[i * 16], 16);
+      lane->blocks += nblocks * 16;
+      lane->nblocks -= nblocks;
+      if (!lane->nblocks)
+        lane->nblocks = ccm_stream_next(&lane->stream, &lane->blocks);
+    }
+  }
+}
+
+/* Counter-mode pass of a message of aes_ccm_*_multi(). */
+static void ccm_ctr_message(AesCcmContext *ctx, const AesCcmMessage *message,
+                            size_t noncesize, size_t tagsize) {
+  unsigned char b0[16], ctr1[16];
+  ccm_format(b0, ctr1, message->textsize, message->aadsize, noncesize,
+             message->nonce, tagsize);
+  ctr1[15] = 1;
+
+  ctx->ccm_vtable->ctr64_xcrypt(&ctx->aes, message->textsize, message->out,
+                                message->in, ctr1);
+}
+
+int aes_ccm_seal_multi(AesCcmContext *ctx, size_t nmessages,
+                       const AesCcmMessage *messages, size_t noncesize,
+                       size_t tagsize) {
+  if (!ccm_sizes_are_valid(noncesize, tagsize) ||
+      !ccm_messages_fit(nmessages, messages, noncesize))
+    return -1;
+
+  /* The plain text is MACed before it is encrypted (maybe in place). */
+  ccm_mac_multi(ctx, nmessages, messages, noncesize, tagsize, true, NULL);
+  for (size_t i = 0; i < nmessages; ++i)
+    ccm_ctr_message(ctx, &messages[i], noncesize, tagsize);
+  return 0;
+}
+
+int aes_ccm_open_multi(AesCcmContext *ctx, size_t nmessages,
+                       const AesCcmMessage *messages, size_t noncesize,
+                       size_t tagsize, int *results) {
+  if (!ccm_sizes_are_valid(noncesize, tagsize) ||
+      !ccm_messages_fit(nmessages, messages, noncesize)) {
+    for (size_t i = 0; results && i < nmessages; ++i)
+      results[i] = -1;
+    return -1;
+  }
+
+  for (size_t i = 0; i < nmessages; ++i)
+    ccm_ctr_message(ctx, &messages[i], noncesize, tagsize);
+  return ccm_mac_multi(ctx, nmessages, messages, noncesize, tagsize, false,
+                       results);
+}
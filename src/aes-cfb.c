@@ -0,0 +1,84 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+void aes_cfb_set_iv(AesCfbContext *ctx, const unsigned char iv[16]) {
+  memcpy(ctx->iv, iv, 16);
+  ctx->used = 0;
+}
+
+/*
+ * CFB128 in parts: at the start of a block the key stream E(K, iv) replaces
+ * the register, then each byte of key stream is overwritten by the cipher
+ * text byte it produced, so the register holds the previous cipher text block
+ * again at the end of the block.
+ */
+static size_t cfb128_partial(AesCfbContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             int encrypt) {
+  size_t size = 16 - ctx->used;
+  if (size > textsize)
+    size = textsize;
+
+  for (size_t i = 0; i < size; ++i) {
+    unsigned char c = encrypt ? in[i] ^ ctx->iv[ctx->used] : in[i];
+    out[i] = in[i] ^ ctx->iv[ctx->used];
+    ctx->iv[ctx->used++] = c;
+  }
+
+  ctx->used %= 16;
+  return size;
+}
+
+static void cfb128_crypt(AesCfbContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         int encrypt) {
+  if (ctx->used) {
+    size_t size = cfb128_partial(ctx, textsize, out, in, encrypt);
+    out += size;
+    in += size;
+    textsize -= size;
+  }
+
+  size_t full_size = textsize - textsize % 16;
+  if (full_size) {
+    if (encrypt)
+      ctx->cfb_vtable->cfb128_encrypt(&ctx->aes, full_size, out, in, ctx->iv);
+    else
+      ctx->cfb_vtable->cfb128_decrypt(&ctx->aes, full_size, out, in, ctx->iv);
+  }
+
+  if (textsize % 16) {
+    ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, ctx->iv, ctx->iv);
+    cfb128_partial(ctx, textsize % 16, &out[full_size], &in[full_size],
+                   encrypt);
+  }
+}
+
+void aes_cfb128_encrypt(AesCfbContext *ctx, size_t textsize,
+                        unsigned char *cipher_text,
+                        const unsigned char *plain_text) {
+  cfb128_crypt(ctx, textsize, cipher_text, plain_text, 1);
+}
+
+void aes_cfb128_decrypt(AesCfbContext *ctx, size_t textsize,
+                        unsigned char *plain_text,
+                        const unsigned char *cipher_text) {
+  cfb128_crypt(ctx, textsize, plain_text, cipher_text, 0);
+}
+
+void aes_cfb8_encrypt(AesCfbContext *ctx, size_t textsize,
+                      unsigned char *cipher_text,
+                      const unsigned char *plain_text) {
+  ctx->cfb_vtable->cfb8_encrypt(&ctx->aes, textsize, cipher_text, plain_text,
+                                ctx->iv);
+}
+
+void aes_cfb8_decrypt(AesCfbContext *ctx, size_t textsize,
+                      unsigned char *plain_text,
+                      const unsigned char *cipher_text) {
+  ctx->cfb_vtable->cfb8_decrypt(&ctx->aes, textsize, plain_text, cipher_text,
+                                ctx->iv);
+}
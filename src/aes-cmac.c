@@ -0,0 +1,125 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* A message whose CBC-MAC chain is being advanced by aes_cmac_multi(). */
+struct cmac_lane {
+  bool active;
+  bool last_pending;
+  const AesCmacMessage *message;
+  const unsigned char *blocks;
+  size_t nblocks;
+  unsigned char last_block[16];
+  unsigned char mac[16];
+};
+
+/* All blocks but the last are read in place; the last one is masked with K1
+ * if it is complete & padded then masked with K2 otherwise (section 2.4 of
+ * RFC 4493). */
+static void cmac_lane_start(const AesCmacContext *ctx, struct cmac_lane *lane,
+                            const AesCmacMessage *message) {
+  size_t nblocks = message->size ? (message->size - 1) / 16 : 0;
+  size_t tail = message->size - nblocks * 16;
+  const unsigned char *subkey = tail == 16 ? ctx->k1 : ctx->k2;
+
+  memset(lane->last_block, 0, 16);
+  if (tail)
+    memcpy(lane->last_block, &message->in[nblocks * 16], tail);
+  if (tail < 16)
+    lane->last_block[tail] = 0x80;
+  for (size_t i = 0; i < 16; ++i)
+    lane->last_block[i] ^= subkey[i];
+
+  lane->active = true;
+  lane->last_pending = true;
+  lane->message = message;
+  lane->blocks = message->in;
+  lane->nblocks = nblocks;
+  memset(lane->mac, 0, 16);
+}
+
+/* Moves a lane whose current run is done on to the last block, or retires it
+ * once that is done too. */
+static void cmac_lane_next(struct cmac_lane *lane) {
+  if (lane->last_pending) {
+    lane->last_pending = false;
+    lane->blocks = lane->last_block;
+    lane->nblocks = 1;
+  } else {
+    lane->active = false;
+    memcpy(lane->message->mac, lane->mac, 16);
+  }
+}
+
+/* K1 & K2 (section 2.3 of RFC 4493). */
+void aes_cmac_init_subkeys(AesCmacContext *ctx) {
+  static const unsigned char zero[16] = {0};
+  unsigned char l[16];
+
+  ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, l, zero);
+  aes_gf128_double(ctx->k1, l);
+  aes_gf128_double(ctx->k2, ctx->k1);
+}
+
+void aes_cmac(AesCmacContext *ctx, size_t size, const unsigned char *in,
+              unsigned char mac[16]) {
+  const AesCmacMessage message = {.size = size, .in = in, .mac = mac};
+  aes_cmac_multi(ctx, 1, &message);
+}
+
+/*
+ * Each step runs all active chains for as many blocks as the shortest current
+ * run; a lane whose message is done is refilled with the next pending message,
+ * so the pipeline stays full however the message sizes are mixed.
+ */
+void aes_cmac_multi(AesCmacContext *ctx, size_t nmessages,
+                    const AesCmacMessage *messages) {
+  struct cmac_lane lanes[AES_CMAC_LANES];
+  size_t next_message = 0;
+
+  for (size_t j = 0; j < AES_CMAC_LANES; ++j)
+    lanes[j].active = false;
+
+  for (;;) {
+    const unsigned char *in[AES_CMAC_LANES];
+    unsigned char macs[AES_CMAC_LANES * 16];
+    size_t active[AES_CMAC_LANES];
+    size_t nlanes = 0, nblocks = SIZE_MAX;
+
+    for (size_t j = 0; j < AES_CMAC_LANES; ++j) {
+      struct cmac_lane *lane = &lanes[j];
+
+      while (lane->active ? !lane->nblocks : next_message < nmessages) {
+        if (lane->active)
+          cmac_lane_next(lane);
+        else
+          cmac_lane_start(ctx, lane, &messages[next_message++]);
+      }
+
+      if (!lane->active)
+        continue;
+
+      in[nlanes] = lane->blocks;
+      memcpy(&macs[nlanes * 16], lane->mac, 16);
+      active[nlanes++] = j;
+      if (lane->nblocks < nblocks)
+        nblocks = lane->nblocks;
+    }
+
+    if (!nlanes)
+      return;
+
+    ctx->cmac_vtable->cbc_mac_lanes(&ctx->aes, nlanes, nblocks, in, macs);
+
+    for (size_t i = 0; i < nlanes; ++i) {
+      struct cmac_lane *lane = &lanes[active[i]];
+      memcpy(lane->mac, &macs[i * 16], 16);
+      lane->blocks += nblocks * 16;
+      lane->nblocks -= nblocks;
+    }
+  }
+}
@@ -0,0 +1,134 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* seedlen of AES-256 CTR_DRBG: a key & a block */
+#define DRBG_SEED_SIZE 48
+
+/* max_number_of_bits_per_request (2^19) of SP 800-90A, table 3 */
+#define DRBG_MAX_REQUEST_SIZE ((size_t)1 << 16)
+
+/* reseed_interval of SP 800-90A, table 3 */
+#define DRBG_RESEED_INTERVAL ((uint64_t)1 << 48)
+
+/* Adds n to the 64-bit counter in the last 8 bytes of v (ctr_len = 64). */
+static void drbg_add_counter(unsigned char v[16], uint64_t n) {
+  for (size_t i = 15; i >= 8 && n; --i) {
+    n += v[i];
+    v[i] = (unsigned char)n;
+    n >>= 8;
+  }
+}
+
+/* Writes E(Key, V + 1) || E(Key, V + 2) || ... & advances V past the last
+ * counter used, through the interleaved CTR kernel. */
+static void drbg_keystream(AesCtrDrbgContext *ctx, size_t size,
+                           unsigned char *out) {
+  unsigned char counter[16];
+
+  memcpy(counter, ctx->v, 16);
+  drbg_add_counter(counter, 1);
+
+  memset(out, 0, size);
+  ctx->ctr.ccm_vtable->ctr64_xcrypt(&ctx->ctr.aes, size, out, out, counter);
+  drbg_add_counter(ctx->v, (size + 15) / 16);
+}
+
+/* CTR_DRBG_Update (SP 800-90A, section 10.2.1.2) */
+static void drbg_update(AesCtrDrbgContext *ctx,
+                        const unsigned char provided_data[DRBG_SEED_SIZE]) {
+  unsigned char temp[DRBG_SEED_SIZE];
+
+  drbg_keystream(ctx, sizeof temp, temp);
+  for (size_t i = 0; i < sizeof temp; ++i)
+    temp[i] ^= provided_data[i];
+
+  ctx->ctr.aes.vtable->init(&ctx->ctr.aes, KEY_TYPE_AES256, temp);
+  memcpy(ctx->v, &temp[32], 16);
+}
+
+/* Pads an input of at most DRBG_SEED_SIZE bytes with zeros & XORs it into
+ * `seed`. */
+static void drbg_xor_input(unsigned char seed[DRBG_SEED_SIZE], size_t size,
+                           const unsigned char *input) {
+  for (size_t i = 0; i < size; ++i)
+    seed[i] ^= input[i];
+}
+
+int aes_ctr_drbg_init(AesCtrDrbgContext *ctx, const unsigned char entropy[48],
+                      size_t perssize, const unsigned char *pers) {
+  static const unsigned char zero_key[32] = {0};
+  unsigned char seed[DRBG_SEED_SIZE];
+
+  if (perssize > DRBG_SEED_SIZE)
+    return -1;
+
+  memcpy(seed, entropy, DRBG_SEED_SIZE);
+  drbg_xor_input(seed, perssize, pers);
+
+  aes_ccm_init(&ctx->ctr, KEY_TYPE_AES256, zero_key);
+  memset(ctx->v, 0, 16);
+  drbg_update(ctx, seed);
+  ctx->reseed_counter = 1;
+  return 0;
+}
+
+int aes_ctr_drbg_reseed(AesCtrDrbgContext *ctx, const unsigned char entropy[48],
+                        size_t addsize, const unsigned char *add) {
+  unsigned char seed[DRBG_SEED_SIZE];
+
+  if (addsize > DRBG_SEED_SIZE)
+    return -1;
+
+  memcpy(seed, entropy, DRBG_SEED_SIZE);
+  drbg_xor_input(seed, addsize, add);
+
+  drbg_update(ctx, seed);
+  ctx->reseed_counter = 1;
+  return 0;
+}
+
+int aes_ctr_drbg_generate(AesCtrDrbgContext *ctx, size_t size,
+                          unsigned char *out, size_t addsize,
+                          const unsigned char *add) {
+  unsigned char additional[DRBG_SEED_SIZE] = {0};
+  uint64_t nrequests = size ? (size - 1) / DRBG_MAX_REQUEST_SIZE + 1 : 1;
+
+  if (addsize > DRBG_SEED_SIZE ||
+      nrequests > DRBG_RESEED_INTERVAL - ctx->reseed_counter + 1)
+    return -1;
+
+  if (addsize) {
+    drbg_xor_input(additional, addsize, add);
+    drbg_update(ctx, additional);
+  }
+
+  /* Each request ends with an update, which gives the next one a new key. */
+  for (uint64_t i = 0; i < nrequests; ++i) {
+    size_t request_size =
+        size < DRBG_MAX_REQUEST_SIZE ? size : DRBG_MAX_REQUEST_SIZE;
+
+    drbg_keystream(ctx, request_size, out);
+    drbg_update(ctx, additional);
+    ++ctx->reseed_counter;
+
+    out += request_size;
+    size -= request_size;
+    memset(additional, 0, sizeof additional);
+  }
+
+  return 0;
+}
+
+int aes_ctr_drbg_spawn(AesCtrDrbgContext *parent, AesCtrDrbgContext *child,
+                       size_t perssize, const unsigned char *pers) {
+  unsigned char entropy[DRBG_SEED_SIZE];
+
+  if (aes_ctr_drbg_generate(parent, sizeof entropy, entropy, 0, NULL))
+    return -1;
+
+  return aes_ctr_drbg_init(child, entropy, perssize, pers);
+}
@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/*
+ * AES-EAX (Bellare, Rogaway & Wagner). Every OMAC^t starts with the block
+ * [t], so its chain after that block is the constant E(K, [t]), derived once
+ * with the subkeys. The OMACs of the nonce & of the header are independent &
+ * advance as two lanes of the CBC-MAC kernel; the OMAC of the cipher text
+ * runs inside the CTR kernel.
+ */
+
+/* An OMAC^t whose chain is advanced by the caller. */
+struct eax_omac {
+  const unsigned char *blocks;
+  size_t nblocks;
+  unsigned char last_block[16];
+  unsigned char mac[16];
+};
+
+/* Sets up OMAC^t of a `size`-byte message: all of its blocks but the last one
+ * are read in place by the chain. */
+static void eax_omac_start(const AesEaxContext *ctx, struct eax_omac *omac,
+                           unsigned t, size_t size, const unsigned char *in) {
+  omac->blocks = in;
+  omac->nblocks = size ? (size - 1) / 16 : 0;
+
+  if (size)
+    memcpy(omac->mac, ctx->l[t], 16);
+  else
+    memset(omac->mac, 0, 16);
+}
+
+/* The last block is masked with K1 if it is complete & padded then masked
+ * with K2 otherwise. [t] is the only block of an empty message. */
+static void eax_omac_set_last_block(const AesEaxContext *ctx,
+                                    struct eax_omac *omac, unsigned t,
+                                    size_t size, const unsigned char *in) {
+  size_t tail = size - omac->nblocks * 16;
+  const unsigned char *subkey = !size || tail == 16 ? ctx->k1 : ctx->k2;
+
+  memset(omac->last_block, 0, 16);
+  if (size)
+    memcpy(omac->last_block, &in[omac->nblocks * 16], tail);
+  else
+    omac->last_block[15] = (unsigned char)t;
+  if (size && tail < 16)
+    omac->last_block[tail] = 0x80;
+  for (size_t i = 0; i < 16; ++i)
+    omac->last_block[i] ^= subkey[i];
+}
+
+/* N = OMAC^0(nonce) & H = OMAC^1(header), side by side. */
+static void eax_omac_nonce_header(AesEaxContext *ctx, size_t noncesize,
+                                  const unsigned char *nonce, size_t aadsize,
+                                  const unsigned char *aad, unsigned char n[16],
+                                  unsigned char h[16]) {
+  struct eax_omac omacs[2];
+  eax_omac_start(ctx, &omacs[0], 0, noncesize, nonce);
+  eax_omac_start(ctx, &omacs[1], 1, aadsize, aad);
+  eax_omac_set_last_block(ctx, &omacs[0], 0, noncesize, nonce);
+  eax_omac_set_last_block(ctx, &omacs[1], 1, aadsize, aad);
+
+  unsigned char macs[2 * 16];
+  memcpy(&macs[0], omacs[0].mac, 16);
+  memcpy(&macs[16], omacs[1].mac, 16);
+
+  /* Both chains go together for as long as both have blocks. */
+  size_t nblocks = omacs[0].nblocks < omacs[1].nblocks ? omacs[0].nblocks
+                                                       : omacs[1].nblocks;
+  if (nblocks) {
+    const unsigned char *in[2] = {omacs[0].blocks, omacs[1].blocks};
+    ctx->eax_vtable->cbc_mac_lanes(&ctx->aes, 2, nblocks, in, macs);
+  }
+
+  for (size_t j = 0; j < 2; ++j) {
+    if (omacs[j].nblocks > nblocks) {
+      const unsigned char *in = &omacs[j].blocks[nblocks * 16];
+      ctx->eax_vtable->cbc_mac_lanes(&ctx->aes, 1, omacs[j].nblocks - nblocks,
+                                     &in, &macs[j * 16]);
+    }
+  }
+
+  const unsigned char *last_blocks[2] = {omacs[0].last_block,
+                                         omacs[1].last_block};
+  ctx->eax_vtable->cbc_mac_lanes(&ctx->aes, 2, 1, last_blocks, macs);
+
+  memcpy(n, &macs[0], 16);
+  memcpy(h, &macs[16], 16);
+}
+
+/* Tag = N ^ H ^ C, where C = OMAC^2(cipher text) once its last block is
+ * absorbed. */
+static void eax_final(AesEaxContext *ctx, struct eax_omac *omac,
+                      const unsigned char n[16], const unsigned char h[16],
+                      unsigned char tag[16]) {
+  const unsigned char *last_block = omac->last_block;
+  ctx->eax_vtable->cbc_mac_lanes(&ctx->aes, 1, 1, &last_block, omac->mac);
+
+  for (size_t i = 0; i < 16; ++i)
+    tag[i] = n[i] ^ h[i] ^ omac->mac[i];
+}
+
+void aes_eax_init_subkeys(AesEaxContext *ctx) {
+  unsigned char blocks[4 * 16] = {0}, l[4 * 16];
+
+  /* E(K, 0) for the subkeys, then E(K, [t]) for t = 0, 1, 2. */
+  for (size_t t = 0; t < 3; ++t)
+    blocks[(t + 1) * 16 + 15] = (unsigned char)t;
+  ctx->aes.vtable->ecb_encrypt(&ctx->aes, sizeof blocks, l, blocks);
+
+  aes_gf128_double(ctx->k1, l);
+  aes_gf128_double(ctx->k2, ctx->k1);
+  memcpy(ctx->l, &l[16], sizeof ctx->l);
+}
+
+int aes_eax_seal(AesEaxContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 unsigned char *tag) {
+  unsigned char n[16], h[16], full_tag[16];
+  struct eax_omac omac;
+
+  if (tagsize == 0 || tagsize > 16)
+    return -1;
+
+  eax_omac_nonce_header(ctx, noncesize, nonce, aadsize, aad, n, h);
+
+  eax_omac_start(ctx, &omac, 2, textsize, cipher_text);
+  ctx->eax_vtable->encrypt(&ctx->aes, textsize, cipher_text, plain_text, n,
+                           omac.mac);
+  eax_omac_set_last_block(ctx, &omac, 2, textsize, cipher_text);
+
+  eax_final(ctx, &omac, n, h, full_tag);
+  memcpy(tag, full_tag, tagsize);
+  return 0;
+}
+
+int aes_eax_open(AesEaxContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 const unsigned char *tag) {
+  unsigned char n[16], h[16], full_tag[16];
+  struct eax_omac omac;
+
+  eax_omac_nonce_header(ctx, noncesize, nonce, aadsize, aad, n, h);
+
+  /* The last block is read before it can be overwritten when decrypting in
+   * place. */
+  eax_omac_start(ctx, &omac, 2, textsize, cipher_text);
+  eax_omac_set_last_block(ctx, &omac, 2, textsize, cipher_text);
+  ctx->eax_vtable->decrypt(&ctx->aes, textsize, plain_text, cipher_text, n,
+                           omac.mac);
+
+  eax_final(ctx, &omac, n, h, full_tag);
+  if (tagsize == 0 || tagsize > 16 ||
+      aes_ct_memcmp(full_tag, tag, tagsize) != 0) {
+    if (textsize)
+      memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  return 0;
+}
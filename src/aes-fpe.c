@@ -0,0 +1,501 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/*
+ * Format-preserving encryption, FF1 & FF3-1 (NIST SP 800-38G Rev. 1). Each
+ * Feistel round only encrypts a block or two, so tokens of the same size are
+ * processed in groups of FPE_LANES whose rounds run in lockstep: a round is a
+ * single call to the CBC-MAC lanes (FF1) or to multi-block ECB (FF3-1) for the
+ * whole group.
+ *
+ * A token is copied to its output & its halves A & B are updated in place:
+ * each round adds to one half & swaps the roles of the two, and both ciphers
+ * have an even number of rounds, so A ends up first again. FF1 reads numeral
+ * strings most significant numeral first; FF3-1 uses REV() of its halves, so
+ * it reads them least significant numeral first.
+ */
+
+#define FPE_LANES AES_CCM_LANES
+
+/* b & d of FF1 for the largest tokens: 2 bytes per numeral of half of the
+ * numerals, & 4 * ceil(b / 4) + 4. */
+#define FF1_MAX_B AES_FF1_MAX_LEN
+#define FF1_MAX_D (FF1_MAX_B + 4)
+#define FF1_MAX_S_BLOCKS ((FF1_MAX_D + 15) / 16)
+#define FF1_MAX_TAIL_BLOCKS ((FF1_MAX_B + 1 + 15) / 16)
+
+/* FF3-1 tokens are at most 2 * floor(log_radix(2^96)) numerals long. */
+#define FF3_MAX_LEN 192
+
+struct fpe_radix {
+  unsigned radix;
+  /* Division of 32-bit numbers by the radix, through a multiplication by its
+   * reciprocal (as in libdivide's branch-free unsigned division) */
+  uint32_t magic;
+  unsigned shift;
+  /* radix^chunk_digits, the largest power of the radix up to 2^32 */
+  uint64_t chunk;
+  size_t chunk_digits;
+};
+
+static void fpe_radix_init(struct fpe_radix *r, unsigned radix) {
+  unsigned log2_radix = 0;
+  while ((uint64_t)2 << log2_radix <= radix)
+    ++log2_radix;
+
+  if (!(radix & (radix - 1))) {
+    r->magic = 0;
+    r->shift = log2_radix - 1;
+  } else {
+    uint64_t m = ((uint64_t)1 << (32 + log2_radix)) / radix;
+    uint64_t rem = ((uint64_t)1 << (32 + log2_radix)) % radix;
+    r->magic = (uint32_t)(2 * m + (2 * rem >= radix) + 1);
+    r->shift = log2_radix;
+  }
+
+  r->radix = radix;
+  r->chunk = radix;
+  r->chunk_digits = 1;
+  while (r->chunk * radix <= (uint64_t)1 << 32) {
+    r->chunk *= radix;
+    ++r->chunk_digits;
+  }
+}
+
+static inline uint32_t fpe_div(const struct fpe_radix *r, uint32_t x) {
+  uint32_t t = (uint32_t)(((uint64_t)x * r->magic) >> 32);
+  return (((x - t) >> 1) + t) >> r->shift;
+}
+
+/* Both ciphers require radix^n >= 1000000 & n >= 2. */
+static bool fpe_size_is_valid(unsigned radix, size_t n) {
+  uint64_t power = 1;
+  for (size_t i = 0; i < n && power < 1000000; ++i)
+    power *= radix;
+
+  return n >= 2 && power >= 1000000;
+}
+
+static bool fpe_tokens_are_valid(unsigned radix, size_t ntokens,
+                                 const AesFpeToken *tokens, size_t n) {
+  for (size_t i = 0; i < ntokens; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      if (tokens[i].in[j] >= radix)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/* Number of bytes of radix^len - 1, i.e. ceil(ceil(len * log2(radix)) / 8);
+ * len must be at most AES_FF1_MAX_LEN. */
+static size_t fpe_num_size(unsigned radix, size_t len) {
+  unsigned char bytes[2 * AES_FF1_MAX_LEN] = {0};
+  size_t size = 0;
+
+  /* Little-endian Horner's method over the numerals radix - 1. */
+  for (size_t i = 0; i < len; ++i) {
+    uint32_t carry = radix - 1;
+    size_t j = 0;
+    for (; j < size || carry; ++j) {
+      carry += (uint32_t)bytes[j] * radix;
+      bytes[j] = (unsigned char)carry;
+      carry >>= 8;
+    }
+    if (j > size)
+      size = j;
+  }
+
+  return size;
+}
+
+/* [NUM_radix(x)]^size, or [NUM_radix(REV(x))]^size if `lsb_first`; size is
+ * at most FF1_MAX_B. The numerals are gathered chunk_digits at a time, then
+ * multiplied into 32-bit words. */
+static void fpe_num_to_bytes(const struct fpe_radix *r, const uint16_t *x,
+                             size_t len, bool lsb_first, unsigned char *out,
+                             size_t size) {
+  uint32_t words[(FF1_MAX_B + 3) / 4];
+  size_t nwords = (size + 3) / 4;
+
+  memset(words, 0, nwords * sizeof *words);
+  for (size_t i = 0; i < len;) {
+    uint64_t power = 1, carry = 0;
+    for (size_t k = 0; k < r->chunk_digits && i < len; ++k, ++i) {
+      carry = carry * r->radix + (lsb_first ? x[len - 1 - i] : x[i]);
+      power *= r->radix;
+    }
+
+    for (size_t j = nwords; j-- > 0;) {
+      carry += (uint64_t)words[j] * power;
+      words[j] = (uint32_t)carry;
+      carry >>= 32;
+    }
+  }
+
+  for (size_t i = 0; i < size; ++i) {
+    size_t pos = 4 * nwords - size + i;
+    out[i] = (unsigned char)(words[pos / 4] >> (24 - 8 * (pos % 4)));
+  }
+}
+
+static void fpe_bytes_to_words(uint32_t *words, const unsigned char *bytes,
+                               size_t nwords) {
+  for (size_t i = 0; i < nwords; ++i)
+    words[i] = (uint32_t)bytes[4 * i] << 24 |
+               (uint32_t)bytes[4 * i + 1] << 16 |
+               (uint32_t)bytes[4 * i + 2] << 8 | bytes[4 * i + 3];
+}
+
+/*
+ * x = (x + y) mod radix^len, or (x - y) mod radix^len if `subtract`, where y
+ * is a big-endian number of `nwords` 32-bit words; y is destroyed. The
+ * numerals of y are produced chunk_digits at a time, by dividing it by
+ * r->chunk.
+ */
+static void fpe_add(const struct fpe_radix *r, uint16_t *x, size_t len,
+                    bool lsb_first, uint32_t *y, size_t nwords,
+                    bool subtract) {
+  uint32_t carry = 0;
+  size_t first = 0;
+
+  for (size_t k = 0; k < len;) {
+    uint64_t rem = 0;
+    for (size_t j = first; j < nwords; ++j) {
+      rem = rem << 32 | y[j];
+      y[j] = (uint32_t)(rem / r->chunk);
+      rem %= r->chunk;
+    }
+    while (first < nwords && !y[first])
+      ++first;
+
+    /* rem < chunk <= 2^32 */
+    uint32_t chunk_rem = (uint32_t)rem;
+    for (size_t i = 0; i < r->chunk_digits && k < len; ++i, ++k) {
+      uint32_t quotient = fpe_div(r, chunk_rem);
+      uint32_t digit = chunk_rem - quotient * r->radix;
+      uint16_t *numeral = lsb_first ? &x[k] : &x[len - 1 - k];
+      uint32_t value;
+
+      chunk_rem = quotient;
+      if (subtract) {
+        digit += carry;
+        carry = *numeral < digit;
+        value = *numeral + (carry ? r->radix : 0) - digit;
+      } else {
+        value = *numeral + digit + carry;
+        carry = value >= r->radix;
+        value -= carry ? r->radix : 0;
+      }
+      *numeral = (uint16_t)value;
+    }
+  }
+}
+
+/* Copies each token to its output; A is its first `u` numerals, B the rest. */
+static void fpe_start_lanes(size_t nlanes, const AesFpeToken *tokens, size_t n,
+                            size_t u, uint16_t **a, uint16_t **b) {
+  for (size_t j = 0; j < nlanes; ++j) {
+    memmove(tokens[j].out, tokens[j].in, n * sizeof *tokens[j].out);
+    a[j] = tokens[j].out;
+    b[j] = &tokens[j].out[u];
+  }
+}
+
+static void fpe_swap_lanes(size_t nlanes, uint16_t **a, uint16_t **b) {
+  for (size_t j = 0; j < nlanes; ++j) {
+    uint16_t *tmp = a[j];
+    a[j] = b[j];
+    b[j] = tmp;
+  }
+}
+
+/*
+ * Sizes of an FF1 call. Q = T || [0]^pad || [i]^1 || [NUM_radix(B)]^b: the
+ * blocks of P || Q up to the tail, which holds [i] & B, are the same in every
+ * round, so their CBC-MAC is computed once per token.
+ */
+struct ff1_params {
+  struct fpe_radix r;
+  size_t n, u, v, b, d;
+  size_t tweaksize;
+  size_t qsize;
+  size_t tail_offset;
+  size_t tail_blocks;
+  unsigned char p[16];
+};
+
+static void ff1_params_init(struct ff1_params *params, unsigned radix,
+                            size_t n, size_t tweaksize) {
+  fpe_radix_init(&params->r, radix);
+  params->n = n;
+  params->u = n / 2;
+  params->v = n - params->u;
+  params->b = fpe_num_size(radix, params->v);
+  params->d = 4 * ((params->b + 3) / 4) + 4;
+  params->tweaksize = tweaksize;
+
+  size_t pad = (16 - (tweaksize + params->b + 1) % 16) % 16;
+  params->qsize = tweaksize + pad + 1 + params->b;
+  params->tail_blocks = (params->b + 1 + 15) / 16;
+  params->tail_offset = params->qsize - params->tail_blocks * 16;
+
+  /* P = [1]^1 || [2]^1 || [1]^1 || [radix]^3 || [10]^1 || [u mod 256]^1 ||
+   * [n]^4 || [t]^4 */
+  unsigned char *p = params->p;
+  p[0] = 1;
+  p[1] = 2;
+  p[2] = 1;
+  p[3] = (unsigned char)(radix >> 16);
+  p[4] = (unsigned char)(radix >> 8);
+  p[5] = (unsigned char)radix;
+  p[6] = 10;
+  p[7] = (unsigned char)params->u;
+  for (size_t i = 0; i < 4; ++i) {
+    p[11 - i] = (unsigned char)((uint64_t)n >> (8 * i));
+    p[15 - i] = (unsigned char)((uint64_t)tweaksize >> (8 * i));
+  }
+}
+
+/* Bytes [from, to) of T || [0]^pad. */
+static void ff1_copy_tweak(unsigned char *dst, const unsigned char *tweak,
+                           size_t tweaksize, size_t from, size_t to) {
+  for (size_t i = from; i < to; ++i)
+    dst[i - from] = i < tweaksize ? tweak[i] : 0;
+}
+
+/* CBC-MAC of P & of the blocks of Q before its tail. Whole blocks of the
+ * tweak are read in place; the rest of the prefix is at most one block. */
+static void ff1_prefix_lanes(AesFf1Context *ctx,
+                             const struct ff1_params *params, size_t nlanes,
+                             const AesFpeToken *tokens, unsigned char *macs) {
+  const unsigned char *in[FPE_LANES];
+  unsigned char blocks[FPE_LANES][16];
+  size_t nblocks = (params->tail_offset < params->tweaksize
+                        ? params->tail_offset
+                        : params->tweaksize) /
+                   16;
+
+  memset(macs, 0, nlanes * 16);
+  for (size_t j = 0; j < nlanes; ++j)
+    in[j] = params->p;
+  ctx->fpe_vtable->cbc_mac_lanes(&ctx->aes, nlanes, 1, in, macs);
+
+  if (nblocks) {
+    for (size_t j = 0; j < nlanes; ++j)
+      in[j] = tokens[j].tweak;
+    ctx->fpe_vtable->cbc_mac_lanes(&ctx->aes, nlanes, nblocks, in, macs);
+  }
+
+  if (params->tail_offset > nblocks * 16) {
+    for (size_t j = 0; j < nlanes; ++j) {
+      ff1_copy_tweak(blocks[j], tokens[j].tweak, params->tweaksize,
+                     nblocks * 16, params->tail_offset);
+      in[j] = blocks[j];
+    }
+    ctx->fpe_vtable->cbc_mac_lanes(&ctx->aes, nlanes, 1, in, macs);
+  }
+}
+
+static void ff1_crypt_lanes(AesFf1Context *ctx,
+                            const struct ff1_params *params, size_t nlanes,
+                            const AesFpeToken *tokens, bool encrypt) {
+  unsigned char prefix[FPE_LANES * 16], macs[FPE_LANES * 16];
+  unsigned char tails[FPE_LANES][FF1_MAX_TAIL_BLOCKS * 16];
+  unsigned char extra[FPE_LANES * (FF1_MAX_S_BLOCKS - 1) * 16];
+  unsigned char s[FF1_MAX_S_BLOCKS * 16];
+  uint32_t y[FF1_MAX_D / 4];
+  const unsigned char *in[FPE_LANES];
+  uint16_t *a[FPE_LANES], *b[FPE_LANES];
+
+  /* [i] & [NUM_radix(B)]^b are the last 1 + b bytes of the tail. */
+  size_t pos = params->qsize - params->b - 1 - params->tail_offset;
+  size_t nextra = (params->d + 15) / 16 - 1;
+
+  fpe_start_lanes(nlanes, tokens, params->n, params->u, a, b);
+  ff1_prefix_lanes(ctx, params, nlanes, tokens, prefix);
+  for (size_t j = 0; j < nlanes; ++j)
+    ff1_copy_tweak(tails[j], tokens[j].tweak, params->tweaksize,
+                   params->tail_offset, params->tail_offset + pos);
+
+  for (size_t round = 0; round < 10; ++round) {
+    unsigned i = (unsigned)(encrypt ? round : 9 - round);
+    size_t m = i % 2 ? params->v : params->u;
+
+    /* R = PRF(P || Q), Q being built from B when encrypting, A otherwise. */
+    for (size_t j = 0; j < nlanes; ++j) {
+      tails[j][pos] = (unsigned char)i;
+      fpe_num_to_bytes(&params->r, encrypt ? b[j] : a[j], params->n - m,
+                       false, &tails[j][pos + 1], params->b);
+      in[j] = tails[j];
+    }
+    memcpy(macs, prefix, nlanes * 16);
+    ctx->fpe_vtable->cbc_mac_lanes(&ctx->aes, nlanes, params->tail_blocks, in,
+                                   macs);
+
+    /* S = R || CIPH(R ^ [1]^16) || CIPH(R ^ [2]^16) || ... */
+    for (size_t j = 0; j < nlanes; ++j) {
+      for (size_t e = 0; e < nextra; ++e) {
+        unsigned char *block = &extra[(j * nextra + e) * 16];
+        memcpy(block, &macs[j * 16], 16);
+        block[15] ^= (unsigned char)(e + 1);
+      }
+    }
+    if (nextra)
+      ctx->aes.vtable->ecb_encrypt(&ctx->aes, nlanes * nextra * 16, extra,
+                                   extra);
+
+    for (size_t j = 0; j < nlanes; ++j) {
+      memcpy(s, &macs[j * 16], 16);
+      memcpy(&s[16], &extra[j * nextra * 16], nextra * 16);
+      fpe_bytes_to_words(y, s, params->d / 4);
+      fpe_add(&params->r, encrypt ? a[j] : b[j], m, false, y, params->d / 4,
+              !encrypt);
+    }
+
+    fpe_swap_lanes(nlanes, a, b);
+  }
+}
+
+static int ff1_crypt_multi(AesFf1Context *ctx, size_t ntokens,
+                           const AesFpeToken *tokens, size_t n,
+                           size_t tweaksize, bool encrypt) {
+  struct ff1_params params;
+
+  if (n > AES_FF1_MAX_LEN || !fpe_size_is_valid(ctx->radix, n) ||
+      !fpe_tokens_are_valid(ctx->radix, ntokens, tokens, n))
+    return -1;
+
+  ff1_params_init(&params, ctx->radix, n, tweaksize);
+  for (size_t i = 0; i < ntokens; i += FPE_LANES) {
+    size_t nlanes = ntokens - i < FPE_LANES ? ntokens - i : FPE_LANES;
+    ff1_crypt_lanes(ctx, &params, nlanes, &tokens[i], encrypt);
+  }
+
+  return 0;
+}
+
+int aes_ff1_encrypt(AesFf1Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, size_t tweaksize,
+                    const unsigned char *tweak) {
+  const AesFpeToken token = {.out = out, .in = in, .tweak = tweak};
+  return ff1_crypt_multi(ctx, 1, &token, n, tweaksize, true);
+}
+
+int aes_ff1_decrypt(AesFf1Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, size_t tweaksize,
+                    const unsigned char *tweak) {
+  const AesFpeToken token = {.out = out, .in = in, .tweak = tweak};
+  return ff1_crypt_multi(ctx, 1, &token, n, tweaksize, false);
+}
+
+int aes_ff1_encrypt_multi(AesFf1Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n,
+                          size_t tweaksize) {
+  return ff1_crypt_multi(ctx, ntokens, tokens, n, tweaksize, true);
+}
+
+int aes_ff1_decrypt_multi(AesFf1Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n,
+                          size_t tweaksize) {
+  return ff1_crypt_multi(ctx, ntokens, tokens, n, tweaksize, false);
+}
+
+/* FF3-1: P = W ^ [i]^4 || [NUM_radix(REV(B))]^12, with W = T_R in even
+ * rounds & T_L in odd ones, & S = REVB(CIPH_REVB(K)(REVB(P))). */
+static void ff3_crypt_lanes(AesFf3Context *ctx, const struct fpe_radix *r,
+                            size_t nlanes, const AesFpeToken *tokens, size_t n,
+                            bool encrypt) {
+  unsigned char w[FPE_LANES][2][4];
+  unsigned char blocks[FPE_LANES * 16], macs[FPE_LANES * 16];
+  const unsigned char *in[FPE_LANES];
+  uint16_t *a[FPE_LANES], *b[FPE_LANES];
+  size_t u = (n + 1) / 2, v = n - u;
+
+  fpe_start_lanes(nlanes, tokens, n, u, a, b);
+  for (size_t j = 0; j < nlanes; ++j) {
+    const unsigned char *t = tokens[j].tweak;
+    const unsigned char t_r[4] = {t[4], t[5], t[6], (unsigned char)(t[3] << 4)};
+    const unsigned char t_l[4] = {t[0], t[1], t[2], t[3] & 0xf0};
+    memcpy(w[j][0], t_r, 4);
+    memcpy(w[j][1], t_l, 4);
+    in[j] = &blocks[j * 16];
+  }
+
+  for (size_t round = 0; round < 8; ++round) {
+    unsigned i = (unsigned)(encrypt ? round : 7 - round);
+    size_t m = i % 2 ? v : u;
+
+    for (size_t j = 0; j < nlanes; ++j) {
+      unsigned char p[16];
+      memcpy(p, w[j][i % 2], 4);
+      p[3] ^= (unsigned char)i;
+      fpe_num_to_bytes(r, encrypt ? b[j] : a[j], n - m, true, &p[4],
+                       12);
+      for (size_t k = 0; k < 16; ++k)
+        blocks[j * 16 + k] = p[15 - k];
+    }
+
+    /* With a zero chaining value, the CBC-MAC of one block is its
+     * encryption. */
+    memset(macs, 0, nlanes * 16);
+    ctx->fpe_vtable->cbc_mac_lanes(&ctx->aes, nlanes, 1, in, macs);
+
+    for (size_t j = 0; j < nlanes; ++j) {
+      unsigned char s[16];
+      uint32_t y[4];
+      for (size_t k = 0; k < 16; ++k)
+        s[k] = macs[j * 16 + 15 - k];
+      fpe_bytes_to_words(y, s, 4);
+      fpe_add(r, encrypt ? a[j] : b[j], m, true, y, 4, !encrypt);
+    }
+
+    fpe_swap_lanes(nlanes, a, b);
+  }
+}
+
+static int ff3_crypt_multi(AesFf3Context *ctx, size_t ntokens,
+                           const AesFpeToken *tokens, size_t n, bool encrypt) {
+  struct fpe_radix r;
+
+  if (n > FF3_MAX_LEN || !fpe_size_is_valid(ctx->radix, n) ||
+      fpe_num_size(ctx->radix, (n + 1) / 2) > 12 ||
+      !fpe_tokens_are_valid(ctx->radix, ntokens, tokens, n))
+    return -1;
+
+  fpe_radix_init(&r, ctx->radix);
+  for (size_t i = 0; i < ntokens; i += FPE_LANES) {
+    size_t nlanes = ntokens - i < FPE_LANES ? ntokens - i : FPE_LANES;
+    ff3_crypt_lanes(ctx, &r, nlanes, &tokens[i], n, encrypt);
+  }
+
+  return 0;
+}
+
+int aes_ff3_encrypt(AesFf3Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, const unsigned char tweak[7]) {
+  const AesFpeToken token = {.out = out, .in = in, .tweak = tweak};
+  return ff3_crypt_multi(ctx, 1, &token, n, true);
+}
+
+int aes_ff3_decrypt(AesFf3Context *ctx, size_t n, uint16_t *out,
+                    const uint16_t *in, const unsigned char tweak[7]) {
+  const AesFpeToken token = {.out = out, .in = in, .tweak = tweak};
+  return ff3_crypt_multi(ctx, 1, &token, n, false);
+}
+
+int aes_ff3_encrypt_multi(AesFf3Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n) {
+  return ff3_crypt_multi(ctx, ntokens, tokens, n, true);
+}
+
+int aes_ff3_decrypt_multi(AesFf3Context *ctx, size_t ntokens,
+                          const AesFpeToken *tokens, size_t n) {
+  return ff3_crypt_multi(ctx, ntokens, tokens, n, false);
+}
@@ -0,0 +1,120 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+static void gcm_siv_store_u64_le(unsigned char *dest, uint64_t value) {
+  for (size_t i = 0; i < 8; ++i)
+    dest[i] = (unsigned char)(value >> (8 * i));
+}
+
+/* Section 6 of RFC 8452 limits the text & the AAD to 2^36 bytes each. */
+static bool gcm_siv_sizes_are_valid(size_t textsize, size_t aadsize) {
+  return (uint64_t)textsize <= (uint64_t)1 << 36 &&
+         (uint64_t)aadsize <= (uint64_t)1 << 36;
+}
+
+/* Absorbs `size` bytes of data into s, zero-padding the last block. */
+static void gcm_siv_polyval_padded(const AesGcmSivContext *ctx,
+                                   const unsigned char *h_table,
+                                   unsigned char s[16], size_t size,
+                                   const unsigned char *data) {
+  size_t full_size = size - size % 16;
+  if (full_size)
+    ctx->siv_vtable->polyval(h_table, s, full_size, data);
+
+  if (size % 16) {
+    unsigned char block[16] = {0};
+    memcpy(block, &data[full_size], size % 16);
+    ctx->siv_vtable->polyval(h_table, s, 16, block);
+  }
+}
+
+/* Derives the message keys of a nonce: the POLYVAL table of the message
+ * authentication key, and the expanded message encryption key. */
+static void gcm_siv_derive(AesGcmSivContext *ctx, const unsigned char nonce[12],
+                           unsigned char *h_table, AesContext *enc_ctx) {
+  unsigned char auth_key[16], enc_key[32];
+  ctx->siv_vtable->derive_keys(&ctx->aes, nonce, auth_key, enc_key);
+
+  ctx->siv_vtable->polyval_init(h_table, auth_key);
+  ctx->aes.vtable->init(enc_ctx, (enum AesKeyType)ctx->aes.key_size, enc_key);
+}
+
+/* Computes the tag over the AAD & plain text (section 4 of RFC 8452). */
+static void gcm_siv_tag(AesGcmSivContext *ctx, const unsigned char *h_table,
+                        AesContext *enc_ctx, size_t textsize,
+                        const unsigned char *plain_text, size_t aadsize,
+                        const unsigned char *aad, const unsigned char nonce[12],
+                        unsigned char tag[16]) {
+  unsigned char s[16] = {0}, lengths[16];
+  gcm_siv_polyval_padded(ctx, h_table, s, aadsize, aad);
+  gcm_siv_polyval_padded(ctx, h_table, s, textsize, plain_text);
+  gcm_siv_store_u64_le(lengths, (uint64_t)aadsize * 8);
+  gcm_siv_store_u64_le(&lengths[8], (uint64_t)textsize * 8);
+  ctx->siv_vtable->polyval(h_table, s, 16, lengths);
+
+  for (size_t i = 0; i < 12; ++i)
+    s[i] ^= nonce[i];
+  s[15] &= 0x7f;
+
+  ctx->aes.vtable->ecb_encrypt(enc_ctx, 16, tag, s);
+}
+
+/* Encrypts or decrypts with the tag as the initial counter block. */
+static void gcm_siv_ctr(AesGcmSivContext *ctx, AesContext *enc_ctx,
+                        size_t textsize, unsigned char *out,
+                        const unsigned char *in, const unsigned char tag[16]) {
+  unsigned char counter[16];
+  memcpy(counter, tag, 16);
+  counter[15] |= 0x80;
+
+  ctx->siv_vtable->ctr32le_xcrypt(enc_ctx, textsize, out, in, counter);
+}
+
+int aes_gcm_siv_seal(AesGcmSivContext *ctx, size_t textsize,
+                     unsigned char *cipher_text,
+                     const unsigned char *plain_text, size_t aadsize,
+                     const unsigned char *aad, const unsigned char nonce[12],
+                     unsigned char tag[16]) {
+  AY_AES_ALIGNAS(16) unsigned char h_table[AES_HTABLE_SIZE];
+  AesContext enc_ctx;
+
+  if (!gcm_siv_sizes_are_valid(textsize, aadsize))
+    return -1;
+
+  gcm_siv_derive(ctx, nonce, h_table, &enc_ctx);
+  gcm_siv_tag(ctx, h_table, &enc_ctx, textsize, plain_text, aadsize, aad,
+              nonce, tag);
+  gcm_siv_ctr(ctx, &enc_ctx, textsize, cipher_text, plain_text, tag);
+  return 0;
+}
+
+int aes_gcm_siv_open(AesGcmSivContext *ctx, size_t textsize,
+                     unsigned char *plain_text,
+                     const unsigned char *cipher_text, size_t aadsize,
+                     const unsigned char *aad, const unsigned char nonce[12],
+                     const unsigned char tag[16]) {
+  AY_AES_ALIGNAS(16) unsigned char h_table[AES_HTABLE_SIZE];
+  AesContext enc_ctx;
+  unsigned char expected_tag[16];
+
+  if (!gcm_siv_sizes_are_valid(textsize, aadsize))
+    return -1;
+
+  gcm_siv_derive(ctx, nonce, h_table, &enc_ctx);
+  gcm_siv_ctr(ctx, &enc_ctx, textsize, plain_text, cipher_text, tag);
+  gcm_siv_tag(ctx, h_table, &enc_ctx, textsize, plain_text, aadsize, aad,
+              nonce, expected_tag);
+
+  if (aes_ct_memcmp(expected_tag, tag, 16) != 0) {
+    if (textsize)
+      memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  return 0;
+}
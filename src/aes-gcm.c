@@ -0,0 +1,212 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+static void gcm_store_u64_be(unsigned char *dest, uint64_t value) {
+  for (size_t i = 0; i < 8; ++i)
+    dest[i] = (unsigned char)(value >> (56 - 8 * i));
+}
+
+/* Absorbs `size` bytes of data into xi, zero-padding the last block. */
+static void gcm_ghash_padded(const AesGcmContext *ctx, unsigned char xi[16],
+                             size_t size, const unsigned char *data) {
+  size_t full_size = size - size % 16;
+  if (full_size)
+    ctx->gcm_vtable->ghash(ctx, xi, full_size, data);
+
+  if (size % 16) {
+    unsigned char block[16] = {0};
+    memcpy(block, &data[full_size], size % 16);
+    ctx->gcm_vtable->ghash(ctx, xi, 16, block);
+  }
+}
+
+/* Ghashes the lengths block [len(A)]_64 || [len(C)]_64 (in bits). */
+static void gcm_ghash_lengths(const AesGcmContext *ctx, unsigned char xi[16],
+                              uint64_t size_a, uint64_t size_c) {
+  unsigned char block[16];
+  gcm_store_u64_be(block, size_a * 8);
+  gcm_store_u64_be(&block[8], size_c * 8);
+  ctx->gcm_vtable->ghash(ctx, xi, 16, block);
+}
+
+/* A non-empty IV, & a text of at most 2^32 - 2 blocks so that the 32-bit
+ * counter doesn't wrap back to J0 (section 5.2.1.1 of NIST SP 800-38D). */
+static bool gcm_sizes_are_valid(size_t ivsize, size_t textsize) {
+  return ivsize && (uint64_t)textsize <= ((uint64_t)1 << 36) - 32;
+}
+
+/* Pre-counter block J0 (section 7.1 of NIST SP 800-38D). */
+static void gcm_derive_j0(const AesGcmContext *ctx, size_t ivsize,
+                          const unsigned char *iv, unsigned char j0[16]) {
+  if (ivsize == 12) {
+    memcpy(j0, iv, 12);
+    j0[12] = 0;
+    j0[13] = 0;
+    j0[14] = 0;
+    j0[15] = 1;
+    return;
+  }
+
+  memset(j0, 0, 16);
+  gcm_ghash_padded(ctx, j0, ivsize, iv);
+  gcm_ghash_lengths(ctx, j0, 0, ivsize);
+}
+
+static void gcm_increment_ctr32(unsigned char counter[16]) {
+  for (size_t i = 15; i >= 12; --i) {
+    if (++counter[i])
+      break;
+  }
+}
+
+/* Computes the full 16-byte tag from the GHASH of the AAD & cipher text. */
+static void gcm_final(AesGcmContext *ctx, size_t aadsize, size_t textsize,
+                      const unsigned char j0[16], unsigned char xi[16],
+                      unsigned char tag[16]) {
+  gcm_ghash_lengths(ctx, xi, aadsize, textsize);
+
+  ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, tag, j0);
+  for (size_t i = 0; i < 16; ++i)
+    tag[i] ^= xi[i];
+}
+
+int aes_gcm_seal(AesGcmContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t ivsize,
+                 const unsigned char *iv, size_t tagsize, unsigned char *tag) {
+  unsigned char j0[16], counter[16], xi[16] = {0}, full_tag[16];
+
+  if (tagsize == 0 || tagsize > 16 || !gcm_sizes_are_valid(ivsize, textsize))
+    return -1;
+
+  gcm_derive_j0(ctx, ivsize, iv, j0);
+  gcm_ghash_padded(ctx, xi, aadsize, aad);
+
+  memcpy(counter, j0, 16);
+  gcm_increment_ctr32(counter);
+  ctx->gcm_vtable->ctr32_encrypt(ctx, textsize, cipher_text, plain_text,
+                                 counter, xi);
+
+  gcm_final(ctx, aadsize, textsize, j0, xi, full_tag);
+  memcpy(tag, full_tag, tagsize);
+  return 0;
+}
+
+int aes_gcm_open(AesGcmContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t ivsize,
+                 const unsigned char *iv, size_t tagsize,
+                 const unsigned char *tag) {
+  unsigned char j0[16], counter[16], xi[16] = {0}, full_tag[16];
+
+  if (!gcm_sizes_are_valid(ivsize, textsize))
+    return -1;
+
+  gcm_derive_j0(ctx, ivsize, iv, j0);
+  gcm_ghash_padded(ctx, xi, aadsize, aad);
+
+  memcpy(counter, j0, 16);
+  gcm_increment_ctr32(counter);
+  ctx->gcm_vtable->ctr32_decrypt(ctx, textsize, plain_text, cipher_text,
+                                 counter, xi);
+
+  gcm_final(ctx, aadsize, textsize, j0, xi, full_tag);
+  if (tagsize == 0 || tagsize > 16 ||
+      aes_ct_memcmp(full_tag, tag, tagsize) != 0) {
+    if (textsize)
+      memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  return 0;
+}
+
+int aes_gmac(AesGcmContext *ctx, size_t size, const unsigned char *data,
+             size_t ivsize, const unsigned char *iv, size_t tagsize,
+             unsigned char *tag) {
+  unsigned char j0[16], xi[16] = {0}, full_tag[16];
+
+  if (tagsize == 0 || tagsize > 16 || !ivsize)
+    return -1;
+
+  gcm_derive_j0(ctx, ivsize, iv, j0);
+  gcm_ghash_padded(ctx, xi, size, data);
+  gcm_final(ctx, size, 0, j0, xi, full_tag);
+  memcpy(tag, full_tag, tagsize);
+  return 0;
+}
+
+int aes_gmac_verify(AesGcmContext *ctx, size_t size, const unsigned char *data,
+                    size_t ivsize, const unsigned char *iv, size_t tagsize,
+                    const unsigned char *tag) {
+  unsigned char j0[16], xi[16] = {0}, full_tag[16];
+
+  if (!ivsize)
+    return -1;
+
+  gcm_derive_j0(ctx, ivsize, iv, j0);
+  gcm_ghash_padded(ctx, xi, size, data);
+  gcm_final(ctx, size, 0, j0, xi, full_tag);
+
+  if (tagsize == 0 || tagsize > 16 ||
+      aes_ct_memcmp(full_tag, tag, tagsize) != 0)
+    return -1;
+  return 0;
+}
+
+void aes_ghash_reset(AesGhashContext *ctx) {
+  memset(ctx->s, 0, sizeof ctx->s);
+  ctx->buffersize = 0;
+}
+
+void aes_ghash_update(AesGhashContext *ctx, size_t size,
+                      const unsigned char *in) {
+  if (!size)
+    return;
+
+  if (ctx->buffersize) {
+    size_t fill = 16 - ctx->buffersize;
+    if (fill > size)
+      fill = size;
+
+    memcpy(&ctx->buffer[ctx->buffersize], in, fill);
+    ctx->buffersize += fill;
+    in += fill;
+    size -= fill;
+    if (ctx->buffersize < 16)
+      return;
+
+    ctx->ghash_vtable->update(ctx->h_table, ctx->s, 16, ctx->buffer);
+    ctx->buffersize = 0;
+  }
+
+  size_t full_size = size - size % 16;
+  if (full_size)
+    ctx->ghash_vtable->update(ctx->h_table, ctx->s, full_size, in);
+
+  ctx->buffersize = size - full_size;
+  memcpy(ctx->buffer, &in[full_size], ctx->buffersize);
+}
+
+void aes_ghash_pad(AesGhashContext *ctx) {
+  if (!ctx->buffersize)
+    return;
+
+  memset(&ctx->buffer[ctx->buffersize], 0, 16 - ctx->buffersize);
+  ctx->ghash_vtable->update(ctx->h_table, ctx->s, 16, ctx->buffer);
+  ctx->buffersize = 0;
+}
+
+void aes_ghash_final(const AesGhashContext *ctx, unsigned char out[16]) {
+  memcpy(out, ctx->s, 16);
+  if (ctx->buffersize) {
+    unsigned char block[16] = {0};
+    memcpy(block, ctx->buffer, ctx->buffersize);
+    ctx->ghash_vtable->update(ctx->h_table, out, 16, block);
+  }
+}
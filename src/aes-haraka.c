@@ -0,0 +1,206 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/*
+ * A message is absorbed as its full 32-byte blocks, read in place, then a
+ * tail of at most one zero-padded block & of a last block holding the size
+ * of the message (Merkle-Damgard strengthening), starting from h = 0. Since
+ * the size only comes at the end, a stream of unknown size can be hashed.
+ * Messages of a batch share the chain() calls of the kernel: each call
+ * advances all the messages that still have blocks by as many blocks as the
+ * shortest of them has left in its current part.
+ */
+struct haraka_lane {
+  const unsigned char *next; /* next block */
+  size_t nblocks;            /* number of blocks left in the current part */
+  size_t ntail;              /* number of tail blocks, until they are next */
+  unsigned char tail[64];
+};
+
+/* The zero-padded `rest` bytes of last if any, then LE64(size) || 0^24.
+ * Returns the number of blocks of the tail. */
+static size_t haraka_tail(unsigned char tail[64], size_t rest,
+                          const unsigned char *last, uint64_t size) {
+  size_t ntail = rest ? 2 : 1;
+  unsigned char *size_block = &tail[(ntail - 1) * 32];
+
+  memset(tail, 0, 64);
+  if (rest)
+    memcpy(tail, last, rest);
+  for (size_t i = 0; i < 8; ++i)
+    size_block[i] = (unsigned char)(size >> (8 * i));
+  return ntail;
+}
+
+static void haraka_lane_init(struct haraka_lane *lane, unsigned char h[32],
+                             size_t size, const unsigned char *data) {
+  size_t rest = size % 32;
+
+  memset(h, 0, 32);
+  lane->ntail =
+      haraka_tail(lane->tail, rest, rest ? &data[size - rest] : NULL, size);
+  lane->next = data;
+  lane->nblocks = size / 32;
+  if (!lane->nblocks) {
+    lane->next = lane->tail;
+    lane->nblocks = lane->ntail;
+    lane->ntail = 0;
+  }
+}
+
+/* Moves the lane past nblocks blocks, on to the tail after the data. */
+static void haraka_lane_advance(struct haraka_lane *lane, size_t nblocks) {
+  lane->next += nblocks * 32;
+  lane->nblocks -= nblocks;
+  if (!lane->nblocks && lane->ntail) {
+    lane->next = lane->tail;
+    lane->nblocks = lane->ntail;
+    lane->ntail = 0;
+  }
+}
+
+static void haraka_hash_lanes(const AesHarakaContext *ctx, size_t nlanes,
+                              const AesHarakaMessage *messages) {
+  struct haraka_lane lanes[AES_HARAKA_LANES];
+  unsigned char h[AES_HARAKA_LANES * 32];
+
+  for (size_t j = 0; j < nlanes; ++j)
+    haraka_lane_init(&lanes[j], &h[j * 32], messages[j].size,
+                     messages[j].data);
+
+  for (;;) {
+    const unsigned char *blocks[AES_HARAKA_LANES];
+    unsigned char active_h[AES_HARAKA_LANES * 32];
+    size_t active[AES_HARAKA_LANES];
+    size_t nactive = 0, nblocks = SIZE_MAX;
+
+    for (size_t j = 0; j < nlanes; ++j) {
+      if (!lanes[j].nblocks)
+        continue;
+
+      blocks[nactive] = lanes[j].next;
+      if (lanes[j].nblocks < nblocks)
+        nblocks = lanes[j].nblocks;
+      active[nactive++] = j;
+    }
+
+    if (!nactive)
+      break;
+
+    /* The chaining values are only gathered once some message is done. */
+    if (nactive == nlanes) {
+      ctx->haraka_vtable->chain(ctx->rc, nactive, h, nblocks, blocks);
+    } else {
+      for (size_t a = 0; a < nactive; ++a)
+        memcpy(&active_h[a * 32], &h[active[a] * 32], 32);
+      ctx->haraka_vtable->chain(ctx->rc, nactive, active_h, nblocks, blocks);
+      for (size_t a = 0; a < nactive; ++a)
+        memcpy(&h[active[a] * 32], &active_h[a * 32], 32);
+    }
+
+    for (size_t a = 0; a < nactive; ++a)
+      haraka_lane_advance(&lanes[active[a]], nblocks);
+  }
+
+  for (size_t j = 0; j < nlanes; ++j)
+    memcpy(messages[j].digest, &h[j * 32], 32);
+}
+
+void aes_haraka256(AesHarakaContext *ctx, size_t count, unsigned char *out,
+                   const unsigned char *in) {
+  ctx->haraka_vtable->haraka256(ctx->rc, count, out, in);
+}
+
+void aes_haraka512(AesHarakaContext *ctx, size_t count, unsigned char *out,
+                   const unsigned char *in) {
+  ctx->haraka_vtable->haraka512(ctx->rc, count, out, in);
+}
+
+void aes_haraka_hash(AesHarakaContext *ctx, size_t size,
+                     const unsigned char *data, unsigned char digest[32]) {
+  struct haraka_lane lane;
+  unsigned char h[32];
+  haraka_lane_init(&lane, h, size, data);
+
+  /* The full blocks if any, then the tail */
+  while (lane.nblocks) {
+    ctx->haraka_vtable->chain(ctx->rc, 1, h, lane.nblocks, &lane.next);
+    haraka_lane_advance(&lane, lane.nblocks);
+  }
+
+  memcpy(digest, h, 32);
+}
+
+void aes_haraka_hash_multi(AesHarakaContext *ctx, size_t nmessages,
+                           const AesHarakaMessage *messages) {
+  for (size_t i = 0; i < nmessages; i += AES_HARAKA_LANES) {
+    size_t nlanes = nmessages - i < AES_HARAKA_LANES ? nmessages - i
+                                                      : AES_HARAKA_LANES;
+    haraka_hash_lanes(ctx, nlanes, &messages[i]);
+  }
+}
+
+void aes_haraka_stream_start(AesHarakaStreamContext *ctx) {
+  memset(ctx->h, 0, 32);
+  ctx->buffered = 0;
+  ctx->size = 0;
+}
+
+void aes_haraka_stream_init(AesHarakaStreamContext *ctx,
+                            const unsigned char key[16]) {
+  aes_haraka_init(&ctx->haraka, key);
+  aes_haraka_stream_start(ctx);
+}
+
+static void haraka_stream_blocks(AesHarakaStreamContext *ctx, size_t nblocks,
+                                 const unsigned char *blocks) {
+  ctx->haraka.haraka_vtable->chain(ctx->haraka.rc, 1, ctx->h, nblocks,
+                                   &blocks);
+}
+
+void aes_haraka_stream_update(AesHarakaStreamContext *ctx, size_t size,
+                              const unsigned char *data) {
+  if (!size)
+    return;
+
+  ctx->size += size;
+  if (ctx->buffered) {
+    size_t part = 32 - ctx->buffered;
+    if (part > size)
+      part = size;
+
+    memcpy(&ctx->buffer[ctx->buffered], data, part);
+    ctx->buffered += part;
+    data += part;
+    size -= part;
+    if (ctx->buffered < 32)
+      return;
+
+    haraka_stream_blocks(ctx, 1, ctx->buffer);
+    ctx->buffered = 0;
+  }
+
+  if (size / 32)
+    haraka_stream_blocks(ctx, size / 32, data);
+
+  ctx->buffered = size % 32;
+  if (ctx->buffered)
+    memcpy(ctx->buffer, &data[size - ctx->buffered], ctx->buffered);
+}
+
+void aes_haraka_stream_final(AesHarakaStreamContext *ctx,
+                             unsigned char digest[32]) {
+  unsigned char tail[64];
+  size_t ntail = haraka_tail(tail, ctx->buffered, ctx->buffer, ctx->size);
+
+  haraka_stream_blocks(ctx, ntail, tail);
+  memcpy(digest, ctx->h, 32);
+
+  memset(ctx->buffer, 0, 32);
+  ctx->buffered = 0;
+}
@@ -0,0 +1,129 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/*
+ * HCTR2 (Crowley, Huckleberry & Biggers): a string M || N, with M its first
+ * block, is encrypted to U || V with
+ *   MM = M ^ H(T, N), UU = E(K, MM), S = MM ^ UU ^ L,
+ *   V = N ^ XCTR(S), U = UU ^ H(T, V),
+ * H being POLYVAL over a length block, the tweak T & the string. Decryption
+ * is the same with E^-1, so both directions share hctr2_crypt(). The POLYVAL
+ * state after the tweak is computed once per call & used by both hashes.
+ */
+
+/* Strings are mostly short, so their last blocks are padded in a buffer of
+ * this size & absorbed by a single call to the kernel, i.e. with a single
+ * reduction. */
+#define HCTR2_BUFFER_SIZE 128
+
+/* Absorbs `size` bytes of data into s; a partial last block is followed by
+ * `pad` then zeros. */
+static void hctr2_polyval_padded(const AesHctr2Context *ctx,
+                                 unsigned char s[16], size_t size,
+                                 const unsigned char *data, unsigned char pad) {
+  if (!(size % 16)) {
+    if (size)
+      ctx->hctr2_vtable->polyval(ctx->h_table, s, size, data);
+    return;
+  }
+
+  size_t direct_size = size - size % HCTR2_BUFFER_SIZE;
+  size_t rest = size % HCTR2_BUFFER_SIZE;
+  unsigned char buffer[HCTR2_BUFFER_SIZE] = {0};
+
+  if (direct_size)
+    ctx->hctr2_vtable->polyval(ctx->h_table, s, direct_size, data);
+
+  memcpy(buffer, &data[direct_size], rest);
+  buffer[rest] = pad;
+  ctx->hctr2_vtable->polyval(ctx->h_table, s, rest - rest % 16 + 16, buffer);
+}
+
+/* POLYVAL of LE128(16 * tweaksize + 2 or 3) & the zero-padded tweak; the
+ * length block ends in 3 if the string is not a whole number of blocks. */
+static void hctr2_hash_tweak(const AesHctr2Context *ctx, size_t textsize,
+                             size_t tweaksize, const unsigned char *tweak,
+                             unsigned char s[16]) {
+  unsigned char buffer[HCTR2_BUFFER_SIZE] = {0};
+  uint64_t length = (uint64_t)tweaksize * 16 + (textsize % 16 ? 3 : 2);
+  for (size_t i = 0; i < 8; ++i)
+    buffer[i] = (unsigned char)(length >> (8 * i));
+
+  memset(s, 0, 16);
+  if (tweaksize <= sizeof buffer - 16) {
+    if (tweaksize)
+      memcpy(&buffer[16], tweak, tweaksize);
+    ctx->hctr2_vtable->polyval(ctx->h_table, s, 16 + (tweaksize + 15) / 16 * 16,
+                               buffer);
+  } else {
+    ctx->hctr2_vtable->polyval(ctx->h_table, s, 16, buffer);
+    hctr2_polyval_padded(ctx, s, tweaksize, tweak, 0x00);
+  }
+}
+
+void aes_hctr2_init_keys(AesHctr2Context *ctx) {
+  unsigned char blocks[32] = {0};
+
+  /* h = E(K, LE128(0)) & L = E(K, LE128(1)) */
+  blocks[16] = 1;
+  ctx->aes.vtable->ecb_encrypt(&ctx->aes, sizeof blocks, blocks, blocks);
+  ctx->hctr2_vtable->polyval_init(ctx->h_table, blocks);
+  memcpy(ctx->l, &blocks[16], 16);
+}
+
+static void hctr2_crypt(AesHctr2Context *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        size_t tweaksize, const unsigned char *tweak,
+                        bool encrypt) {
+  size_t tailsize = textsize - 16;
+  unsigned char tweak_hash[16], hash[16], mm[16], uu[16], s[16];
+
+  hctr2_hash_tweak(ctx, textsize, tweaksize, tweak, tweak_hash);
+
+  memcpy(hash, tweak_hash, 16);
+  hctr2_polyval_padded(ctx, hash, tailsize, &in[16], 0x01);
+  for (size_t i = 0; i < 16; ++i)
+    mm[i] = in[i] ^ hash[i];
+
+  if (encrypt)
+    ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, uu, mm);
+  else
+    ctx->aes.vtable->ecb_decrypt(&ctx->aes, 16, uu, mm);
+
+  for (size_t i = 0; i < 16; ++i)
+    s[i] = mm[i] ^ uu[i] ^ ctx->l[i];
+  ctx->hctr2_vtable->xctr_xcrypt(&ctx->aes, tailsize, &out[16], &in[16], s);
+
+  memcpy(hash, tweak_hash, 16);
+  hctr2_polyval_padded(ctx, hash, tailsize, &out[16], 0x01);
+  for (size_t i = 0; i < 16; ++i)
+    out[i] = uu[i] ^ hash[i];
+}
+
+int aes_hctr2_encrypt(AesHctr2Context *ctx, size_t textsize,
+                      unsigned char *cipher_text,
+                      const unsigned char *plain_text, size_t tweaksize,
+                      const unsigned char *tweak) {
+  /* The first block is the one encrypted by the block cipher. */
+  if (textsize < 16)
+    return -1;
+
+  hctr2_crypt(ctx, textsize, cipher_text, plain_text, tweaksize, tweak, true);
+  return 0;
+}
+
+int aes_hctr2_decrypt(AesHctr2Context *ctx, size_t textsize,
+                      unsigned char *plain_text,
+                      const unsigned char *cipher_text, size_t tweaksize,
+                      const unsigned char *tweak) {
+  if (textsize < 16)
+    return -1;
+
+  hctr2_crypt(ctx, textsize, plain_text, cipher_text, tweaksize, tweak, false);
+  return 0;
+}
@@ -0,0 +1,244 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* Default initial value of RFC 3394, section 2.2.3.1 */
+static const unsigned char kw_iv[8] = {0xa6, 0xa6, 0xa6, 0xa6,
+                                       0xa6, 0xa6, 0xa6, 0xa6};
+/* First half of the alternative initial value of RFC 5649, section 3 */
+static const unsigned char kwp_aiv[4] = {0xa6, 0x59, 0x59, 0xa6};
+
+struct kw_mode {
+  bool wrap;
+  bool padded;
+};
+
+/* Checks the integrity check register & padding left by W^-1 without
+ * branching on them; stores the size of the key in *outsize. */
+static int kw_check(const struct kw_mode *mode, const unsigned char a[8],
+                    const unsigned char *r, size_t n, size_t *outsize) {
+  if (!mode->padded) {
+    int result = aes_ct_memcmp(a, kw_iv, 8);
+    *outsize = result ? 0 : n * 8;
+    return result;
+  }
+
+  uint32_t mli = (uint32_t)a[4] << 24 | (uint32_t)a[5] << 16 |
+                 (uint32_t)a[6] << 8 | a[7];
+  uint64_t size = (uint64_t)n * 8;
+
+  /* Valid if 8 * (n - 1) < mli <= 8 * n & the padding is zero. */
+  unsigned char bad = (unsigned char)-aes_ct_memcmp(a, kwp_aiv, 4);
+  bad |= (unsigned char)(((size - 8 - mli) >> 63) ^ 1);
+  bad |= (unsigned char)((size - mli) >> 63);
+  for (size_t i = 0; i < 8; ++i) {
+    uint64_t pos = size - 8 + i;
+    /* All ones if pos >= mli */
+    unsigned char mask = (unsigned char)(((pos - mli) >> 63) - 1);
+    bad |= r[size - 8 + i] & mask;
+  }
+
+  *outsize = bad ? 0 : mli;
+  return -(int)((bad + 0xffu) >> 8);
+}
+
+/*
+ * Sets up a lane for an item; returns 1 if it is ready to go through the
+ * kernels, or the result of the item if it was handled here (invalid size, or
+ * the single block case of KWP).
+ */
+static int kw_start(AesKwContext *ctx, const struct kw_mode *mode,
+                    AesKwItem *item, struct aes_kw_lane *lane) {
+  size_t insize = item->insize;
+  item->outsize = 0;
+
+  if (mode->wrap) {
+    size_t padded_size = (insize + 7) / 8 * 8;
+    if (mode->padded ? insize == 0 || (uint64_t)insize > UINT32_MAX
+                     : insize < 16 || insize % 8 != 0)
+      return -1;
+
+    if (mode->padded) {
+      memcpy(lane->a, kwp_aiv, 4);
+      for (size_t i = 0; i < 4; ++i)
+        lane->a[4 + i] = (unsigned char)((uint64_t)insize >> (24 - 8 * i));
+    } else {
+      memcpy(lane->a, kw_iv, 8);
+    }
+
+    /* R lives in the output, which may overlap the input. */
+    memmove(&item->out[8], item->in, insize);
+    memset(&item->out[8 + insize], 0, padded_size - insize);
+    item->outsize = padded_size + 8;
+
+    /* KWP encrypts a single padded block directly (RFC 5649, section 4.1). */
+    if (padded_size == 8) {
+      memcpy(item->out, lane->a, 8);
+      ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, item->out, item->out);
+      return 0;
+    }
+
+    lane->r = &item->out[8];
+    lane->n = padded_size / 8;
+    lane->i = 0;
+    lane->t = 1;
+    return 1;
+  }
+
+  if (insize % 8 != 0 || insize < (mode->padded ? 16u : 24u))
+    return -1;
+
+  if (insize == 16) {
+    unsigned char block[16];
+    size_t outsize;
+    ctx->aes.vtable->ecb_decrypt(&ctx->aes, 16, block, item->in);
+
+    int result = kw_check(mode, block, &block[8], 1, &outsize);
+    memcpy(item->out, &block[8], 8);
+    if (result)
+      memset(item->out, 0, 8);
+    item->outsize = outsize;
+    return result;
+  }
+
+  memcpy(lane->a, item->in, 8);
+  memmove(item->out, &item->in[8], insize - 8);
+  lane->r = item->out;
+  lane->n = insize / 8 - 1;
+  lane->i = lane->n - 1;
+  lane->t = 6 * (uint64_t)lane->n;
+  return 1;
+}
+
+static int kw_finish(const struct kw_mode *mode, AesKwItem *item,
+                     const struct aes_kw_lane *lane) {
+  if (mode->wrap) {
+    memcpy(item->out, lane->a, 8);
+    return 0;
+  }
+
+  size_t outsize;
+  int result = kw_check(mode, lane->a, lane->r, lane->n, &outsize);
+  if (result)
+    memset(item->out, 0, lane->n * 8);
+  item->outsize = outsize;
+  return result;
+}
+
+/*
+ * Runs W or W^-1 over up to AES_KW_LANES items at a time. Each kernel call
+ * advances all lanes by as many steps as the lane closest to completion has
+ * left; finished lanes are refilled with the next pending items.
+ */
+static int kw_multi(AesKwContext *ctx, const struct kw_mode *mode,
+                    size_t nitems, AesKwItem *items, int *results) {
+  struct aes_kw_lane lanes[AES_KW_LANES];
+  size_t lane_items[AES_KW_LANES];
+  uint64_t remaining[AES_KW_LANES];
+  size_t nlanes = 0, next_item = 0;
+  int ret = 0;
+
+  for (;;) {
+    while (nlanes < AES_KW_LANES && next_item < nitems) {
+      size_t index = next_item++;
+      int result = kw_start(ctx, mode, &items[index], &lanes[nlanes]);
+      if (result > 0) {
+        lane_items[nlanes] = index;
+        remaining[nlanes] = 6 * (uint64_t)lanes[nlanes].n;
+        ++nlanes;
+        continue;
+      }
+
+      if (results)
+        results[index] = result;
+      ret |= result;
+    }
+
+    if (!nlanes)
+      return ret;
+
+    uint64_t nsteps = UINT64_MAX;
+    for (size_t j = 0; j < nlanes; ++j) {
+      if (remaining[j] < nsteps)
+        nsteps = remaining[j];
+    }
+
+    if (mode->wrap)
+      ctx->kw_vtable->wrap_lanes(&ctx->aes, nlanes, lanes, (size_t)nsteps);
+    else
+      ctx->kw_vtable->unwrap_lanes(&ctx->aes, nlanes, lanes, (size_t)nsteps);
+
+    for (size_t j = 0; j < nlanes;) {
+      remaining[j] -= nsteps;
+      if (remaining[j]) {
+        ++j;
+        continue;
+      }
+
+      size_t index = lane_items[j];
+      int result = kw_finish(mode, &items[index], &lanes[j]);
+      if (results)
+        results[index] = result;
+      ret |= result;
+
+      --nlanes;
+      lanes[j] = lanes[nlanes];
+      lane_items[j] = lane_items[nlanes];
+      remaining[j] = remaining[nlanes];
+    }
+  }
+}
+
+int aes_kw_wrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                      int *results) {
+  const struct kw_mode mode = {.wrap = true, .padded = false};
+  return kw_multi(ctx, &mode, nitems, items, results);
+}
+
+int aes_kw_unwrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                        int *results) {
+  const struct kw_mode mode = {.wrap = false, .padded = false};
+  return kw_multi(ctx, &mode, nitems, items, results);
+}
+
+int aes_kwp_wrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                       int *results) {
+  const struct kw_mode mode = {.wrap = true, .padded = true};
+  return kw_multi(ctx, &mode, nitems, items, results);
+}
+
+int aes_kwp_unwrap_multi(AesKwContext *ctx, size_t nitems, AesKwItem *items,
+                         int *results) {
+  const struct kw_mode mode = {.wrap = false, .padded = true};
+  return kw_multi(ctx, &mode, nitems, items, results);
+}
+
+int aes_kw_wrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                const unsigned char *in) {
+  AesKwItem item = {.insize = insize, .in = in, .out = out};
+  return aes_kw_wrap_multi(ctx, 1, &item, NULL);
+}
+
+int aes_kw_unwrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                  const unsigned char *in) {
+  AesKwItem item = {.insize = insize, .in = in, .out = out};
+  return aes_kw_unwrap_multi(ctx, 1, &item, NULL);
+}
+
+int aes_kwp_wrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                 const unsigned char *in) {
+  AesKwItem item = {.insize = insize, .in = in, .out = out};
+  return aes_kwp_wrap_multi(ctx, 1, &item, NULL);
+}
+
+int aes_kwp_unwrap(AesKwContext *ctx, size_t insize, unsigned char *out,
+                   size_t *outsize, const unsigned char *in) {
+  AesKwItem item = {.insize = insize, .in = in, .out = out};
+  int result = aes_kwp_unwrap_multi(ctx, 1, &item, NULL);
+  *outsize = item.outsize;
+  return result;
+}
@@ -0,0 +1,328 @@
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "inner.h"
+
+/*
+ * AEGIS-128L & AEGIS-256 kernels. The state update is one AESENC per state
+ * block, all independent of each other, so a message is bound by the latency
+ * of a single AESENC per update; the state stays in registers from the
+ * initialization to the tag.
+ */
+
+static const unsigned char aegis_c0[16] = {0x00, 0x01, 0x01, 0x02, 0x03, 0x05,
+                                           0x08, 0x0d, 0x15, 0x22, 0x37, 0x59,
+                                           0x90, 0xe9, 0x79, 0x62};
+static const unsigned char aegis_c1[16] = {0xdb, 0x3d, 0x18, 0x55, 0x6d, 0xc2,
+                                           0x2f, 0xf1, 0x20, 0x11, 0x31, 0x42,
+                                           0x73, 0xb5, 0x28, 0xdd};
+
+/* LE64(adsize * 8) || LE64(textsize * 8) */
+static inline __m128i aegis_lengths(size_t aadsize, size_t textsize) {
+  return _mm_set_epi64x((long long)((uint64_t)textsize * 8),
+                        (long long)((uint64_t)aadsize * 8));
+}
+
+struct aegis128l_state {
+  __m128i s[8];
+};
+
+static inline void aegis128l_update(struct aegis128l_state *st, __m128i m0,
+                                    __m128i m1) {
+  __m128i *s = st->s;
+  __m128i s7 = s[7];
+
+  s[7] = _mm_aesenc_si128(s[6], s[7]);
+  s[6] = _mm_aesenc_si128(s[5], s[6]);
+  s[5] = _mm_aesenc_si128(s[4], s[5]);
+  s[4] = _mm_aesenc_si128(s[3], _mm_xor_si128(s[4], m1));
+  s[3] = _mm_aesenc_si128(s[2], s[3]);
+  s[2] = _mm_aesenc_si128(s[1], s[2]);
+  s[1] = _mm_aesenc_si128(s[0], s[1]);
+  s[0] = _mm_aesenc_si128(s7, _mm_xor_si128(s[0], m0));
+}
+
+static inline void aegis128l_keystream(const struct aegis128l_state *st,
+                                       __m128i *z0, __m128i *z1) {
+  const __m128i *s = st->s;
+  *z0 = _mm_xor_si128(_mm_xor_si128(s[6], s[1]), _mm_and_si128(s[2], s[3]));
+  *z1 = _mm_xor_si128(_mm_xor_si128(s[2], s[5]), _mm_and_si128(s[6], s[7]));
+}
+
+static inline void aegis128l_start(struct aegis128l_state *st,
+                                   const unsigned char key[16],
+                                   const unsigned char nonce[16],
+                                   size_t aadsize, const unsigned char *aad) {
+  __m128i k = _mm_loadu_si128((const __m128i *)key);
+  __m128i n = _mm_loadu_si128((const __m128i *)nonce);
+  __m128i c0 = _mm_loadu_si128((const __m128i *)aegis_c0);
+  __m128i c1 = _mm_loadu_si128((const __m128i *)aegis_c1);
+
+  st->s[0] = _mm_xor_si128(k, n);
+  st->s[1] = c1;
+  st->s[2] = c0;
+  st->s[3] = c1;
+  st->s[4] = _mm_xor_si128(k, n);
+  st->s[5] = _mm_xor_si128(k, c0);
+  st->s[6] = _mm_xor_si128(k, c1);
+  st->s[7] = _mm_xor_si128(k, c0);
+  for (size_t i = 0; i < 10; ++i)
+    aegis128l_update(st, n, k);
+
+  size_t i = 0;
+  for (; i + 32 <= aadsize; i += 32)
+    aegis128l_update(st, _mm_loadu_si128((const __m128i *)&aad[i]),
+                     _mm_loadu_si128((const __m128i *)&aad[i + 16]));
+
+  if (i < aadsize) {
+    __m128i pad[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+    memcpy(pad, &aad[i], aadsize - i);
+    aegis128l_update(st, pad[0], pad[1]);
+  }
+}
+
+static inline void aegis128l_finish(struct aegis128l_state *st,
+                                    size_t aadsize, size_t textsize,
+                                    size_t tagsize, unsigned char *tag) {
+  const __m128i *s = st->s;
+  __m128i t = _mm_xor_si128(s[2], aegis_lengths(aadsize, textsize));
+  for (size_t i = 0; i < 7; ++i)
+    aegis128l_update(st, t, t);
+
+  __m128i t0 = _mm_xor_si128(_mm_xor_si128(s[0], s[1]),
+                             _mm_xor_si128(s[2], s[3]));
+  __m128i t1 = _mm_xor_si128(_mm_xor_si128(s[4], s[5]), s[6]);
+  if (tagsize == 32) {
+    _mm_storeu_si128((__m128i *)tag, t0);
+    _mm_storeu_si128((__m128i *)&tag[16], _mm_xor_si128(t1, s[7]));
+  } else {
+    _mm_storeu_si128((__m128i *)tag, _mm_xor_si128(t0, t1));
+  }
+}
+
+struct aegis256_state {
+  __m128i s[6];
+};
+
+static inline void aegis256_update(struct aegis256_state *st, __m128i m) {
+  __m128i *s = st->s;
+  __m128i s5 = s[5];
+
+  s[5] = _mm_aesenc_si128(s[4], s[5]);
+  s[4] = _mm_aesenc_si128(s[3], s[4]);
+  s[3] = _mm_aesenc_si128(s[2], s[3]);
+  s[2] = _mm_aesenc_si128(s[1], s[2]);
+  s[1] = _mm_aesenc_si128(s[0], s[1]);
+  s[0] = _mm_aesenc_si128(s5, _mm_xor_si128(s[0], m));
+}
+
+static inline __m128i aegis256_keystream(const struct aegis256_state *st) {
+  const __m128i *s = st->s;
+  return _mm_xor_si128(_mm_xor_si128(s[1], s[4]),
+                       _mm_xor_si128(s[5], _mm_and_si128(s[2], s[3])));
+}
+
+static inline void aegis256_start(struct aegis256_state *st,
+                                  const unsigned char key[32],
+                                  const unsigned char nonce[32],
+                                  size_t aadsize, const unsigned char *aad) {
+  __m128i k0 = _mm_loadu_si128((const __m128i *)key);
+  __m128i k1 = _mm_loadu_si128((const __m128i *)&key[16]);
+  __m128i n0 = _mm_xor_si128(k0, _mm_loadu_si128((const __m128i *)nonce));
+  __m128i n1 = _mm_xor_si128(k1, _mm_loadu_si128((const __m128i *)&nonce[16]));
+  __m128i c0 = _mm_loadu_si128((const __m128i *)aegis_c0);
+  __m128i c1 = _mm_loadu_si128((const __m128i *)aegis_c1);
+
+  /* n0 & n1 hold the key XORed with the nonce. */
+  st->s[0] = n0;
+  st->s[1] = n1;
+  st->s[2] = c1;
+  st->s[3] = c0;
+  st->s[4] = _mm_xor_si128(k0, c0);
+  st->s[5] = _mm_xor_si128(k1, c1);
+  for (size_t i = 0; i < 4; ++i) {
+    aegis256_update(st, k0);
+    aegis256_update(st, k1);
+    aegis256_update(st, n0);
+    aegis256_update(st, n1);
+  }
+
+  size_t i = 0;
+  for (; i + 16 <= aadsize; i += 16)
+    aegis256_update(st, _mm_loadu_si128((const __m128i *)&aad[i]));
+
+  if (i < aadsize) {
+    __m128i pad = _mm_setzero_si128();
+    memcpy(&pad, &aad[i], aadsize - i);
+    aegis256_update(st, pad);
+  }
+}
+
+static inline void aegis256_finish(struct aegis256_state *st,
+                                   size_t aadsize, size_t textsize,
+                                   size_t tagsize, unsigned char *tag) {
+  const __m128i *s = st->s;
+  __m128i t = _mm_xor_si128(s[3], aegis_lengths(aadsize, textsize));
+  for (size_t i = 0; i < 7; ++i)
+    aegis256_update(st, t);
+
+  __m128i t0 = _mm_xor_si128(_mm_xor_si128(s[0], s[1]), s[2]);
+  __m128i t1 = _mm_xor_si128(_mm_xor_si128(s[3], s[4]), s[5]);
+  if (tagsize == 32) {
+    _mm_storeu_si128((__m128i *)tag, t0);
+    _mm_storeu_si128((__m128i *)&tag[16], t1);
+  } else {
+    _mm_storeu_si128((__m128i *)tag, _mm_xor_si128(t0, t1));
+  }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_aegis128l_encrypt(const unsigned char key[16],
+                             const unsigned char nonce[16], size_t aadsize,
+                             const unsigned char *aad, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             size_t tagsize, unsigned char *tag) {
+  struct aegis128l_state st;
+  aegis128l_start(&st, key, nonce, aadsize, aad);
+
+  size_t i = 0;
+  for (; i + 32 <= textsize; i += 32) {
+    __m128i z0, z1;
+    __m128i m0 = _mm_loadu_si128((const __m128i *)&in[i]);
+    __m128i m1 = _mm_loadu_si128((const __m128i *)&in[i + 16]);
+
+    aegis128l_keystream(&st, &z0, &z1);
+    aegis128l_update(&st, m0, m1);
+    _mm_storeu_si128((__m128i *)&out[i], _mm_xor_si128(m0, z0));
+    _mm_storeu_si128((__m128i *)&out[i + 16], _mm_xor_si128(m1, z1));
+  }
+
+  if (i < textsize) {
+    __m128i z0, z1;
+    __m128i pad[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+    memcpy(pad, &in[i], textsize - i);
+
+    aegis128l_keystream(&st, &z0, &z1);
+    aegis128l_update(&st, pad[0], pad[1]);
+    pad[0] = _mm_xor_si128(pad[0], z0);
+    pad[1] = _mm_xor_si128(pad[1], z1);
+    memcpy(&out[i], pad, textsize - i);
+  }
+
+  aegis128l_finish(&st, aadsize, textsize, tagsize, tag);
+}
+
+void aesni_aegis128l_decrypt(const unsigned char key[16],
+                             const unsigned char nonce[16], size_t aadsize,
+                             const unsigned char *aad, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             size_t tagsize, unsigned char *tag) {
+  struct aegis128l_state st;
+  aegis128l_start(&st, key, nonce, aadsize, aad);
+
+  size_t i = 0;
+  for (; i + 32 <= textsize; i += 32) {
+    __m128i z0, z1;
+    aegis128l_keystream(&st, &z0, &z1);
+
+    __m128i m0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&in[i]), z0);
+    __m128i m1 =
+        _mm_xor_si128(_mm_loadu_si128((const __m128i *)&in[i + 16]), z1);
+    aegis128l_update(&st, m0, m1);
+    _mm_storeu_si128((__m128i *)&out[i], m0);
+    _mm_storeu_si128((__m128i *)&out[i + 16], m1);
+  }
+
+  if (i < textsize) {
+    __m128i z0, z1;
+    __m128i pad[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+    memcpy(pad, &in[i], textsize - i);
+
+    aegis128l_keystream(&st, &z0, &z1);
+    pad[0] = _mm_xor_si128(pad[0], z0);
+    pad[1] = _mm_xor_si128(pad[1], z1);
+    memcpy(&out[i], pad, textsize - i);
+
+    /* The update absorbs the plain text zero-padded, not the key stream past
+     * its end. */
+    pad[0] = pad[1] = _mm_setzero_si128();
+    memcpy(pad, &out[i], textsize - i);
+    aegis128l_update(&st, pad[0], pad[1]);
+  }
+
+  aegis128l_finish(&st, aadsize, textsize, tagsize, tag);
+}
+
+void aesni_aegis256_encrypt(const unsigned char key[32],
+                            const unsigned char nonce[32], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag) {
+  struct aegis256_state st;
+  aegis256_start(&st, key, nonce, aadsize, aad);
+
+  size_t i = 0;
+  for (; i + 16 <= textsize; i += 16) {
+    __m128i m = _mm_loadu_si128((const __m128i *)&in[i]);
+    __m128i z = aegis256_keystream(&st);
+
+    aegis256_update(&st, m);
+    _mm_storeu_si128((__m128i *)&out[i], _mm_xor_si128(m, z));
+  }
+
+  if (i < textsize) {
+    __m128i pad = _mm_setzero_si128();
+    memcpy(&pad, &in[i], textsize - i);
+
+    __m128i z = aegis256_keystream(&st);
+    aegis256_update(&st, pad);
+    pad = _mm_xor_si128(pad, z);
+    memcpy(&out[i], &pad, textsize - i);
+  }
+
+  aegis256_finish(&st, aadsize, textsize, tagsize, tag);
+}
+
+void aesni_aegis256_decrypt(const unsigned char key[32],
+                            const unsigned char nonce[32], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag) {
+  struct aegis256_state st;
+  aegis256_start(&st, key, nonce, aadsize, aad);
+
+  size_t i = 0;
+  for (; i + 16 <= textsize; i += 16) {
+    __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&in[i]),
+                              aegis256_keystream(&st));
+    aegis256_update(&st, m);
+    _mm_storeu_si128((__m128i *)&out[i], m);
+  }
+
+  if (i < textsize) {
+    __m128i pad = _mm_setzero_si128();
+    memcpy(&pad, &in[i], textsize - i);
+
+    pad = _mm_xor_si128(pad, aegis256_keystream(&st));
+    memcpy(&out[i], &pad, textsize - i);
+
+    /* As for AEGIS-128L, the update absorbs the zero-padded plain text. */
+    pad = _mm_setzero_si128();
+    memcpy(&pad, &out[i], textsize - i);
+    aegis256_update(&st, pad);
+  }
+
+  aegis256_finish(&st, aadsize, textsize, tagsize, tag);
+}
+
+#ifdef __cplusplus
+}
+#endif
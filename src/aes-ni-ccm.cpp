@@ -0,0 +1,222 @@
+#include <emmintrin.h>
+#include <string.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+#define CCM_CTR_INTERLEAVE 8
+
+/*
+ * AES-CCM kernels. The CBC-MAC of one message is a serial chain, so a single
+ * chain only issues one AESENC per round. The counter block of the same
+ * position goes through the cipher next to it, in the slot the chain leaves
+ * free; the mode then costs about one AES latency per block, as CBC-MAC alone
+ * does. Independent messages fill the remaining slots via cbc_mac_lanes().
+ */
+
+static inline __m128i ccm_counter_block(__m128i ctr) {
+  return m128i_bswap(ctr);
+}
+
+static inline __m128i ccm_next_counter(__m128i ctr) {
+  return _mm_add_epi64(ctr, _mm_set_epi64x(0, 1));
+}
+
+template <size_t N>
+static void ccm_cbc_mac_lanes(unsigned char Nr, const __m128i *enc_ks,
+                              size_t nblocks, const unsigned char *const *in,
+                              unsigned char *macs) {
+  __m128i chains[N];
+  for (size_t j = 0; j < N; ++j)
+    chains[j] = _mm_loadu_si128((const __m128i *)&macs[j * 16]);
+
+  for (size_t i = 0; i < nblocks; ++i) {
+    for (size_t j = 0; j < N; ++j)
+      chains[j] = _mm_xor_si128(
+          chains[j], _mm_loadu_si128((const __m128i *)&in[j][i * 16]));
+
+    aes_encrypt_blocks<N>(Nr, enc_ks, chains);
+  }
+
+  for (size_t j = 0; j < N; ++j)
+    _mm_storeu_si128((__m128i *)&macs[j * 16], chains[j]);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_ccm_cbc_mac_lanes(const AesContext *ctx, size_t nlanes,
+                             size_t nblocks, const unsigned char *const *in,
+                             unsigned char *macs) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  switch (nlanes) {
+  case 1:
+    ccm_cbc_mac_lanes<1>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 2:
+    ccm_cbc_mac_lanes<2>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 3:
+    ccm_cbc_mac_lanes<3>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 4:
+    ccm_cbc_mac_lanes<4>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 5:
+    ccm_cbc_mac_lanes<5>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 6:
+    ccm_cbc_mac_lanes<6>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 7:
+    ccm_cbc_mac_lanes<7>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  case 8:
+    ccm_cbc_mac_lanes<8>(Nr, enc_ks, nblocks, in, macs);
+    break;
+  }
+}
+
+void aesni_ccm_encrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+  __m128i chain = _mm_loadu_si128((const __m128i *)mac);
+  size_t nblocks = textsize / 16;
+
+  for (size_t i = 0; i < nblocks; ++i) {
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    __m128i blocks[2] = {_mm_xor_si128(chain, in_block),
+                         ccm_counter_block(ctr)};
+    ctr = ccm_next_counter(ctr);
+
+    aes_encrypt_blocks<2>(Nr, enc_ks, blocks);
+
+    chain = blocks[0];
+    _mm_storeu_si128((__m128i *)&out[i * 16],
+                     _mm_xor_si128(blocks[1], in_block));
+  }
+
+  if (textsize % 16) {
+    __m128i in_block = _mm_setzero_si128();
+    memcpy(&in_block, &in[nblocks * 16], textsize % 16);
+    __m128i blocks[2] = {_mm_xor_si128(chain, in_block),
+                         ccm_counter_block(ctr)};
+
+    aes_encrypt_blocks<2>(Nr, enc_ks, blocks);
+
+    chain = blocks[0];
+    __m128i out_block = _mm_xor_si128(blocks[1], in_block);
+    memcpy(&out[nblocks * 16], &out_block, textsize % 16);
+  }
+
+  _mm_storeu_si128((__m128i *)mac, chain);
+}
+
+void aesni_ccm_decrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  if (!textsize)
+    return;
+
+  /* The plain text of a block is needed before it can be MACed, so the key
+   * stream is computed one block ahead of the chain. */
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+  __m128i chain = _mm_loadu_si128((const __m128i *)mac);
+  __m128i stream_block = aes_encrypt_block(Nr, enc_ks, ccm_counter_block(ctr));
+  ctr = ccm_next_counter(ctr);
+
+  size_t nblocks = textsize / 16;
+  for (size_t i = 0; i < nblocks; ++i) {
+    __m128i plain_block = _mm_xor_si128(
+        stream_block, _mm_loadu_si128((const __m128i *)&in[i * 16]));
+    _mm_storeu_si128((__m128i *)&out[i * 16], plain_block);
+
+    __m128i blocks[2] = {_mm_xor_si128(chain, plain_block),
+                         ccm_counter_block(ctr)};
+    ctr = ccm_next_counter(ctr);
+
+    aes_encrypt_blocks<2>(Nr, enc_ks, blocks);
+
+    chain = blocks[0];
+    stream_block = blocks[1];
+  }
+
+  if (textsize % 16) {
+    size_t tail = textsize % 16;
+    __m128i plain_block = _mm_setzero_si128();
+    memcpy(&plain_block, &in[nblocks * 16], tail);
+    plain_block = _mm_xor_si128(plain_block, stream_block);
+    memcpy(&out[nblocks * 16], &plain_block, tail);
+
+    /* Only the real bytes of the plain text are MACed. */
+    __m128i padded_block = _mm_setzero_si128();
+    memcpy(&padded_block, &plain_block, tail);
+    chain = aes_encrypt_block(Nr, enc_ks, _mm_xor_si128(chain, padded_block));
+  }
+
+  _mm_storeu_si128((__m128i *)mac, chain);
+}
+
+void aesni_ccm_ctr64_xcrypt(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            const unsigned char counter[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + CCM_CTR_INTERLEAVE <= nblocks; i += CCM_CTR_INTERLEAVE) {
+    __m128i blocks[CCM_CTR_INTERLEAVE];
+    for (size_t j = 0; j < CCM_CTR_INTERLEAVE; ++j) {
+      blocks[j] = ccm_counter_block(ctr);
+      ctr = ccm_next_counter(ctr);
+    }
+
+    aes_encrypt_blocks<CCM_CTR_INTERLEAVE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < CCM_CTR_INTERLEAVE; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16],
+                       _mm_xor_si128(blocks[j], in_block));
+    }
+  }
+
+  for (; i < nblocks; ++i) {
+    __m128i stream_block =
+        aes_encrypt_block(Nr, enc_ks, ccm_counter_block(ctr));
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    _mm_storeu_si128((__m128i *)&out[i * 16],
+                     _mm_xor_si128(stream_block, in_block));
+    ctr = ccm_next_counter(ctr);
+  }
+
+  if (textsize % 16) {
+    __m128i stream_block =
+        aes_encrypt_block(Nr, enc_ks, ccm_counter_block(ctr));
+    __m128i in_block = _mm_setzero_si128();
+    memcpy(&in_block, &in[nblocks * 16], textsize % 16);
+    __m128i out_block = _mm_xor_si128(stream_block, in_block);
+    memcpy(&out[nblocks * 16], &out_block, textsize % 16);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
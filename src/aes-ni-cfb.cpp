@@ -0,0 +1,143 @@
+#include <emmintrin.h>
+#include <string.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+#define CFB_INTERLEAVE 8
+
+/*
+ * AES-CFB kernels. Encryption feeds each cipher text block (or byte) back into
+ * the cipher, so it is serial. When decrypting, all of the cipher text, and so
+ * every input of the cipher, is known up front; CFB_INTERLEAVE blocks (CFB128)
+ * or shift register states (CFB8) go through the cipher together.
+ */
+
+/* Shifts the CFB8 register left by one byte & appends `byte`. */
+static inline __m128i cfb8_shift(__m128i reg, unsigned char byte) {
+  return _mm_or_si128(_mm_srli_si128(reg, 1),
+                      _mm_slli_si128(_mm_cvtsi32_si128(byte), 15));
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_cfb128_encrypt(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  __m128i reg = _mm_loadu_si128((const __m128i *)iv);
+
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    reg = _mm_xor_si128(aes_encrypt_block(Nr, enc_ks, reg),
+                        _mm_loadu_si128((const __m128i *)&in[i * 16]));
+    _mm_storeu_si128((__m128i *)&out[i * 16], reg);
+  }
+
+  _mm_storeu_si128((__m128i *)iv, reg);
+}
+
+void aesni_cfb128_decrypt(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  __m128i reg = _mm_loadu_si128((const __m128i *)iv);
+
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + CFB_INTERLEAVE <= nblocks; i += CFB_INTERLEAVE) {
+    __m128i cipher_blocks[CFB_INTERLEAVE], blocks[CFB_INTERLEAVE];
+    for (size_t j = 0; j < CFB_INTERLEAVE; ++j)
+      cipher_blocks[j] = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+
+    blocks[0] = reg;
+    for (size_t j = 1; j < CFB_INTERLEAVE; ++j)
+      blocks[j] = cipher_blocks[j - 1];
+
+    aes_encrypt_blocks<CFB_INTERLEAVE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < CFB_INTERLEAVE; ++j)
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16],
+                       _mm_xor_si128(blocks[j], cipher_blocks[j]));
+    reg = cipher_blocks[CFB_INTERLEAVE - 1];
+  }
+
+  for (; i < nblocks; ++i) {
+    __m128i cipher_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    _mm_storeu_si128(
+        (__m128i *)&out[i * 16],
+        _mm_xor_si128(aes_encrypt_block(Nr, enc_ks, reg), cipher_block));
+    reg = cipher_block;
+  }
+
+  _mm_storeu_si128((__m128i *)iv, reg);
+}
+
+void aesni_cfb8_encrypt(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  __m128i reg = _mm_loadu_si128((const __m128i *)iv);
+
+  for (size_t i = 0; i < textsize; ++i) {
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, reg);
+    unsigned char c =
+        (unsigned char)(in[i] ^ (unsigned char)_mm_cvtsi128_si32(stream_block));
+    out[i] = c;
+    reg = cfb8_shift(reg, c);
+  }
+
+  _mm_storeu_si128((__m128i *)iv, reg);
+}
+
+void aesni_cfb8_decrypt(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  /* The register, followed by the cipher text of the current iteration; the
+   * register of byte j is window[j..j + 16). Copying the cipher text here
+   * first also keeps it intact when out == in. */
+  unsigned char window[16 + CFB_INTERLEAVE];
+  memcpy(window, iv, 16);
+
+  size_t i = 0;
+  for (; i + CFB_INTERLEAVE <= textsize; i += CFB_INTERLEAVE) {
+    __m128i blocks[CFB_INTERLEAVE];
+    memcpy(&window[16], &in[i], CFB_INTERLEAVE);
+    for (size_t j = 0; j < CFB_INTERLEAVE; ++j)
+      blocks[j] = _mm_loadu_si128((const __m128i *)&window[j]);
+
+    aes_encrypt_blocks<CFB_INTERLEAVE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < CFB_INTERLEAVE; ++j)
+      out[i + j] = (unsigned char)(window[16 + j] ^
+                                   (unsigned char)_mm_cvtsi128_si32(blocks[j]));
+    memmove(window, &window[CFB_INTERLEAVE], 16);
+  }
+
+  __m128i reg = _mm_loadu_si128((const __m128i *)window);
+  for (; i < textsize; ++i) {
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, reg);
+    unsigned char c = in[i];
+    out[i] =
+        (unsigned char)(c ^ (unsigned char)_mm_cvtsi128_si32(stream_block));
+    reg = cfb8_shift(reg, c);
+  }
+
+  _mm_storeu_si128((__m128i *)iv, reg);
+}
+
+#ifdef __cplusplus
+}
+#endif
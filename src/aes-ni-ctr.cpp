@@ -0,0 +1,178 @@
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+#define CTR_INTERLEAVE 8
+
+/*
+ * CTR kernels. The counter is kept byte-reversed, so the big-endian counter
+ * in the last Width / 8 bytes of the IV is the low lane of the register & is
+ * advanced by a single PADDD or PADDQ, which wraps within the lane & leaves
+ * the rest of the IV untouched.
+ */
+
+template <unsigned Width> static inline __m128i ctr_add(__m128i ctr, int n);
+
+template <> inline __m128i ctr_add<32>(__m128i ctr, int n) {
+  return _mm_add_epi32(ctr, _mm_cvtsi32_si128(n));
+}
+
+template <> inline __m128i ctr_add<64>(__m128i ctr, int n) {
+  return _mm_add_epi64(ctr, _mm_cvtsi32_si128(n));
+}
+
+/* Encrypts or decrypts `nblocks` full blocks; returns the counter following
+ * the last one. */
+template <unsigned Width>
+static __m128i ctr_xcrypt_blocks(const AesContext *ctx, size_t nblocks,
+                                 unsigned char *out, const unsigned char *in,
+                                 __m128i ctr) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  size_t i = 0;
+
+  for (; i + CTR_INTERLEAVE <= nblocks; i += CTR_INTERLEAVE) {
+    __m128i blocks[CTR_INTERLEAVE];
+    for (size_t j = 0; j < CTR_INTERLEAVE; ++j)
+      blocks[j] = m128i_bswap(ctr_add<Width>(ctr, (int)j));
+    ctr = ctr_add<Width>(ctr, CTR_INTERLEAVE);
+
+    aes_encrypt_blocks<CTR_INTERLEAVE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < CTR_INTERLEAVE; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16],
+                       _mm_xor_si128(blocks[j], in_block));
+    }
+  }
+
+  for (; i < nblocks; ++i) {
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, m128i_bswap(ctr));
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    _mm_storeu_si128((__m128i *)&out[i * 16],
+                     _mm_xor_si128(stream_block, in_block));
+    ctr = ctr_add<Width>(ctr, 1);
+  }
+
+  return ctr;
+}
+
+/* The low 64 bits of a 128-bit counter wrap at most once per call, so the
+ * 64-bit kernel runs up to the wrap & the carry goes into the high half. */
+static __m128i ctr128_xcrypt_blocks(const AesContext *ctx, size_t nblocks,
+                                    unsigned char *out,
+                                    const unsigned char *in, __m128i ctr) {
+  uint64_t low;
+  _mm_storel_epi64((__m128i *)&low, ctr);
+
+  if (low && nblocks >= -low) {
+    size_t nfirst = (size_t)-low;
+    ctr = ctr_xcrypt_blocks<64>(ctx, nfirst, out, in, ctr);
+    ctr = _mm_add_epi64(ctr, _mm_set_epi64x(1, 0));
+
+    nblocks -= nfirst;
+    out += nfirst * 16;
+    in += nfirst * 16;
+  }
+
+  return ctr_xcrypt_blocks<64>(ctx, nblocks, out, in, ctr);
+}
+
+/* XCTR (the counter mode of HCTR2): block i (from 1) is encrypted from
+ * iv ^ LE128(i), so the index stays in its own register & is XORed in. */
+static inline __m128i xctr_block(__m128i iv, uint64_t index) {
+  return _mm_xor_si128(iv, _mm_cvtsi64_si128((long long)index));
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_ctr_width_xcrypt(AesContext *ctx, enum AesCtrWidth width,
+                            size_t textsize, unsigned char *out,
+                            const unsigned char *in, unsigned char next_iv[16],
+                            const unsigned char iv[16]) {
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)iv));
+  size_t nblocks = textsize / 16;
+
+  if (width == AES_CTR_WIDTH_32)
+    ctr = ctr_xcrypt_blocks<32>(ctx, nblocks, out, in, ctr);
+  else if (width == AES_CTR_WIDTH_64)
+    ctr = ctr_xcrypt_blocks<64>(ctx, nblocks, out, in, ctr);
+  else
+    ctr = ctr128_xcrypt_blocks(ctx, nblocks, out, in, ctr);
+
+  if (textsize % 16) {
+    __m128i stream_block = aes_encrypt_block(
+        ctx->Nr, (const __m128i *)ctx->enc_round_keys, m128i_bswap(ctr));
+    __m128i in_block = _mm_setzero_si128();
+    memcpy(&in_block, &in[nblocks * 16], textsize % 16);
+
+    __m128i out_block = _mm_xor_si128(stream_block, in_block);
+    memcpy(&out[nblocks * 16], &out_block, textsize % 16);
+  }
+
+  if (next_iv)
+    _mm_storeu_si128((__m128i *)next_iv, m128i_bswap(ctr));
+}
+
+void aesni_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
+                      const unsigned char *in, unsigned char next_iv[16],
+                      const unsigned char iv[16]) {
+  aesni_ctr_width_xcrypt(ctx, AES_CTR_WIDTH_128, textsize, out, in, next_iv,
+                         iv);
+}
+
+void aesni_xctr_xcrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  const __m128i iv_block = _mm_loadu_si128((const __m128i *)iv);
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + CTR_INTERLEAVE <= nblocks; i += CTR_INTERLEAVE) {
+    __m128i blocks[CTR_INTERLEAVE];
+    for (size_t j = 0; j < CTR_INTERLEAVE; ++j)
+      blocks[j] = xctr_block(iv_block, i + j + 1);
+
+    aes_encrypt_blocks<CTR_INTERLEAVE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < CTR_INTERLEAVE; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16],
+                       _mm_xor_si128(blocks[j], in_block));
+    }
+  }
+
+  for (; i < nblocks; ++i) {
+    __m128i stream_block =
+        aes_encrypt_block(Nr, enc_ks, xctr_block(iv_block, i + 1));
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    _mm_storeu_si128((__m128i *)&out[i * 16],
+                     _mm_xor_si128(stream_block, in_block));
+  }
+
+  if (textsize % 16) {
+    __m128i stream_block =
+        aes_encrypt_block(Nr, enc_ks, xctr_block(iv_block, nblocks + 1));
+    __m128i in_block = _mm_setzero_si128();
+    memcpy(&in_block, &in[nblocks * 16], textsize % 16);
+
+    __m128i out_block = _mm_xor_si128(stream_block, in_block);
+    memcpy(&out[nblocks * 16], &out_block, textsize % 16);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,111 @@
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+/*
+ * AES-EAX kernels. The OMAC of the cipher text is a serial chain; the counter
+ * block of the neighbouring position goes through the cipher next to it, so
+ * CTR & OMAC together cost about one AES latency per block. When encrypting,
+ * the key stream runs one block ahead of the chain, which MACs the cipher
+ * text it produced.
+ */
+
+/* The counter is kept byte-reversed; EAX increments all 128 bits of it. */
+static inline __m128i eax_next_counter(__m128i ctr) {
+  ctr = _mm_add_epi64(ctr, _mm_cvtsi32_si128(1));
+  if (!_mm_cvtsi128_si32(
+          _mm_or_si128(ctr, _mm_shuffle_epi32(ctr, _MM_SHUFFLE(1, 1, 1, 1)))))
+    ctr = _mm_add_epi64(ctr, _mm_set_epi64x(1, 0));
+  return ctr;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_eax_encrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  if (!textsize)
+    return;
+
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+  __m128i chain = _mm_loadu_si128((const __m128i *)mac);
+  __m128i stream_block = aes_encrypt_block(Nr, enc_ks, m128i_bswap(ctr));
+  ctr = eax_next_counter(ctr);
+
+  size_t nblocks = (textsize - 1) / 16;
+  for (size_t i = 0; i < nblocks; ++i) {
+    __m128i cipher_block = _mm_xor_si128(
+        stream_block, _mm_loadu_si128((const __m128i *)&in[i * 16]));
+    _mm_storeu_si128((__m128i *)&out[i * 16], cipher_block);
+
+    __m128i blocks[2] = {_mm_xor_si128(chain, cipher_block),
+                         m128i_bswap(ctr)};
+    ctr = eax_next_counter(ctr);
+
+    aes_encrypt_blocks<2>(Nr, enc_ks, blocks);
+
+    chain = blocks[0];
+    stream_block = blocks[1];
+  }
+
+  size_t tail = textsize - nblocks * 16;
+  __m128i in_block = _mm_setzero_si128();
+  memcpy(&in_block, &in[nblocks * 16], tail);
+  __m128i out_block = _mm_xor_si128(stream_block, in_block);
+  memcpy(&out[nblocks * 16], &out_block, tail);
+
+  _mm_storeu_si128((__m128i *)mac, chain);
+}
+
+void aesni_eax_decrypt(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16], unsigned char mac[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+
+  if (!textsize)
+    return;
+
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+  __m128i chain = _mm_loadu_si128((const __m128i *)mac);
+
+  size_t nblocks = (textsize - 1) / 16;
+  for (size_t i = 0; i < nblocks; ++i) {
+    __m128i cipher_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    __m128i blocks[2] = {_mm_xor_si128(chain, cipher_block),
+                         m128i_bswap(ctr)};
+    ctr = eax_next_counter(ctr);
+
+    aes_encrypt_blocks<2>(Nr, enc_ks, blocks);
+
+    chain = blocks[0];
+    _mm_storeu_si128((__m128i *)&out[i * 16],
+                     _mm_xor_si128(blocks[1], cipher_block));
+  }
+
+  size_t tail = textsize - nblocks * 16;
+  __m128i stream_block = aes_encrypt_block(Nr, enc_ks, m128i_bswap(ctr));
+  __m128i in_block = _mm_setzero_si128();
+  memcpy(&in_block, &in[nblocks * 16], tail);
+  __m128i out_block = _mm_xor_si128(stream_block, in_block);
+  memcpy(&out[nblocks * 16], &out_block, tail);
+
+  _mm_storeu_si128((__m128i *)mac, chain);
+}
+
+#ifdef __cplusplus
+}
+#endif
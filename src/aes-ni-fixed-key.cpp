@@ -0,0 +1,96 @@
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+#define FIXED_KEY_INTERLEAVE 8
+
+/*
+ * Fixed-key hashing kernels. Every block is independent, so
+ * FIXED_KEY_INTERLEAVE blocks go through the cipher together, and the
+ * feed-forward XOR is applied while the blocks are still in registers: the
+ * input is read & the output written once.
+ */
+
+/* sigma(L || R) = (L ^ R) || L, L being the low (first) 64 bits. */
+static inline __m128i fixed_key_sigma(__m128i x) {
+  return _mm_xor_si128(_mm_shuffle_epi32(x, 0x4e),
+                       _mm_and_si128(x, _mm_set_epi64x(0, -1)));
+}
+
+template <size_t N, enum aes_fixed_key_hash Hash>
+static inline void fixed_key_hash_blocks(unsigned char Nr,
+                                         const __m128i *enc_ks,
+                                         unsigned char *out,
+                                         const unsigned char *in,
+                                         uint64_t tweak) {
+  __m128i x[N], y[N];
+
+  for (size_t j = 0; j < N; ++j) {
+    x[j] = _mm_loadu_si128((const __m128i *)&in[j * 16]);
+    if (Hash == AES_FIXED_KEY_CCR)
+      x[j] = fixed_key_sigma(x[j]);
+    y[j] = x[j];
+  }
+
+  aes_encrypt_blocks<N>(Nr, enc_ks, y);
+
+  /* TCCR: x becomes pi(x) ^ i & goes through the cipher again. */
+  if (Hash == AES_FIXED_KEY_TCCR) {
+    for (size_t j = 0; j < N; ++j) {
+      x[j] = y[j];
+      y[j] = _mm_xor_si128(y[j], _mm_set_epi64x(0, (long long)(tweak + j)));
+    }
+
+    aes_encrypt_blocks<N>(Nr, enc_ks, y);
+  }
+
+  for (size_t j = 0; j < N; ++j)
+    _mm_storeu_si128((__m128i *)&out[j * 16], _mm_xor_si128(y[j], x[j]));
+}
+
+template <enum aes_fixed_key_hash Hash>
+static void fixed_key_hash(const AesContext *ctx, size_t textsize,
+                           unsigned char *out, const unsigned char *in,
+                           uint64_t tweak) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + FIXED_KEY_INTERLEAVE <= nblocks; i += FIXED_KEY_INTERLEAVE)
+    fixed_key_hash_blocks<FIXED_KEY_INTERLEAVE, Hash>(
+        Nr, enc_ks, &out[i * 16], &in[i * 16], tweak + i);
+
+  for (; i < nblocks; ++i)
+    fixed_key_hash_blocks<1, Hash>(Nr, enc_ks, &out[i * 16], &in[i * 16],
+                                   tweak + i);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_fixed_key_cr(const AesContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in) {
+  fixed_key_hash<AES_FIXED_KEY_CR>(ctx, textsize, out, in, 0);
+}
+
+void aesni_fixed_key_ccr(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in) {
+  fixed_key_hash<AES_FIXED_KEY_CCR>(ctx, textsize, out, in, 0);
+}
+
+void aesni_fixed_key_tccr(const AesContext *ctx, size_t textsize,
+                          unsigned char *out, const unsigned char *in,
+                          uint64_t tweak) {
+  fixed_key_hash<AES_FIXED_KEY_TCCR>(ctx, textsize, out, in, tweak);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,128 @@
+#include <emmintrin.h>
+#include <string.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-ghash.h"
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+/*
+ * AES-GCM-SIV kernels. POLYVAL shares the aggregated-reduction code of GHASH
+ * (without the byte reversals), so it is hashed GHASH_AGGREGATE blocks at a
+ * time; only those powers of H are computed since the table is rebuilt for
+ * every nonce.
+ */
+
+/* Encrypts the first N key derivation blocks LE32(i) || nonce together. */
+template <size_t N>
+static inline void gcm_siv_derive_blocks(unsigned char Nr,
+                                         const __m128i *enc_ks,
+                                         const unsigned char nonce[12],
+                                         __m128i blocks[N]) {
+  unsigned char base_bytes[16] = {0};
+  memcpy(&base_bytes[4], nonce, 12);
+  __m128i base = _mm_loadu_si128((const __m128i *)base_bytes);
+
+  for (size_t i = 0; i < N; ++i)
+    blocks[i] = _mm_or_si128(base, _mm_cvtsi32_si128((int)i));
+
+  aes_encrypt_blocks<N>(Nr, enc_ks, blocks);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_gcm_siv_derive_keys(AesContext *ctx, const unsigned char nonce[12],
+                               unsigned char auth_key[16],
+                               unsigned char enc_key[32]) {
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  __m128i blocks[6];
+
+  /* The first 8 bytes of each encrypted block form the keys. */
+  if (ctx->key_size == KEY_TYPE_AES256) {
+    gcm_siv_derive_blocks<6>(ctx->Nr, enc_ks, nonce, blocks);
+    _mm_storeu_si128((__m128i *)&enc_key[16],
+                     _mm_unpacklo_epi64(blocks[4], blocks[5]));
+  } else {
+    gcm_siv_derive_blocks<4>(ctx->Nr, enc_ks, nonce, blocks);
+  }
+
+  _mm_storeu_si128((__m128i *)auth_key,
+                   _mm_unpacklo_epi64(blocks[0], blocks[1]));
+  _mm_storeu_si128((__m128i *)enc_key,
+                   _mm_unpacklo_epi64(blocks[2], blocks[3]));
+}
+
+void aesni_polyval_init(unsigned char *h_table, const unsigned char h[16]) {
+  polyval_htab_init((__m128i *)h_table,
+                    _mm_loadu_si128((const __m128i *)h), GHASH_AGGREGATE);
+}
+
+/* With all the powers of H used by the wide kernels, for AesGhashContext. */
+void aesni_polyval_init_wide(unsigned char *h_table,
+                             const unsigned char h[16]) {
+  polyval_htab_init((__m128i *)h_table,
+                    _mm_loadu_si128((const __m128i *)h), HTAB_KARATSUBA);
+}
+
+void aesni_polyval(const unsigned char *h_table, unsigned char s[16],
+                   size_t textsize, const unsigned char *in) {
+  __m128i acc = _mm_loadu_si128((const __m128i *)s);
+  acc = ghash_blocks<false>((const __m128i *)h_table, acc, textsize / 16, in);
+  _mm_storeu_si128((__m128i *)s, acc);
+}
+
+void aesni_gcm_siv_ctr32le_xcrypt(AesContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  const unsigned char counter[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+
+  /* The little-endian counter is the first 32-bit lane as loaded. */
+  __m128i ctr = _mm_loadu_si128((const __m128i *)counter);
+
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + 8 <= nblocks; i += 8) {
+    __m128i blocks[8];
+    for (size_t j = 0; j < 8; ++j) {
+      blocks[j] = ctr;
+      ctr = _mm_add_epi32(ctr, one);
+    }
+
+    aes_encrypt_blocks<8>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < 8; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16],
+                       _mm_xor_si128(blocks[j], in_block));
+    }
+  }
+
+  for (; i < nblocks; ++i) {
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, ctr);
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    _mm_storeu_si128((__m128i *)&out[i * 16],
+                     _mm_xor_si128(stream_block, in_block));
+    ctr = _mm_add_epi32(ctr, one);
+  }
+
+  if (textsize % 16) {
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, ctr);
+    __m128i in_block = _mm_setzero_si128();
+    memcpy(&in_block, &in[nblocks * 16], textsize % 16);
+    __m128i out_block = _mm_xor_si128(stream_block, in_block);
+    memcpy(&out[nblocks * 16], &out_block, textsize % 16);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,213 @@
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-ghash.h"
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+/* Encrypts GHASH_AGGREGATE counter blocks while hashing the byte-reversed
+ * blocks in hash_in (hash_in[0] already includes the running GHASH value). */
+static inline __m128i gcm_encrypt_blocks_ghash(unsigned char Nr,
+                                               const __m128i *enc_ks,
+                                               __m128i blocks[GHASH_AGGREGATE],
+                                               const __m128i *htab,
+                                               const __m128i *hash_in) {
+  struct ghash_acc acc;
+  ghash_acc_zero(&acc);
+
+  for (size_t j = 0; j < GHASH_AGGREGATE; ++j)
+    blocks[j] = _mm_xor_si128(blocks[j], enc_ks[0]);
+
+  /* Nr >= 10, so rounds 1 to 8 cover all the multiplications. */
+  for (size_t r = 1; r <= GHASH_AGGREGATE; ++r) {
+    for (size_t j = 0; j < GHASH_AGGREGATE; ++j)
+      blocks[j] = _mm_aesenc_si128(blocks[j], enc_ks[r]);
+
+    ghash_acc_mul(&acc, hash_in[r - 1], htab[GHASH_AGGREGATE - r],
+                  htab[HTAB_KARATSUBA + GHASH_AGGREGATE - r]);
+  }
+
+  for (size_t r = GHASH_AGGREGATE + 1; r < Nr; ++r) {
+    for (size_t j = 0; j < GHASH_AGGREGATE; ++j)
+      blocks[j] = _mm_aesenc_si128(blocks[j], enc_ks[r]);
+  }
+
+  for (size_t j = 0; j < GHASH_AGGREGATE; ++j)
+    blocks[j] = _mm_aesenclast_si128(blocks[j], enc_ks[Nr]);
+
+  return ghash_acc_reduce(&acc);
+}
+
+static inline __m128i gcm_next_counters(__m128i ctr,
+                                        __m128i blocks[GHASH_AGGREGATE]) {
+  const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+  for (size_t j = 0; j < GHASH_AGGREGATE; ++j) {
+    blocks[j] = m128i_bswap(ctr);
+    ctr = _mm_add_epi32(ctr, one);
+  }
+
+  return ctr;
+}
+
+/*
+ * CTR encryption with the 32-bit counter of GCM, stitched with GHASH: the
+ * eight carry-less multiplications of one chunk are issued between the AESENC
+ * rounds of the next eight counter blocks, so both run on their own execution
+ * ports. When encrypting, the chunk hashed is the previous cipher text; when
+ * decrypting it is the current one.
+ */
+template <bool Encrypt>
+static void gcm_ctr32_ghash(const AesGcmContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            unsigned char counter[16], unsigned char xi[16]) {
+  const unsigned char Nr = ctx->aes.Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->aes.enc_round_keys;
+  const __m128i *htab = (const __m128i *)ctx->h_table;
+  const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+
+  __m128i s = m128i_bswap(_mm_loadu_si128((const __m128i *)xi));
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  __m128i blocks[GHASH_AGGREGATE];
+  __m128i hash_in[GHASH_AGGREGATE];
+
+  if (Encrypt && nblocks >= GHASH_AGGREGATE) {
+    /* Nothing to hash yet for the first chunk. */
+    ctr = gcm_next_counters(ctr, blocks);
+    aes_encrypt_blocks<GHASH_AGGREGATE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < GHASH_AGGREGATE; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[j * 16]);
+      __m128i out_block = _mm_xor_si128(blocks[j], in_block);
+      _mm_storeu_si128((__m128i *)&out[j * 16], out_block);
+      hash_in[j] = m128i_bswap(out_block);
+    }
+    i = GHASH_AGGREGATE;
+  }
+
+  for (; i + GHASH_AGGREGATE <= nblocks; i += GHASH_AGGREGATE) {
+    ctr = gcm_next_counters(ctr, blocks);
+
+    if (!Encrypt) {
+      for (size_t j = 0; j < GHASH_AGGREGATE; ++j)
+        hash_in[j] = m128i_bswap(
+            _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]));
+    }
+    hash_in[0] = _mm_xor_si128(hash_in[0], s);
+
+    s = gcm_encrypt_blocks_ghash(Nr, enc_ks, blocks, htab, hash_in);
+
+    for (size_t j = 0; j < GHASH_AGGREGATE; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+      __m128i out_block = _mm_xor_si128(blocks[j], in_block);
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16], out_block);
+
+      if (Encrypt)
+        hash_in[j] = m128i_bswap(out_block);
+    }
+  }
+
+  if (Encrypt && i)
+    s = ghash_chunk(htab, s, GHASH_AGGREGATE, hash_in);
+
+  /* Remaining full blocks (fewer than GHASH_AGGREGATE). */
+  size_t remaining = nblocks - i;
+  if (!Encrypt)
+    s = ghash_blocks<true>(htab, s, remaining, &in[i * 16]);
+
+  for (size_t j = i; j < nblocks; ++j) {
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, m128i_bswap(ctr));
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[j * 16]);
+    _mm_storeu_si128((__m128i *)&out[j * 16],
+                     _mm_xor_si128(stream_block, in_block));
+    ctr = _mm_add_epi32(ctr, one);
+  }
+
+  if (Encrypt)
+    s = ghash_blocks<true>(htab, s, remaining, &out[i * 16]);
+
+  if (textsize % 16) {
+    size_t tail = textsize % 16;
+    __m128i stream_block = aes_encrypt_block(Nr, enc_ks, m128i_bswap(ctr));
+    ctr = _mm_add_epi32(ctr, one);
+
+    if (!Encrypt)
+      s = ghash_partial<true>(htab, s, tail, &in[nblocks * 16]);
+
+    __m128i in_block = _mm_setzero_si128();
+    memcpy(&in_block, &in[nblocks * 16], tail);
+    __m128i out_block = _mm_xor_si128(stream_block, in_block);
+    memcpy(&out[nblocks * 16], &out_block, tail);
+
+    if (Encrypt)
+      s = ghash_partial<true>(htab, s, tail, &out[nblocks * 16]);
+  }
+
+  _mm_storeu_si128((__m128i *)xi, m128i_bswap(s));
+  _mm_storeu_si128((__m128i *)counter, m128i_bswap(ctr));
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_ghash_init(unsigned char *h_table, const unsigned char h[16]) {
+  /* mulX_POLYVAL(ByteReverse(H)) */
+  __m128i x = m128i_bswap(_mm_loadu_si128((const __m128i *)h));
+
+  const __m128i poly = _mm_set_epi64x((long long)0xc200000000000000ULL, 1);
+  __m128i carry = _mm_srli_epi64(x, 63);
+  __m128i msb_mask = _mm_sub_epi32(
+      _mm_setzero_si128(), _mm_shuffle_epi32(carry, _MM_SHUFFLE(2, 2, 2, 2)));
+  x = _mm_or_si128(_mm_slli_epi64(x, 1), _mm_slli_si128(carry, 8));
+  x = _mm_xor_si128(x, _mm_and_si128(msb_mask, poly));
+
+  polyval_htab_init((__m128i *)h_table, x, HTAB_KARATSUBA);
+}
+
+void aesni_gcm_init(AesGcmContext *ctx) {
+  const __m128i *enc_ks = (const __m128i *)ctx->aes.enc_round_keys;
+  unsigned char h[16];
+
+  /* H = E(K, 0^128) */
+  _mm_storeu_si128((__m128i *)h, aes_encrypt_block(ctx->aes.Nr, enc_ks,
+                                                   _mm_setzero_si128()));
+  aesni_ghash_init(ctx->h_table, h);
+}
+
+void aesni_ghash(const unsigned char *h_table, unsigned char xi[16],
+                 size_t textsize, const unsigned char *in) {
+  __m128i s = m128i_bswap(_mm_loadu_si128((const __m128i *)xi));
+  s = ghash_blocks<true>((const __m128i *)h_table, s, textsize / 16, in);
+  _mm_storeu_si128((__m128i *)xi, m128i_bswap(s));
+}
+
+void aesni_gcm_ghash(const AesGcmContext *ctx, unsigned char xi[16],
+                     size_t textsize, const unsigned char *in) {
+  aesni_ghash(ctx->h_table, xi, textsize, in);
+}
+
+void aesni_gcm_ctr32_encrypt(const AesGcmContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char counter[16], unsigned char xi[16]) {
+  gcm_ctr32_ghash<true>(ctx, textsize, out, in, counter, xi);
+}
+
+void aesni_gcm_ctr32_decrypt(const AesGcmContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char counter[16], unsigned char xi[16]) {
+  gcm_ctr32_ghash<false>(ctx, textsize, out, in, counter, xi);
+}
+
+#ifdef __cplusplus
+}
+#endif
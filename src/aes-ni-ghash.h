@@ -0,0 +1,143 @@
+#ifndef AY_AES_NI_GHASH_H
+#define AY_AES_NI_GHASH_H
+
+#include <emmintrin.h>
+#include <stddef.h>
+#include <string.h>
+#include <wmmintrin.h>
+
+#include "aes-ni-inner.h"
+
+/*
+ * GHASH is computed in the POLYVAL representation (RFC 8452, Appendix A):
+ *
+ *   GHASH(H, X_1, ..., X_n) = ByteReverse(POLYVAL(mulX_POLYVAL(ByteReverse(H)),
+ *                                         ByteReverse(X_1), ...,
+ *                                         ByteReverse(X_n)))
+ *
+ * Byte reversal is a single PSHUFB, and unlike the bit-reflected form of GHASH
+ * the Montgomery reduction of POLYVAL needs no extra shift of the product.
+ * GCM-SIV uses the same functions for POLYVAL itself, without the byte
+ * reversals.
+ *
+ * Layout of h_table:
+ *   [0, 16)  H^1, ..., H^16 (H^k at index k - 1)
+ *   [16, 32) (hi64 ^ lo64) of the same powers in both halves, the operand of
+ *            the Karatsuba middle multiplication
+ */
+
+/** @brief Number of blocks hashed per reduction */
+#define GHASH_AGGREGATE 8
+
+#define HTAB_KARATSUBA 16
+
+/** @brief Unreduced 256-bit carry-less product, split for Karatsuba. */
+struct ghash_acc {
+  __m128i lo, mid, hi;
+};
+
+static inline void ghash_acc_zero(struct ghash_acc *acc) {
+  acc->lo = _mm_setzero_si128();
+  acc->mid = _mm_setzero_si128();
+  acc->hi = _mm_setzero_si128();
+}
+
+/* acc += x * h, where hk = (hi64 ^ lo64) of h. */
+static inline void ghash_acc_mul(struct ghash_acc *acc, __m128i x, __m128i h,
+                                 __m128i hk) {
+  __m128i xk = _mm_xor_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+
+  acc->lo = _mm_xor_si128(acc->lo, _mm_clmulepi64_si128(x, h, 0x00));
+  acc->hi = _mm_xor_si128(acc->hi, _mm_clmulepi64_si128(x, h, 0x11));
+  acc->mid = _mm_xor_si128(acc->mid, _mm_clmulepi64_si128(xk, hk, 0x00));
+}
+
+/* Montgomery reduction of the accumulated product, i.e. returns
+ * acc * x^-128 mod x^128 + x^127 + x^126 + x^121 + 1. */
+static inline __m128i ghash_acc_reduce(const struct ghash_acc *acc) {
+  const __m128i poly = _mm_set_epi64x((long long)0xc200000000000000ULL, 1);
+
+  __m128i mid = _mm_xor_si128(acc->mid, _mm_xor_si128(acc->lo, acc->hi));
+  __m128i lo = _mm_xor_si128(acc->lo, _mm_slli_si128(mid, 8));
+  __m128i hi = _mm_xor_si128(acc->hi, _mm_srli_si128(mid, 8));
+
+  __m128i t = _mm_clmulepi64_si128(lo, poly, 0x10);
+  lo = _mm_xor_si128(_mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)), t);
+  t = _mm_clmulepi64_si128(lo, poly, 0x10);
+  lo = _mm_xor_si128(_mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)), t);
+
+  return _mm_xor_si128(hi, lo);
+}
+
+static inline __m128i karatsuba_operand(__m128i h) {
+  return _mm_xor_si128(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+static inline __m128i polyval_mul(__m128i a, __m128i b) {
+  struct ghash_acc acc;
+  ghash_acc_zero(&acc);
+  ghash_acc_mul(&acc, a, b, karatsuba_operand(b));
+  return ghash_acc_reduce(&acc);
+}
+
+/* Hashes `n` (<= 16) byte-reversed blocks with a single reduction:
+ * s' = (s ^ x_0) * H^n ^ x_1 * H^(n-1) ^ ... ^ x_(n-1) * H. */
+static inline __m128i ghash_chunk(const __m128i *htab, __m128i s, size_t n,
+                                  const __m128i *x) {
+  struct ghash_acc acc;
+  ghash_acc_zero(&acc);
+
+  ghash_acc_mul(&acc, _mm_xor_si128(x[0], s), htab[n - 1],
+                htab[HTAB_KARATSUBA + n - 1]);
+  for (size_t j = 1; j < n; ++j)
+    ghash_acc_mul(&acc, x[j], htab[n - 1 - j],
+                  htab[HTAB_KARATSUBA + n - 1 - j]);
+
+  return ghash_acc_reduce(&acc);
+}
+
+/* Hashes whole blocks; GHASH byte-reverses them, POLYVAL takes them as is. */
+template <bool ByteReverse>
+static __m128i ghash_blocks(const __m128i *htab, __m128i s, size_t nblocks,
+                            const unsigned char *in) {
+  while (nblocks) {
+    size_t n = nblocks < GHASH_AGGREGATE ? nblocks : GHASH_AGGREGATE;
+    __m128i x[GHASH_AGGREGATE];
+    for (size_t j = 0; j < n; ++j) {
+      x[j] = _mm_loadu_si128((const __m128i *)&in[j * 16]);
+      if (ByteReverse)
+        x[j] = m128i_bswap(x[j]);
+    }
+
+    s = ghash_chunk(htab, s, n, x);
+    in += n * 16;
+    nblocks -= n;
+  }
+
+  return s;
+}
+
+/* Hashes a trailing partial block of `size` (< 16) bytes, zero-padded. */
+template <bool ByteReverse>
+static inline __m128i ghash_partial(const __m128i *htab, __m128i s, size_t size,
+                                    const unsigned char *in) {
+  __m128i block = _mm_setzero_si128();
+  memcpy(&block, in, size);
+  if (ByteReverse)
+    block = m128i_bswap(block);
+
+  return ghash_chunk(htab, s, 1, &block);
+}
+
+/* Fills htab with H^1, ..., H^npowers and their Karatsuba operands, H being
+ * in POLYVAL form. */
+static inline void polyval_htab_init(__m128i *htab, __m128i h, size_t npowers) {
+  htab[0] = h;
+  for (size_t k = 1; k < npowers; ++k)
+    htab[k] = polyval_mul(htab[k - 1], h);
+
+  for (size_t k = 0; k < npowers; ++k)
+    htab[HTAB_KARATSUBA + k] = karatsuba_operand(htab[k]);
+}
+
+#endif /* AY_AES_NI_GHASH_H */
@@ -0,0 +1,192 @@
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "inner.h"
+
+#define HARAKA256_INTERLEAVE 4
+#define HARAKA512_INTERLEAVE 2
+
+/*
+ * Haraka v2 kernels. A permutation is 5 rounds of 2 AESENC per state block
+ * followed by a word shuffle, so one input only has 2 (Haraka-256) or 4
+ * (Haraka-512) independent AESENC per step; the inputs of a batch go through
+ * the rounds together to fill the remaining slots.
+ */
+
+/* MIX of Haraka-256: interleaves the 32-bit words of both blocks. */
+static inline void haraka256_mix(__m128i s[2]) {
+  __m128i tmp = _mm_unpacklo_epi32(s[0], s[1]);
+  s[1] = _mm_unpackhi_epi32(s[0], s[1]);
+  s[0] = tmp;
+}
+
+/* MIX of Haraka-512 */
+static inline void haraka512_mix(__m128i s[4]) {
+  __m128i tmp = _mm_unpacklo_epi32(s[0], s[1]);
+  s[0] = _mm_unpackhi_epi32(s[0], s[1]);
+  s[1] = _mm_unpacklo_epi32(s[2], s[3]);
+  s[2] = _mm_unpackhi_epi32(s[2], s[3]);
+  s[3] = _mm_unpacklo_epi32(s[0], s[2]);
+  s[0] = _mm_unpackhi_epi32(s[0], s[2]);
+  s[2] = _mm_unpackhi_epi32(s[1], tmp);
+  s[1] = _mm_unpacklo_epi32(s[1], tmp);
+}
+
+template <size_t N, size_t W>
+static inline void haraka_permute(const __m128i *rc, __m128i s[N][W]) {
+  for (size_t r = 0; r < 5; ++r) {
+    for (size_t k = 0; k < 2; ++k) {
+      for (size_t j = 0; j < N; ++j)
+        for (size_t b = 0; b < W; ++b)
+          s[j][b] = _mm_aesenc_si128(s[j][b], rc[(2 * r + k) * W + b]);
+    }
+
+    for (size_t j = 0; j < N; ++j) {
+      if (W == 2)
+        haraka256_mix(s[j]);
+      else
+        haraka512_mix(s[j]);
+    }
+  }
+}
+
+/* Feed-forward of Haraka-512, then truncation to 32 bytes */
+static inline void haraka512_store(unsigned char *out, __m128i s[4],
+                                   const __m128i x[4]) {
+  for (size_t b = 0; b < 4; ++b)
+    s[b] = _mm_xor_si128(s[b], x[b]);
+
+  _mm_storeu_si128((__m128i *)out, _mm_unpackhi_epi64(s[0], s[1]));
+  _mm_storeu_si128((__m128i *)&out[16], _mm_unpacklo_epi64(s[2], s[3]));
+}
+
+template <size_t N>
+static inline void haraka256_blocks(const __m128i *rc, unsigned char *out,
+                                    const unsigned char *in) {
+  __m128i x[N][2], s[N][2];
+
+  for (size_t j = 0; j < N; ++j)
+    for (size_t b = 0; b < 2; ++b)
+      s[j][b] = x[j][b] =
+          _mm_loadu_si128((const __m128i *)&in[j * 32 + b * 16]);
+
+  haraka_permute<N, 2>(rc, s);
+
+  for (size_t j = 0; j < N; ++j)
+    for (size_t b = 0; b < 2; ++b)
+      _mm_storeu_si128((__m128i *)&out[j * 32 + b * 16],
+                       _mm_xor_si128(s[j][b], x[j][b]));
+}
+
+template <size_t N>
+static inline void haraka512_blocks(const __m128i *rc, unsigned char *out,
+                                    const unsigned char *in) {
+  __m128i x[N][4], s[N][4];
+
+  for (size_t j = 0; j < N; ++j)
+    for (size_t b = 0; b < 4; ++b)
+      s[j][b] = x[j][b] =
+          _mm_loadu_si128((const __m128i *)&in[j * 64 + b * 16]);
+
+  haraka_permute<N, 4>(rc, s);
+
+  for (size_t j = 0; j < N; ++j)
+    haraka512_store(&out[j * 32], s[j], x[j]);
+}
+
+/* Advances N chains by one block: x holds h || block of each chain. */
+template <size_t N>
+static inline void haraka_chain_block(const __m128i *rc, __m128i x[N][4]) {
+  __m128i s[N][4];
+
+  for (size_t j = 0; j < N; ++j)
+    for (size_t b = 0; b < 4; ++b)
+      s[j][b] = x[j][b];
+
+  haraka_permute<N, 4>(rc, s);
+
+  for (size_t j = 0; j < N; ++j) {
+    for (size_t b = 0; b < 4; ++b)
+      s[j][b] = _mm_xor_si128(s[j][b], x[j][b]);
+    x[j][0] = _mm_unpackhi_epi64(s[j][0], s[j][1]);
+    x[j][1] = _mm_unpacklo_epi64(s[j][2], s[j][3]);
+  }
+}
+
+/* N chains side by side; the chaining values stay in registers. */
+template <size_t N>
+static void haraka_chain_lanes(const __m128i *rc, unsigned char *h,
+                               size_t nblocks,
+                               const unsigned char *const *blocks) {
+  __m128i x[N][4];
+
+  for (size_t j = 0; j < N; ++j) {
+    x[j][0] = _mm_loadu_si128((const __m128i *)&h[j * 32]);
+    x[j][1] = _mm_loadu_si128((const __m128i *)&h[j * 32 + 16]);
+  }
+
+  for (size_t i = 0; i < nblocks; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      x[j][2] = _mm_loadu_si128((const __m128i *)&blocks[j][i * 32]);
+      x[j][3] = _mm_loadu_si128((const __m128i *)&blocks[j][i * 32 + 16]);
+    }
+    haraka_chain_block<N>(rc, x);
+  }
+
+  for (size_t j = 0; j < N; ++j) {
+    _mm_storeu_si128((__m128i *)&h[j * 32], x[j][0]);
+    _mm_storeu_si128((__m128i *)&h[j * 32 + 16], x[j][1]);
+  }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_haraka256(const unsigned char *rc, size_t count,
+                     unsigned char *out, const unsigned char *in) {
+  const __m128i *rc_blocks = (const __m128i *)rc;
+  size_t i = 0;
+
+  for (; i + HARAKA256_INTERLEAVE <= count; i += HARAKA256_INTERLEAVE)
+    haraka256_blocks<HARAKA256_INTERLEAVE>(rc_blocks, &out[i * 32],
+                                           &in[i * 32]);
+
+  for (; i < count; ++i)
+    haraka256_blocks<1>(rc_blocks, &out[i * 32], &in[i * 32]);
+}
+
+void aesni_haraka512(const unsigned char *rc, size_t count,
+                     unsigned char *out, const unsigned char *in) {
+  const __m128i *rc_blocks = (const __m128i *)rc;
+  size_t i = 0;
+
+  for (; i + HARAKA512_INTERLEAVE <= count; i += HARAKA512_INTERLEAVE)
+    haraka512_blocks<HARAKA512_INTERLEAVE>(rc_blocks, &out[i * 32],
+                                           &in[i * 64]);
+
+  for (; i < count; ++i)
+    haraka512_blocks<1>(rc_blocks, &out[i * 32], &in[i * 64]);
+}
+
+void aesni_haraka_chain(const unsigned char *rc, size_t nlanes,
+                        unsigned char *h, size_t nblocks,
+                        const unsigned char *const *blocks) {
+  const __m128i *rc_blocks = (const __m128i *)rc;
+
+  switch (nlanes) {
+  case 1:
+    haraka_chain_lanes<1>(rc_blocks, h, nblocks, blocks);
+    break;
+  case 2:
+    haraka_chain_lanes<2>(rc_blocks, h, nblocks, blocks);
+    break;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
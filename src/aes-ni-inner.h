@@ -0,0 +1,83 @@
+#ifndef AY_AES_NI_INNER_H
+#define AY_AES_NI_INNER_H
+
+#include <emmintrin.h>
+#include <stddef.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+/**
+ * @name Common functions
+ * Functions shared by the AES-NI kernels of all modes
+ */
+/** @{ */
+
+static inline __m128i aes_encrypt_block(unsigned char Nr, const __m128i *enc_ks,
+                                        __m128i plain_block) {
+  __m128i block = _mm_xor_si128(plain_block, enc_ks[0]);
+  for (size_t i = 1; i < Nr; ++i)
+    block = _mm_aesenc_si128(block, enc_ks[i]);
+
+  block = _mm_aesenclast_si128(block, enc_ks[Nr]);
+
+  return block;
+};
+
+static inline __m128i aes_decrypt_block(unsigned char Nr, const __m128i *dec_ks,
+                                        __m128i cipher_block) {
+  __m128i block = _mm_xor_si128(cipher_block, dec_ks[0]);
+  for (size_t i = 1; i < Nr; ++i)
+    block = _mm_aesdec_si128(block, dec_ks[i]);
+
+  block = _mm_aesdeclast_si128(block, dec_ks[Nr]);
+
+  return block;
+}
+
+/**
+ * @brief Encrypts `N` independent blocks in place, issuing each round for all
+ * of them back to back so that the AESENC latency is hidden behind the
+ * throughput of the other blocks.
+ */
+template <size_t N>
+static inline void aes_encrypt_blocks(unsigned char Nr, const __m128i *enc_ks,
+                                      __m128i blocks[N]) {
+  for (size_t j = 0; j < N; ++j)
+    blocks[j] = _mm_xor_si128(blocks[j], enc_ks[0]);
+
+  for (size_t i = 1; i < Nr; ++i) {
+    __m128i round_key = enc_ks[i];
+    for (size_t j = 0; j < N; ++j)
+      blocks[j] = _mm_aesenc_si128(blocks[j], round_key);
+  }
+
+  for (size_t j = 0; j < N; ++j)
+    blocks[j] = _mm_aesenclast_si128(blocks[j], enc_ks[Nr]);
+}
+
+/** @brief Decrypting counterpart of aes_encrypt_blocks() */
+template <size_t N>
+static inline void aes_decrypt_blocks(unsigned char Nr, const __m128i *dec_ks,
+                                      __m128i blocks[N]) {
+  for (size_t j = 0; j < N; ++j)
+    blocks[j] = _mm_xor_si128(blocks[j], dec_ks[0]);
+
+  for (size_t i = 1; i < Nr; ++i) {
+    __m128i round_key = dec_ks[i];
+    for (size_t j = 0; j < N; ++j)
+      blocks[j] = _mm_aesdec_si128(blocks[j], round_key);
+  }
+
+  for (size_t j = 0; j < N; ++j)
+    blocks[j] = _mm_aesdeclast_si128(blocks[j], dec_ks[Nr]);
+}
+
+static inline __m128i m128i_bswap(__m128i x) {
+  const __m128i reverse_order =
+      _mm_set_epi32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f);
+  return _mm_shuffle_epi8(x, reverse_order);
+}
+
+/** @} */
+
+#endif /* AY_AES_NI_INNER_H */
@@ -0,0 +1,117 @@
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+/*
+ * AES key wrap kernels. Each step of W (or W^-1) depends on the register A
+ * left by the previous one, so a single key is a chain of 6n dependent block
+ * operations. Up to AES_KW_LANES independent keys advance together instead,
+ * one block each per step.
+ */
+
+/* t as the big-endian first half of a block. */
+static inline __m128i kw_t_block(uint64_t t) {
+  return m128i_bswap(_mm_set_epi64x((long long)t, 0));
+}
+
+template <size_t N, bool Wrap>
+static void kw_lanes(unsigned char Nr, const __m128i *ks,
+                     struct aes_kw_lane *lanes, size_t nsteps) {
+  __m128i a[N];
+  for (size_t j = 0; j < N; ++j)
+    a[j] = _mm_loadl_epi64((const __m128i *)lanes[j].a);
+
+  for (size_t step = 0; step < nsteps; ++step) {
+    __m128i blocks[N];
+    for (size_t j = 0; j < N; ++j) {
+      __m128i r = _mm_loadl_epi64((const __m128i *)&lanes[j].r[lanes[j].i * 8]);
+      if (!Wrap)
+        a[j] = _mm_xor_si128(a[j], kw_t_block(lanes[j].t));
+      blocks[j] = _mm_unpacklo_epi64(a[j], r);
+    }
+
+    if (Wrap)
+      aes_encrypt_blocks<N>(Nr, ks, blocks);
+    else
+      aes_decrypt_blocks<N>(Nr, ks, blocks);
+
+    for (size_t j = 0; j < N; ++j) {
+      struct aes_kw_lane *lane = &lanes[j];
+      _mm_storel_epi64((__m128i *)&lane->r[lane->i * 8],
+                       _mm_unpackhi_epi64(blocks[j], blocks[j]));
+
+      if (Wrap) {
+        a[j] = _mm_xor_si128(blocks[j], kw_t_block(lane->t++));
+        lane->i = lane->i + 1 == lane->n ? 0 : lane->i + 1;
+      } else {
+        a[j] = blocks[j];
+        --lane->t;
+        lane->i = lane->i == 0 ? lane->n - 1 : lane->i - 1;
+      }
+    }
+  }
+
+  for (size_t j = 0; j < N; ++j)
+    _mm_storel_epi64((__m128i *)lanes[j].a, a[j]);
+}
+
+template <bool Wrap>
+static void kw_dispatch(const AesContext *ctx, size_t nlanes,
+                        struct aes_kw_lane *lanes, size_t nsteps) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *ks = (const __m128i *)(Wrap ? ctx->enc_round_keys
+                                             : ctx->dec_round_keys);
+
+  switch (nlanes) {
+  case 1:
+    kw_lanes<1, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 2:
+    kw_lanes<2, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 3:
+    kw_lanes<3, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 4:
+    kw_lanes<4, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 5:
+    kw_lanes<5, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 6:
+    kw_lanes<6, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 7:
+    kw_lanes<7, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  case 8:
+    kw_lanes<8, Wrap>(Nr, ks, lanes, nsteps);
+    break;
+  }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_kw_wrap_lanes(const AesContext *ctx, size_t nlanes,
+                         struct aes_kw_lane *lanes, size_t nsteps) {
+  kw_dispatch<true>(ctx, nlanes, lanes, nsteps);
+}
+
+void aesni_kw_unwrap_lanes(const AesContext *ctx, size_t nlanes,
+                           struct aes_kw_lane *lanes, size_t nsteps) {
+  kw_dispatch<false>(ctx, nlanes, lanes, nsteps);
+}
+
+#ifdef __cplusplus
+}
+#endif
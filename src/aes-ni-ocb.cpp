@@ -0,0 +1,150 @@
+#include <emmintrin.h>
+#include <stdint.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+#define OCB_INTERLEAVE 8
+
+/*
+ * AES-OCB3 kernels. The offset of block i is the offset of block i - 1 xor
+ * L_{ntz(i)}, so the offsets of OCB_INTERLEAVE blocks only take that many
+ * table lookups & xors; the blocks themselves are independent and go through
+ * the cipher together.
+ */
+
+/* Computes the offsets of OCB_INTERLEAVE blocks, starting from block `index`,
+ * and returns the last one. */
+static inline __m128i ocb_next_offsets(const __m128i *l, uint64_t index,
+                                       __m128i offset,
+                                       __m128i offsets[OCB_INTERLEAVE]) {
+  for (size_t j = 0; j < OCB_INTERLEAVE; ++j) {
+    offset = _mm_xor_si128(offset, l[aes_ntz64(index + j)]);
+    offsets[j] = offset;
+  }
+
+  return offset;
+}
+
+template <bool Encrypt>
+static void ocb_crypt(const AesOcbContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in,
+                      uint64_t block_index, unsigned char offset_bytes[16],
+                      unsigned char checksum_bytes[16]) {
+  const unsigned char Nr = ctx->aes.Nr;
+  const __m128i *ks = (const __m128i *)(Encrypt ? ctx->aes.enc_round_keys
+                                                : ctx->aes.dec_round_keys);
+  /* L_0 onwards */
+  const __m128i *l = (const __m128i *)&ctx->l_table[2 * 16];
+
+  __m128i offset = _mm_loadu_si128((const __m128i *)offset_bytes);
+  __m128i checksum = _mm_loadu_si128((const __m128i *)checksum_bytes);
+
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + OCB_INTERLEAVE <= nblocks; i += OCB_INTERLEAVE) {
+    __m128i offsets[OCB_INTERLEAVE], blocks[OCB_INTERLEAVE];
+    offset = ocb_next_offsets(l, block_index + i, offset, offsets);
+
+    for (size_t j = 0; j < OCB_INTERLEAVE; ++j) {
+      __m128i in_block = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+      if (Encrypt)
+        checksum = _mm_xor_si128(checksum, in_block);
+      blocks[j] = _mm_xor_si128(in_block, offsets[j]);
+    }
+
+    if (Encrypt)
+      aes_encrypt_blocks<OCB_INTERLEAVE>(Nr, ks, blocks);
+    else
+      aes_decrypt_blocks<OCB_INTERLEAVE>(Nr, ks, blocks);
+
+    for (size_t j = 0; j < OCB_INTERLEAVE; ++j) {
+      __m128i out_block = _mm_xor_si128(blocks[j], offsets[j]);
+      if (!Encrypt)
+        checksum = _mm_xor_si128(checksum, out_block);
+      _mm_storeu_si128((__m128i *)&out[(i + j) * 16], out_block);
+    }
+  }
+
+  for (; i < nblocks; ++i) {
+    offset = _mm_xor_si128(offset, l[aes_ntz64(block_index + i)]);
+
+    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    __m128i block = _mm_xor_si128(in_block, offset);
+    block = Encrypt ? aes_encrypt_block(Nr, ks, block)
+                    : aes_decrypt_block(Nr, ks, block);
+    __m128i out_block = _mm_xor_si128(block, offset);
+    _mm_storeu_si128((__m128i *)&out[i * 16], out_block);
+
+    checksum = _mm_xor_si128(checksum, Encrypt ? in_block : out_block);
+  }
+
+  _mm_storeu_si128((__m128i *)offset_bytes, offset);
+  _mm_storeu_si128((__m128i *)checksum_bytes, checksum);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_ocb_encrypt_blocks(const AesOcbContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t block_index, unsigned char offset[16],
+                              unsigned char checksum[16]) {
+  ocb_crypt<true>(ctx, textsize, out, in, block_index, offset, checksum);
+}
+
+void aesni_ocb_decrypt_blocks(const AesOcbContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t block_index, unsigned char offset[16],
+                              unsigned char checksum[16]) {
+  ocb_crypt<false>(ctx, textsize, out, in, block_index, offset, checksum);
+}
+
+void aesni_ocb_hash_blocks(const AesOcbContext *ctx, size_t textsize,
+                           const unsigned char *in, uint64_t block_index,
+                           unsigned char offset_bytes[16],
+                           unsigned char sum_bytes[16]) {
+  const unsigned char Nr = ctx->aes.Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->aes.enc_round_keys;
+  const __m128i *l = (const __m128i *)&ctx->l_table[2 * 16];
+
+  __m128i offset = _mm_loadu_si128((const __m128i *)offset_bytes);
+  __m128i sum = _mm_loadu_si128((const __m128i *)sum_bytes);
+
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  for (; i + OCB_INTERLEAVE <= nblocks; i += OCB_INTERLEAVE) {
+    __m128i blocks[OCB_INTERLEAVE];
+    offset = ocb_next_offsets(l, block_index + i, offset, blocks);
+
+    for (size_t j = 0; j < OCB_INTERLEAVE; ++j)
+      blocks[j] = _mm_xor_si128(
+          blocks[j], _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]));
+
+    aes_encrypt_blocks<OCB_INTERLEAVE>(Nr, enc_ks, blocks);
+
+    for (size_t j = 0; j < OCB_INTERLEAVE; ++j)
+      sum = _mm_xor_si128(sum, blocks[j]);
+  }
+
+  for (; i < nblocks; ++i) {
+    offset = _mm_xor_si128(offset, l[aes_ntz64(block_index + i)]);
+    __m128i block = _mm_xor_si128(
+        _mm_loadu_si128((const __m128i *)&in[i * 16]), offset);
+    sum = _mm_xor_si128(sum, aes_encrypt_block(Nr, enc_ks, block));
+  }
+
+  _mm_storeu_si128((__m128i *)offset_bytes, offset);
+  _mm_storeu_si128((__m128i *)sum_bytes, sum);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+/*
+ * AES-OFB kernels. Each key stream block is the encryption of the previous
+ * one, so the key stream is a serial chain of single block encryptions; the
+ * only way to take it off the data path is to compute it ahead of time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_ofb_keystream(const AesContext *ctx, size_t size,
+                         unsigned char *out, unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  __m128i block = _mm_loadu_si128((const __m128i *)iv);
+
+  for (size_t i = 0; i < size / 16; ++i) {
+    block = aes_encrypt_block(Nr, enc_ks, block);
+    _mm_storeu_si128((__m128i *)&out[i * 16], block);
+  }
+
+  _mm_storeu_si128((__m128i *)iv, block);
+}
+
+void aesni_ofb_xcrypt(const AesContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char iv[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  __m128i block = _mm_loadu_si128((const __m128i *)iv);
+
+  for (size_t i = 0; i < textsize / 16; ++i) {
+    block = aes_encrypt_block(Nr, enc_ks, block);
+    _mm_storeu_si128(
+        (__m128i *)&out[i * 16],
+        _mm_xor_si128(block, _mm_loadu_si128((const __m128i *)&in[i * 16])));
+  }
+
+  _mm_storeu_si128((__m128i *)iv, block);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,123 @@
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+#include "aes-ni-inner.h"
+#include "inner.h"
+
+#define XTS_INTERLEAVE 8
+
+/* Multiplies the tweak (a little-endian 128-bit integer) by x in GF(2^128):
+ * each 32-bit lane is shifted by one, the bit shifted out of a lane moves into
+ * the next one and the bit shifted out of the block is reduced by 0x87. */
+static inline __m128i xts_mul_alpha(__m128i tweak) {
+  const __m128i poly = _mm_set_epi32(1, 1, 1, 0x87);
+  __m128i carry = _mm_srai_epi32(tweak, 31);
+  carry = _mm_shuffle_epi32(carry, _MM_SHUFFLE(2, 1, 0, 3));
+  return _mm_xor_si128(_mm_slli_epi32(tweak, 1), _mm_and_si128(carry, poly));
+}
+
+/*
+ * Runs XTS_INTERLEAVE blocks through the cipher while computing the tweaks of
+ * the next XTS_INTERLEAVE blocks: the doublings form a serial dependency chain
+ * that is short enough to be hidden between the AESENC/AESDEC rounds.
+ */
+template <bool Encrypt>
+static inline void xts_crypt_blocks(unsigned char Nr, const __m128i *ks,
+                                    __m128i blocks[XTS_INTERLEAVE],
+                                    __m128i tweaks[XTS_INTERLEAVE]) {
+  __m128i next = tweaks[XTS_INTERLEAVE - 1];
+
+  for (size_t j = 0; j < XTS_INTERLEAVE; ++j)
+    blocks[j] = _mm_xor_si128(_mm_xor_si128(blocks[j], tweaks[j]), ks[0]);
+
+  /* Nr >= 10, so rounds 1 to 8 cover all the doublings. */
+  __m128i next_tweaks[XTS_INTERLEAVE];
+  for (size_t r = 1; r <= XTS_INTERLEAVE; ++r) {
+    for (size_t j = 0; j < XTS_INTERLEAVE; ++j)
+      blocks[j] = Encrypt ? _mm_aesenc_si128(blocks[j], ks[r])
+                          : _mm_aesdec_si128(blocks[j], ks[r]);
+
+    next = xts_mul_alpha(next);
+    next_tweaks[r - 1] = next;
+  }
+
+  for (size_t r = XTS_INTERLEAVE + 1; r < Nr; ++r) {
+    for (size_t j = 0; j < XTS_INTERLEAVE; ++j)
+      blocks[j] = Encrypt ? _mm_aesenc_si128(blocks[j], ks[r])
+                          : _mm_aesdec_si128(blocks[j], ks[r]);
+  }
+
+  for (size_t j = 0; j < XTS_INTERLEAVE; ++j) {
+    blocks[j] = Encrypt ? _mm_aesenclast_si128(blocks[j], ks[Nr])
+                        : _mm_aesdeclast_si128(blocks[j], ks[Nr]);
+    blocks[j] = _mm_xor_si128(blocks[j], tweaks[j]);
+    tweaks[j] = next_tweaks[j];
+  }
+}
+
+template <bool Encrypt>
+static void xts_crypt(const AesContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char tweak[16]) {
+  const unsigned char Nr = ctx->Nr;
+  const __m128i *ks = (const __m128i *)(Encrypt ? ctx->enc_round_keys
+                                                : ctx->dec_round_keys);
+
+  __m128i t = _mm_loadu_si128((const __m128i *)tweak);
+  size_t nblocks = textsize / 16;
+  size_t i = 0;
+
+  if (nblocks >= XTS_INTERLEAVE) {
+    __m128i tweaks[XTS_INTERLEAVE];
+    tweaks[0] = t;
+    for (size_t j = 1; j < XTS_INTERLEAVE; ++j)
+      tweaks[j] = xts_mul_alpha(tweaks[j - 1]);
+
+    for (; i + XTS_INTERLEAVE <= nblocks; i += XTS_INTERLEAVE) {
+      __m128i blocks[XTS_INTERLEAVE];
+      for (size_t j = 0; j < XTS_INTERLEAVE; ++j)
+        blocks[j] = _mm_loadu_si128((const __m128i *)&in[(i + j) * 16]);
+
+      xts_crypt_blocks<Encrypt>(Nr, ks, blocks, tweaks);
+
+      for (size_t j = 0; j < XTS_INTERLEAVE; ++j)
+        _mm_storeu_si128((__m128i *)&out[(i + j) * 16], blocks[j]);
+    }
+
+    t = tweaks[0];
+  }
+
+  for (; i < nblocks; ++i) {
+    __m128i block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
+    block = _mm_xor_si128(block, t);
+    block = Encrypt ? aes_encrypt_block(Nr, ks, block)
+                    : aes_decrypt_block(Nr, ks, block);
+    _mm_storeu_si128((__m128i *)&out[i * 16], _mm_xor_si128(block, t));
+    t = xts_mul_alpha(t);
+  }
+
+  _mm_storeu_si128((__m128i *)tweak, t);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesni_xts_encrypt_blocks(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              unsigned char tweak[16]) {
+  xts_crypt<true>(ctx, textsize, out, in, tweak);
+}
+
+void aesni_xts_decrypt_blocks(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              unsigned char tweak[16]) {
+  xts_crypt<false>(ctx, textsize, out, in, tweak);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,49 +10,9 @@
 #include <ay/aes.h>
 #include <ay/aes/hedley.h>
 
+#include "aes-ni-inner.h"
 #include "inner.h"
 
-/**
- * @name Common functions
- * Functions used in AES-128, AES-192, AES-256 implementation
- */
-/** @{ */
-
-/**
- * @brief Expands the given `key_lower` into the decryption key schedule (since
- * Intel uses Equivalent Inverse Cipher in section 5.3.5 of FIPS 197)
- *
- * @param dec_key_schedule Pointer to array having the decryption key schedule
- * @param enc_key_schedule Pointer to array having the encryption key schedule
- * @param key_lower lower 128 bits of the AES key
- * @param Nr number of rounds in algorithm (10 for AES-128, 12 for AES-192, 14
- * for AES-256)
- */
-
-static inline __m128i aes_encrypt_block(unsigned char Nr, const __m128i *enc_ks,
-                                        __m128i plain_block) {
-  __m128i block = _mm_xor_si128(plain_block, enc_ks[0]);
-  for (size_t i = 1; i < Nr; ++i)
-    block = _mm_aesenc_si128(block, enc_ks[i]);
-
-  block = _mm_aesenclast_si128(block, enc_ks[Nr]);
-
-  return block;
-};
-
-static inline __m128i aes_decrypt_block(unsigned char Nr, const __m128i *dec_ks,
-                                        __m128i cipher_block) {
-  __m128i block = _mm_xor_si128(cipher_block, dec_ks[0]);
-  for (size_t i = 1; i < Nr; ++i)
-    block = _mm_aesdec_si128(block, dec_ks[i]);
-
-  block = _mm_aesdeclast_si128(block, dec_ks[Nr]);
-
-  return block;
-}
-
-/** @} */
-
 static __m128i xor_dw_with_prev_dw(__m128i x) {
   __m128i result = x;
   for (size_t i = 0; i < 3; ++i)
@@ -335,75 +295,6 @@ void aesni_cbc_decrypt(AesContext *ctx, size_t textsize,
   }
 }
 
-/* Behaves exactly like _mm_cmplt_epi8 except doing unsigned comparisons.
- * From https://stackoverflow.com/a/56346628/15519945
- */
-static inline __m128i cmplt_epi8_unsigned(__m128i a, __m128i b) {
-  __m128i signbits = _mm_set1_epi8(0x80);
-  a = _mm_xor_si128(a, signbits);
-  b = _mm_xor_si128(b, signbits);
-
-  return _mm_cmplt_epi8(a, b);
-}
-
-static __m128i m128i_add(__m128i a, __m128i b) {
-  __m128i sum_packed8 = _mm_add_epi8(a, b);
-  __m128i mask = cmplt_epi8_unsigned(sum_packed8, a);
-  __m128i ones = _mm_set1_epi8(1);
-
-  /* Get carry of each of 8-bit packed addition */
-  __m128i carry = _mm_and_si128(mask, ones);
-
-  carry = _mm_slli_si128(carry, 1);
-
-  __m128i final_sum = _mm_add_epi8(sum_packed8, carry);
-
-  return final_sum;
-}
-
-static inline __m128i m128i_increment(__m128i a) {
-  __m128i one = _mm_set_epi32(0, 0, 0, 1);
-  return m128i_add(a, one);
-}
-
-static inline __m128i m128i_bswap(__m128i x) {
-  const __m128i reverse_order =
-      _mm_set_epi32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f);
-  return _mm_shuffle_epi8(x, reverse_order);
-}
-
-void aesni_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
-                      const unsigned char *in, unsigned char next_iv[16],
-                      const unsigned char iv[16]) {
-  __m128i iv_reg = m128i_bswap(_mm_loadu_si128((const __m128i *)iv));
-  size_t i = 0;
-
-  for (; i < textsize / 16; ++i) {
-    __m128i stream_block = aes_encrypt_block(
-        ctx->Nr, (__m128i *)ctx->enc_round_keys, m128i_bswap(iv_reg));
-    __m128i in_block = _mm_loadu_si128((const __m128i *)&in[i * 16]);
-    __m128i out_block = _mm_xor_si128(stream_block, in_block);
-
-    iv_reg = m128i_increment(iv_reg);
-
-    _mm_storeu_si128((__m128i *)&out[i * 16], out_block);
-  }
-
-  if (textsize % 16) {
-    __m128i stream_block = aes_encrypt_block(
-        ctx->Nr, (__m128i *)ctx->enc_round_keys, m128i_bswap(iv_reg));
-    __m128i in_block = _mm_setzero_si128();
-    memcpy(&in_block, &in[i * 16], textsize % 16);
-
-    __m128i out_block = _mm_xor_si128(stream_block, in_block);
-    memcpy(&out[i * 16], &out_block, textsize % 16);
-  }
-
-  if (next_iv) {
-    _mm_storeu_si128((__m128i *)next_iv, m128i_bswap(iv_reg));
-  }
-}
-
 #ifdef __cplusplus
 }
 #endif
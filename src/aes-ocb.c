@@ -0,0 +1,187 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+#define OCB_L_STAR 0
+#define OCB_L_DOLLAR 1
+
+static void ocb_xor_block(unsigned char dest[16], const unsigned char a[16],
+                          const unsigned char b[16]) {
+  for (size_t i = 0; i < 16; ++i)
+    dest[i] = a[i] ^ b[i];
+}
+
+static const unsigned char *ocb_l(const AesOcbContext *ctx, size_t i) {
+  return &ctx->l_table[i * 16];
+}
+
+static void ocb_encipher(AesOcbContext *ctx, unsigned char out[16],
+                         const unsigned char in[16]) {
+  ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, out, in);
+}
+
+void aes_ocb_init_l_table(AesOcbContext *ctx) {
+  static const unsigned char zero[16] = {0};
+  unsigned char *l_table = ctx->l_table;
+
+  ocb_encipher(ctx, &l_table[OCB_L_STAR * 16], zero);
+  for (size_t i = OCB_L_DOLLAR; i * 16 < sizeof ctx->l_table; ++i)
+    aes_gf128_double(&l_table[i * 16], &l_table[(i - 1) * 16]);
+}
+
+/* Nonces of 1 to 15 bytes & tags of 1 to 16 bytes (section 4.2 of RFC 7253) */
+static bool ocb_sizes_are_valid(size_t noncesize, size_t tagsize) {
+  return noncesize >= 1 && noncesize <= 15 && tagsize >= 1 && tagsize <= 16;
+}
+
+/* L_0 to L_31 offset the blocks numbered below 2^32, so the text & the
+ * associated data are less than 2^36 bytes. */
+static bool ocb_lengths_are_valid(size_t textsize, size_t aadsize) {
+  return (uint64_t)textsize >> 36 == 0 && (uint64_t)aadsize >> 36 == 0;
+}
+
+/* Offset_0 from the nonce (section 4.2 of RFC 7253). */
+static void ocb_initial_offset(AesOcbContext *ctx, size_t noncesize,
+                               const unsigned char *nonce, size_t tagsize,
+                               unsigned char offset[16]) {
+  unsigned char block[16] = {0}, ktop[16], stretch[25];
+
+  block[0] = (unsigned char)(((tagsize * 8) % 128) << 1);
+  block[15 - noncesize] |= 1;
+  memcpy(&block[16 - noncesize], nonce, noncesize);
+
+  unsigned bottom = block[15] & 0x3f;
+  block[15] &= 0xc0;
+  ocb_encipher(ctx, ktop, block);
+
+  /* Stretch = Ktop || (Ktop[1..64] xor Ktop[9..72]), plus a zero byte so the
+   * shift below can always read one byte past the offset. */
+  memcpy(stretch, ktop, 16);
+  for (size_t i = 0; i < 8; ++i)
+    stretch[16 + i] = ktop[i] ^ ktop[i + 1];
+  stretch[24] = 0;
+
+  unsigned byte_shift = bottom / 8, bit_shift = bottom % 8;
+  for (size_t i = 0; i < 16; ++i) {
+    unsigned hi = stretch[i + byte_shift], lo = stretch[i + byte_shift + 1];
+    offset[i] = (unsigned char)((hi << bit_shift) | (lo >> (8 - bit_shift)));
+  }
+}
+
+/* HASH(K, A) (section 4.1 of RFC 7253). */
+static void ocb_hash(AesOcbContext *ctx, size_t aadsize,
+                     const unsigned char *aad, unsigned char sum[16]) {
+  unsigned char offset[16] = {0};
+  size_t full_size = aadsize - aadsize % 16;
+
+  memset(sum, 0, 16);
+  if (full_size)
+    ctx->ocb_vtable->hash_blocks(ctx, full_size, aad, 1, offset, sum);
+
+  if (aadsize % 16) {
+    unsigned char block[16] = {0};
+    memcpy(block, &aad[full_size], aadsize % 16);
+    block[aadsize % 16] = 0x80;
+
+    ocb_xor_block(offset, offset, ocb_l(ctx, OCB_L_STAR));
+    ocb_xor_block(block, block, offset);
+    ocb_encipher(ctx, block, block);
+    ocb_xor_block(sum, sum, block);
+  }
+}
+
+/* Encrypts or decrypts the final partial block & absorbs its plain text into
+ * the checksum. */
+static void ocb_final_block(AesOcbContext *ctx, size_t tail, unsigned char *out,
+                            const unsigned char *in, unsigned char offset[16],
+                            unsigned char checksum[16], bool encrypt) {
+  unsigned char pad[16], block[16] = {0};
+
+  ocb_xor_block(offset, offset, ocb_l(ctx, OCB_L_STAR));
+  ocb_encipher(ctx, pad, offset);
+
+  /* Read the plain text before it can be overwritten when out == in. */
+  if (encrypt)
+    memcpy(block, in, tail);
+  for (size_t i = 0; i < tail; ++i)
+    out[i] = in[i] ^ pad[i];
+  if (!encrypt)
+    memcpy(block, out, tail);
+
+  block[tail] = 0x80;
+  ocb_xor_block(checksum, checksum, block);
+}
+
+static void ocb_tag(AesOcbContext *ctx, size_t aadsize,
+                    const unsigned char *aad, const unsigned char offset[16],
+                    const unsigned char checksum[16], unsigned char tag[16]) {
+  unsigned char block[16], sum[16];
+
+  ocb_xor_block(block, checksum, offset);
+  ocb_xor_block(block, block, ocb_l(ctx, OCB_L_DOLLAR));
+  ocb_encipher(ctx, tag, block);
+
+  ocb_hash(ctx, aadsize, aad, sum);
+  ocb_xor_block(tag, tag, sum);
+}
+
+int aes_ocb_seal(AesOcbContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t aadsize, const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 unsigned char *tag) {
+  unsigned char offset[16], checksum[16] = {0}, full_tag[16];
+  size_t full_size = textsize - textsize % 16;
+
+  if (!ocb_sizes_are_valid(noncesize, tagsize) ||
+      !ocb_lengths_are_valid(textsize, aadsize))
+    return -1;
+
+  ocb_initial_offset(ctx, noncesize, nonce, tagsize, offset);
+  if (full_size)
+    ctx->ocb_vtable->encrypt_blocks(ctx, full_size, cipher_text, plain_text, 1,
+                                    offset, checksum);
+
+  if (textsize % 16)
+    ocb_final_block(ctx, textsize % 16, &cipher_text[full_size],
+                    &plain_text[full_size], offset, checksum, true);
+
+  ocb_tag(ctx, aadsize, aad, offset, checksum, full_tag);
+  memcpy(tag, full_tag, tagsize);
+  return 0;
+}
+
+int aes_ocb_open(AesOcbContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t aadsize,
+                 const unsigned char *aad, size_t noncesize,
+                 const unsigned char *nonce, size_t tagsize,
+                 const unsigned char *tag) {
+  unsigned char offset[16], checksum[16] = {0}, full_tag[16];
+  size_t full_size = textsize - textsize % 16;
+
+  if (!ocb_sizes_are_valid(noncesize, tagsize) ||
+      !ocb_lengths_are_valid(textsize, aadsize))
+    return -1;
+
+  ocb_initial_offset(ctx, noncesize, nonce, tagsize, offset);
+  if (full_size)
+    ctx->ocb_vtable->decrypt_blocks(ctx, full_size, plain_text, cipher_text, 1,
+                                    offset, checksum);
+
+  if (textsize % 16)
+    ocb_final_block(ctx, textsize % 16, &plain_text[full_size],
+                    &cipher_text[full_size], offset, checksum, false);
+
+  ocb_tag(ctx, aadsize, aad, offset, checksum, full_tag);
+  if (aes_ct_memcmp(full_tag, tag, tagsize) != 0) {
+    if (textsize)
+      memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+void aes_ofb_set_iv(AesOfbContext *ctx, const unsigned char iv[16]) {
+  memcpy(ctx->iv, iv, 16);
+  ctx->used = 16;
+  ctx->ring_start = 0;
+  ctx->ring_fill = 0;
+}
+
+void aes_ofb_set_ring(AesOfbContext *ctx, unsigned char *ring,
+                      size_t ring_size) {
+  ctx->ring = ring;
+  ctx->ring_size = ring ? ring_size : 0;
+  ctx->ring_start = 0;
+  ctx->ring_fill = 0;
+}
+
+/* The data path once the key stream is precomputed, 8 bytes at a time. */
+static void ofb_xor(size_t size, unsigned char *out, const unsigned char *in,
+                    const unsigned char *keystream) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t a, b;
+    memcpy(&a, &in[i], 8);
+    memcpy(&b, &keystream[i], 8);
+    a ^= b;
+    memcpy(&out[i], &a, 8);
+  }
+
+  for (; i < size; ++i)
+    out[i] = in[i] ^ keystream[i];
+}
+
+/* Generates the next `size` bytes of key stream, xored with `in` unless it is
+ * NULL. */
+static void ofb_generate(AesOfbContext *ctx, size_t size, unsigned char *out,
+                         const unsigned char *in) {
+  for (; size && ctx->used < 16; --size, ++ctx->used)
+    *out++ = (in ? *in++ : 0) ^ ctx->iv[ctx->used];
+
+  size_t full_size = size - size % 16;
+  if (full_size) {
+    if (in)
+      ctx->ofb_vtable->xcrypt(&ctx->aes, full_size, out, in, ctx->iv);
+    else
+      ctx->ofb_vtable->keystream(&ctx->aes, full_size, out, ctx->iv);
+  }
+
+  if (size % 16) {
+    ctx->aes.vtable->ecb_encrypt(&ctx->aes, 16, ctx->iv, ctx->iv);
+    ctx->used = 0;
+    ofb_generate(ctx, size % 16, &out[full_size], in ? &in[full_size] : NULL);
+  }
+}
+
+size_t aes_ofb_precompute(AesOfbContext *ctx) {
+  while (ctx->ring_fill < ctx->ring_size) {
+    size_t end = (ctx->ring_start + ctx->ring_fill) % ctx->ring_size;
+    size_t size = ctx->ring_size - ctx->ring_fill;
+    if (size > ctx->ring_size - end)
+      size = ctx->ring_size - end;
+
+    ofb_generate(ctx, size, &ctx->ring[end], NULL);
+    ctx->ring_fill += size;
+  }
+
+  return ctx->ring_fill;
+}
+
+void aes_ofb_xcrypt(AesOfbContext *ctx, size_t textsize, unsigned char *out,
+                    const unsigned char *in) {
+  while (textsize && ctx->ring_fill) {
+    size_t size = ctx->ring_size - ctx->ring_start;
+    if (size > ctx->ring_fill)
+      size = ctx->ring_fill;
+    if (size > textsize)
+      size = textsize;
+
+    ofb_xor(size, out, in, &ctx->ring[ctx->ring_start]);
+
+    ctx->ring_start = (ctx->ring_start + size) % ctx->ring_size;
+    ctx->ring_fill -= size;
+    out += size;
+    in += size;
+    textsize -= size;
+  }
+
+  if (textsize)
+    ofb_generate(ctx, textsize, out, in);
+}
@@ -0,0 +1,166 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* Layout of ctx->ocb.l_table; L(i) sits where OCB keeps L_{i - 2}. */
+#define PMAC_L_INV 0
+#define PMAC_L_0 2
+#define PMAC_NUM_L 32
+
+/* With L(0) to L(31), the blocks before the last one of a message are
+ * numbered below 2^32, so messages are at most 2^36 bytes. */
+#define PMAC_MAX_SIZE ((uint64_t)1 << 36)
+
+static const unsigned char *pmac_l(const AesPmacContext *ctx, size_t i) {
+  return &ctx->ocb.l_table[(PMAC_L_0 + i) * 16];
+}
+
+static void pmac_xor_block(unsigned char dest[16], const unsigned char a[16],
+                           const unsigned char b[16]) {
+  for (size_t i = 0; i < 16; ++i)
+    dest[i] = a[i] ^ b[i];
+}
+
+/* Multiplies a big-endian block by x^-1 in GF(2^128). */
+static void pmac_halve(unsigned char dest[16], const unsigned char src[16]) {
+  unsigned char carry = src[15] & 1;
+  for (size_t i = 15; i > 0; --i)
+    dest[i] = (unsigned char)((src[i] >> 1) | (src[i - 1] << 7));
+  dest[0] = (unsigned char)((src[0] >> 1) ^ (0x80 & -carry));
+  dest[15] ^= 0x43 & -carry;
+}
+
+void aes_pmac_init(AesPmacContext *ctx, enum AesKeyType key_type,
+                   const unsigned char *key) {
+  unsigned char *l_table = ctx->ocb.l_table;
+  unsigned char l[16];
+
+  /* The first entry of the OCB table is L(0) = E(K, 0). */
+  aes_ocb_init(&ctx->ocb, key_type, key);
+  memcpy(l, l_table, 16);
+
+  pmac_halve(&l_table[PMAC_L_INV * 16], l);
+  memset(&l_table[(PMAC_L_INV + 1) * 16], 0, 16);
+  memcpy(&l_table[PMAC_L_0 * 16], l, 16);
+  for (size_t i = PMAC_L_0 + 1; i < PMAC_L_0 + PMAC_NUM_L; ++i)
+    aes_gf128_double(&l_table[i * 16], &l_table[(i - 1) * 16]);
+}
+
+/* The offset after `nblocks` blocks is the xor of the L(i) for the bits i set
+ * in the Gray code of nblocks, so a chunk can start anywhere. */
+int aes_pmac_start(AesPmacContext *ctx, AesPmacState *state,
+                   uint64_t first_block) {
+  uint64_t gray = first_block ^ (first_block >> 1);
+
+  if (first_block >= PMAC_MAX_SIZE / 16)
+    return -1;
+
+  memset(state->offset, 0, 16);
+  for (size_t i = 0; i < PMAC_NUM_L; ++i) {
+    if (gray >> i & 1)
+      pmac_xor_block(state->offset, state->offset, pmac_l(ctx, i));
+  }
+
+  state->first_block = first_block;
+  state->next_block = first_block;
+  memset(state->sum, 0, 16);
+  state->buffersize = 0;
+  return 0;
+}
+
+static void pmac_blocks(AesPmacContext *ctx, AesPmacState *state,
+                        size_t size, const unsigned char *in) {
+  ctx->ocb.ocb_vtable->hash_blocks(&ctx->ocb, size, in, state->next_block + 1,
+                                   state->offset, state->sum);
+  state->next_block += size / 16;
+}
+
+/* Up to 16 bytes stay buffered, since the last block of the message is
+ * processed differently from the others. */
+int aes_pmac_update(AesPmacContext *ctx, AesPmacState *state, size_t size,
+                    const unsigned char *in) {
+  /* Bytes of the message up to the end of the chunk so far */
+  uint64_t end = state->next_block * 16 + state->buffersize;
+
+  if (size > PMAC_MAX_SIZE - end)
+    return -1;
+  if (!size)
+    return 0;
+
+  if (state->buffersize) {
+    size_t fill = 16 - state->buffersize;
+    if (fill > size)
+      fill = size;
+
+    memcpy(&state->buffer[state->buffersize], in, fill);
+    state->buffersize += fill;
+    in += fill;
+    size -= fill;
+    if (!size)
+      return 0;
+
+    pmac_blocks(ctx, state, 16, state->buffer);
+  }
+
+  size_t full_size = (size - 1) / 16 * 16;
+  if (full_size)
+    pmac_blocks(ctx, state, full_size, in);
+
+  state->buffersize = size - full_size;
+  memcpy(state->buffer, &in[full_size], state->buffersize);
+  return 0;
+}
+
+int aes_pmac_combine(AesPmacContext *ctx, AesPmacState *state,
+                     const AesPmacState *next) {
+  /* An empty chunk doesn't change the state. */
+  if (next->next_block == next->first_block && !next->buffersize)
+    return 0;
+
+  if (state->buffersize % 16 != 0 ||
+      state->next_block + state->buffersize / 16 != next->first_block)
+    return -1;
+
+  /* state didn't end the message after all. */
+  if (state->buffersize)
+    pmac_blocks(ctx, state, 16, state->buffer);
+
+  pmac_xor_block(state->sum, state->sum, next->sum);
+  memcpy(state->offset, next->offset, 16);
+  state->next_block = next->next_block;
+  memcpy(state->buffer, next->buffer, next->buffersize);
+  state->buffersize = next->buffersize;
+  return 0;
+}
+
+void aes_pmac_final(AesPmacContext *ctx, const AesPmacState *state,
+                    unsigned char mac[16]) {
+  unsigned char block[16];
+
+  if (state->buffersize == 16) {
+    pmac_xor_block(block, state->sum, state->buffer);
+    pmac_xor_block(block, block, &ctx->ocb.l_table[PMAC_L_INV * 16]);
+  } else {
+    memcpy(block, state->sum, 16);
+    for (size_t i = 0; i < state->buffersize; ++i)
+      block[i] ^= state->buffer[i];
+    block[state->buffersize] ^= 0x80;
+  }
+
+  ctx->ocb.aes.vtable->ecb_encrypt(&ctx->ocb.aes, 16, mac, block);
+}
+
+int aes_pmac(AesPmacContext *ctx, size_t size, const unsigned char *in,
+             unsigned char mac[16]) {
+  AesPmacState state;
+
+  aes_pmac_start(ctx, &state, 0);
+  if (aes_pmac_update(ctx, &state, size, in))
+    return -1;
+
+  aes_pmac_final(ctx, &state, mac);
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* S2V takes at most 127 strings, the last of which is the plain text. */
+#define SIV_MAX_AD 126
+
+/* Strings of associated data MACed together by one aes_cmac_multi() call. */
+#define SIV_AD_BATCH (2 * AES_CMAC_LANES)
+
+static void siv_xor_block(unsigned char *dest, const unsigned char *src) {
+  for (size_t i = 0; i < 16; ++i)
+    dest[i] ^= src[i];
+}
+
+/*
+ * S2V (RFC 5297, section 2.4). The CMACs of the strings of associated data are
+ * independent of each other, so they go through the CMAC lanes in batches;
+ * only the cheap doubling & XOR into D is serial. The plain text is MACed in
+ * place, except for the last one or two blocks, which hold the "xorend" of D.
+ */
+static void siv_s2v(AesSivContext *ctx, size_t nad, const AesSivData *ad,
+                    size_t textsize, const unsigned char *text,
+                    unsigned char v[16]) {
+  AesCmacContext *mac_ctx = &ctx->mac;
+  unsigned char d[16], chain[16] = {0}, last_blocks[32];
+
+  memcpy(d, ctx->d0, 16);
+  for (size_t i = 0; i < nad; i += SIV_AD_BATCH) {
+    AesCmacMessage messages[SIV_AD_BATCH];
+    unsigned char macs[SIV_AD_BATCH][16];
+    size_t nmessages = nad - i < SIV_AD_BATCH ? nad - i : SIV_AD_BATCH;
+
+    for (size_t j = 0; j < nmessages; ++j) {
+      messages[j].size = ad[i + j].size;
+      messages[j].in = ad[i + j].data;
+      messages[j].mac = macs[j];
+    }
+    aes_cmac_multi(mac_ctx, nmessages, messages);
+
+    for (size_t j = 0; j < nmessages; ++j) {
+      aes_gf128_double(d, d);
+      siv_xor_block(d, macs[j]);
+    }
+  }
+
+  size_t nlast_blocks;
+  if (textsize >= 16) {
+    /* Blocks before the last 16 to 31 bytes are untouched by the xorend. */
+    size_t nblocks = (textsize - 16) / 16;
+    size_t tail = textsize - nblocks * 16;
+    if (nblocks)
+      mac_ctx->cmac_vtable->cbc_mac_lanes(&mac_ctx->aes, 1, nblocks, &text,
+                                          chain);
+
+    memset(last_blocks, 0, sizeof last_blocks);
+    memcpy(last_blocks, &text[nblocks * 16], tail);
+    siv_xor_block(&last_blocks[tail - 16], d);
+    if (tail == 16) {
+      siv_xor_block(last_blocks, ctx->mac.k1);
+      nlast_blocks = 1;
+    } else {
+      last_blocks[tail] = 0x80;
+      siv_xor_block(&last_blocks[16], ctx->mac.k2);
+      nlast_blocks = 2;
+    }
+  } else {
+    /* dbl(D) xor pad(text), a complete block for CMAC */
+    aes_gf128_double(last_blocks, d);
+    for (size_t i = 0; i < textsize; ++i)
+      last_blocks[i] ^= text[i];
+    last_blocks[textsize] ^= 0x80;
+    siv_xor_block(last_blocks, ctx->mac.k1);
+    nlast_blocks = 1;
+  }
+
+  const unsigned char *last_in = last_blocks;
+  mac_ctx->cmac_vtable->cbc_mac_lanes(&mac_ctx->aes, 1, nlast_blocks, &last_in,
+                                      chain);
+  memcpy(v, chain, 16);
+}
+
+/* CTR from V with bits 31 & 63 cleared (RFC 5297, section 2.5). The 128-bit
+ * counter then never carries out of its last 64 bits, so the 64-bit counter
+ * kernels of CCM compute the same key stream. */
+static void siv_ctr(AesSivContext *ctx, size_t textsize, unsigned char *out,
+                    const unsigned char *in, const unsigned char v[16]) {
+  unsigned char q[16];
+
+  memcpy(q, v, 16);
+  q[8] &= 0x7f;
+  q[12] &= 0x7f;
+  ctx->ctr.ccm_vtable->ctr64_xcrypt(&ctx->ctr.aes, textsize, out, in, q);
+}
+
+void aes_siv_init(AesSivContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key) {
+  static const unsigned char zero[16] = {0};
+
+  aes_cmac_init(&ctx->mac, key_type, key);
+  aes_ccm_init(&ctx->ctr, key_type, &key[key_type / 8]);
+  aes_cmac(&ctx->mac, sizeof zero, zero, ctx->d0);
+}
+
+int aes_siv_seal(AesSivContext *ctx, size_t textsize,
+                 unsigned char *cipher_text, const unsigned char *plain_text,
+                 size_t nad, const AesSivData *ad, unsigned char siv[16]) {
+  if (nad > SIV_MAX_AD)
+    return -1;
+
+  siv_s2v(ctx, nad, ad, textsize, plain_text, siv);
+  siv_ctr(ctx, textsize, cipher_text, plain_text, siv);
+  return 0;
+}
+
+int aes_siv_open(AesSivContext *ctx, size_t textsize, unsigned char *plain_text,
+                 const unsigned char *cipher_text, size_t nad,
+                 const AesSivData *ad, const unsigned char siv[16]) {
+  unsigned char v[16];
+
+  if (nad > SIV_MAX_AD) {
+    memset(plain_text, 0, textsize);
+    return -1;
+  }
+
+  siv_ctr(ctx, textsize, plain_text, cipher_text, siv);
+  siv_s2v(ctx, nad, ad, textsize, plain_text, v);
+
+  if (aes_ct_memcmp(v, siv, 16)) {
+    memset(plain_text, 0, textsize);
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,203 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/*
+ * CTR & CBC over parts of any size. Only the bytes of a block split between
+ * two parts go through the context; the whole blocks of a part are handed to
+ * the kernels of the block cipher as they are.
+ */
+
+void aes_ctr_stream_set_iv(AesCtrStreamContext *ctx,
+                           const unsigned char iv[16]) {
+  memcpy(ctx->counter, iv, 16);
+  ctx->used = 16;
+}
+
+void aes_ctr_stream_init(AesCtrStreamContext *ctx, enum AesKeyType key_type,
+                         const unsigned char *key, const unsigned char iv[16]) {
+  aes_init(&ctx->aes, key_type, key);
+  aes_ctr_stream_set_iv(ctx, iv);
+}
+
+/* counter = iv + offset / 16, the block holding byte `offset` */
+static void ctr_counter_at(unsigned char counter[16],
+                           const unsigned char iv[16], uint64_t offset) {
+  uint64_t carry = offset / 16;
+
+  for (size_t i = 16; i--;) {
+    carry += iv[i];
+    counter[i] = (unsigned char)carry;
+    carry >>= 8;
+  }
+}
+
+/* The key stream block of the counter, which moves on to the next one */
+static void ctr_key_stream_block(AesContext *aes, unsigned char counter[16],
+                                 unsigned char key_stream[16]) {
+  memset(key_stream, 0, 16);
+  aes->vtable->ctr_xcrypt(aes, 16, key_stream, key_stream, counter, counter);
+}
+
+static size_t ctr_stream_partial(AesCtrStreamContext *ctx, size_t textsize,
+                                 unsigned char *out, const unsigned char *in) {
+  size_t size = 16 - ctx->used;
+  if (size > textsize)
+    size = textsize;
+
+  for (size_t i = 0; i < size; ++i)
+    out[i] = in[i] ^ ctx->key_stream[ctx->used++];
+
+  return size;
+}
+
+void aes_ctr_stream_update(AesCtrStreamContext *ctx, size_t textsize,
+                           unsigned char *out, const unsigned char *in) {
+  const struct aes_vtable *vtable = ctx->aes.vtable;
+
+  if (ctx->used < 16) {
+    size_t size = ctr_stream_partial(ctx, textsize, out, in);
+    out += size;
+    in += size;
+    textsize -= size;
+  }
+
+  size_t full_size = textsize - textsize % 16;
+  if (full_size)
+    vtable->ctr_xcrypt(&ctx->aes, full_size, out, in, ctx->counter,
+                       ctx->counter);
+
+  if (textsize % 16) {
+    ctr_key_stream_block(&ctx->aes, ctx->counter, ctx->key_stream);
+    ctx->used = 0;
+    ctr_stream_partial(ctx, textsize % 16, &out[full_size], &in[full_size]);
+  }
+}
+
+void aes_ctr_stream_seek(AesCtrStreamContext *ctx, const unsigned char iv[16],
+                         uint64_t offset) {
+  ctr_counter_at(ctx->counter, iv, offset);
+  ctx->used = 16;
+
+  if (offset % 16) {
+    ctr_key_stream_block(&ctx->aes, ctx->counter, ctx->key_stream);
+    ctx->used = offset % 16;
+  }
+}
+
+void aes_ctr_xcrypt_at(AesContext *ctx, const unsigned char iv[16],
+                       uint64_t offset, size_t textsize, unsigned char *out,
+                       const unsigned char *in) {
+  unsigned char counter[16];
+  ctr_counter_at(counter, iv, offset);
+
+  if (offset % 16 && textsize) {
+    unsigned char key_stream[16];
+    size_t skip = offset % 16, size = 16 - skip;
+    if (size > textsize)
+      size = textsize;
+
+    ctr_key_stream_block(ctx, counter, key_stream);
+    for (size_t i = 0; i < size; ++i)
+      out[i] = in[i] ^ key_stream[skip + i];
+    out += size;
+    in += size;
+    textsize -= size;
+  }
+
+  if (textsize)
+    ctx->vtable->ctr_xcrypt(ctx, textsize, out, in, counter, counter);
+}
+
+void aes_ctr_stream_final(AesCtrStreamContext *ctx) {
+  memset(ctx->key_stream, 0, 16);
+  ctx->used = 16;
+}
+
+void aes_cbc_stream_set_iv(AesCbcStreamContext *ctx,
+                           const unsigned char iv[16]) {
+  memcpy(ctx->iv, iv, 16);
+  ctx->buffered = 0;
+}
+
+void aes_cbc_stream_init(AesCbcStreamContext *ctx, enum AesKeyType key_type,
+                         const unsigned char *key, const unsigned char iv[16]) {
+  aes_init(&ctx->aes, key_type, key);
+  aes_cbc_stream_set_iv(ctx, iv);
+}
+
+/* Whole blocks, chained to ctx->iv, which becomes their last cipher text
+ * block. */
+static void cbc_stream_blocks(AesCbcStreamContext *ctx, size_t size,
+                              unsigned char *out, const unsigned char *in,
+                              bool encrypt) {
+  const struct aes_vtable *vtable = ctx->aes.vtable;
+
+  if (encrypt) {
+    vtable->cbc_encrypt(&ctx->aes, size, out, in, ctx->iv);
+    memcpy(ctx->iv, &out[size - 16], 16);
+  } else {
+    /* Saved first, as out may be equal to in. */
+    unsigned char last_block[16];
+    memcpy(last_block, &in[size - 16], 16);
+    vtable->cbc_decrypt(&ctx->aes, size, out, in, ctx->iv);
+    memcpy(ctx->iv, last_block, 16);
+  }
+}
+
+static size_t cbc_stream_update(AesCbcStreamContext *ctx, size_t textsize,
+                                unsigned char *out, const unsigned char *in,
+                                bool encrypt) {
+  size_t written = 0;
+
+  if (ctx->buffered) {
+    size_t size = 16 - ctx->buffered;
+    if (size > textsize)
+      size = textsize;
+
+    memcpy(&ctx->buffer[ctx->buffered], in, size);
+    ctx->buffered += size;
+    in += size;
+    textsize -= size;
+    if (ctx->buffered < 16)
+      return 0;
+
+    cbc_stream_blocks(ctx, 16, out, ctx->buffer, encrypt);
+    ctx->buffered = 0;
+    written = 16;
+  }
+
+  size_t full_size = textsize - textsize % 16;
+  if (full_size) {
+    cbc_stream_blocks(ctx, full_size, &out[written], in, encrypt);
+    written += full_size;
+  }
+
+  ctx->buffered = textsize % 16;
+  memcpy(ctx->buffer, &in[full_size], ctx->buffered);
+  return written;
+}
+
+size_t aes_cbc_stream_encrypt_update(AesCbcStreamContext *ctx, size_t textsize,
+                                     unsigned char *cipher_text,
+                                     const unsigned char *plain_text) {
+  return cbc_stream_update(ctx, textsize, cipher_text, plain_text, true);
+}
+
+size_t aes_cbc_stream_decrypt_update(AesCbcStreamContext *ctx, size_t textsize,
+                                     unsigned char *plain_text,
+                                     const unsigned char *cipher_text) {
+  return cbc_stream_update(ctx, textsize, plain_text, cipher_text, false);
+}
+
+int aes_cbc_stream_final(AesCbcStreamContext *ctx) {
+  int result = ctx->buffered ? -1 : 0;
+
+  memset(ctx->buffer, 0, 16);
+  ctx->buffered = 0;
+  return result;
+}
@@ -0,0 +1,123 @@
+#ifndef AY_AES_VAES_FIXED_KEY_INNER_H
+#define AY_AES_VAES_FIXED_KEY_INNER_H
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aes-ni.h"
+#include "inner.h"
+#include <ay/aes.h>
+
+/*
+ * Width-independent fixed-key hashing kernels for VAES, on the same vector
+ * descriptions `V` as the wide GCM kernels. Each iteration hashes
+ * FIXED_KEY_WIDE_VECS vectors (16 blocks on YMM, 32 on ZMM); the tail goes to
+ * the 128-bit kernel.
+ */
+
+#define FIXED_KEY_WIDE_VECS 8
+
+template <class V>
+static inline void fixed_key_wide_encrypt(const typename V::vec *round_keys,
+                                          unsigned char Nr,
+                                          typename V::vec *blocks) {
+  for (size_t v = 0; v < FIXED_KEY_WIDE_VECS; ++v)
+    blocks[v] = V::xor_(blocks[v], round_keys[0]);
+
+  for (size_t r = 1; r < Nr; ++r) {
+    for (size_t v = 0; v < FIXED_KEY_WIDE_VECS; ++v)
+      blocks[v] = V::aesenc(blocks[v], round_keys[r]);
+  }
+
+  for (size_t v = 0; v < FIXED_KEY_WIDE_VECS; ++v)
+    blocks[v] = V::aesenclast(blocks[v], round_keys[Nr]);
+}
+
+template <class V, enum aes_fixed_key_hash Hash>
+static size_t fixed_key_hash_wide(const AesContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  uint64_t tweak) {
+  typedef typename V::vec vec;
+  const size_t chunk_size = FIXED_KEY_WIDE_VECS * V::lanes * 16;
+  const __m128i *enc_ks = (const __m128i *)ctx->enc_round_keys;
+  const unsigned char Nr = ctx->Nr;
+  size_t nchunks = textsize / chunk_size;
+
+  vec round_keys[15];
+  for (size_t i = 0; i <= Nr; ++i)
+    round_keys[i] = V::broadcast(enc_ks[i]);
+
+  const vec low_half = V::broadcast(_mm_set_epi64x(0, -1));
+
+  for (size_t c = 0; c < nchunks; ++c) {
+    const unsigned char *chunk_in = &in[c * chunk_size];
+    unsigned char *chunk_out = &out[c * chunk_size];
+    vec x[FIXED_KEY_WIDE_VECS], y[FIXED_KEY_WIDE_VECS];
+
+    for (size_t v = 0; v < FIXED_KEY_WIDE_VECS; ++v) {
+      x[v] = V::loadu(&chunk_in[v * V::lanes * 16]);
+      /* sigma(L || R) = (L ^ R) || L in each lane */
+      if (Hash == AES_FIXED_KEY_CCR)
+        x[v] = V::xor_(V::swap_halves(x[v]), V::and_(x[v], low_half));
+      y[v] = x[v];
+    }
+
+    fixed_key_wide_encrypt<V>(round_keys, Nr, y);
+
+    if (Hash == AES_FIXED_KEY_TCCR) {
+      uint64_t chunk_tweak = tweak + c * FIXED_KEY_WIDE_VECS * V::lanes;
+      for (size_t v = 0; v < FIXED_KEY_WIDE_VECS; ++v) {
+        vec tweaks = V::add_epi64(
+            V::broadcast(_mm_set_epi64x(
+                0, (long long)(chunk_tweak + v * V::lanes))),
+            V::lane_index());
+        x[v] = y[v];
+        y[v] = V::xor_(y[v], tweaks);
+      }
+
+      fixed_key_wide_encrypt<V>(round_keys, Nr, y);
+    }
+
+    for (size_t v = 0; v < FIXED_KEY_WIDE_VECS; ++v)
+      V::storeu(&chunk_out[v * V::lanes * 16], V::xor_(y[v], x[v]));
+  }
+
+  return nchunks * chunk_size;
+}
+
+/* Entry points of one vector width: the wide kernel, then the 128-bit kernel
+ * for the tail (less than a chunk). */
+template <class V>
+static inline void fixed_key_wide_cr(const AesContext *ctx, size_t textsize,
+                                     unsigned char *out,
+                                     const unsigned char *in) {
+  size_t done =
+      fixed_key_hash_wide<V, AES_FIXED_KEY_CR>(ctx, textsize, out, in, 0);
+  if (done < textsize)
+    aesni_fixed_key_cr(ctx, textsize - done, &out[done], &in[done]);
+}
+
+template <class V>
+static inline void fixed_key_wide_ccr(const AesContext *ctx, size_t textsize,
+                                      unsigned char *out,
+                                      const unsigned char *in) {
+  size_t done =
+      fixed_key_hash_wide<V, AES_FIXED_KEY_CCR>(ctx, textsize, out, in, 0);
+  if (done < textsize)
+    aesni_fixed_key_ccr(ctx, textsize - done, &out[done], &in[done]);
+}
+
+template <class V>
+static inline void fixed_key_wide_tccr(const AesContext *ctx, size_t textsize,
+                                       unsigned char *out,
+                                       const unsigned char *in,
+                                       uint64_t tweak) {
+  size_t done = fixed_key_hash_wide<V, AES_FIXED_KEY_TCCR>(ctx, textsize, out,
+                                                           in, tweak);
+  if (done < textsize)
+    aesni_fixed_key_tccr(ctx, textsize - done, &out[done], &in[done],
+                         tweak + done / 16);
+}
+
+#endif /* AY_AES_VAES_FIXED_KEY_INNER_H */
@@ -0,0 +1,322 @@
+#ifndef AY_AES_VAES_GCM_INNER_H
+#define AY_AES_VAES_GCM_INNER_H
+
+#include <immintrin.h>
+#include <stddef.h>
+
+#include "aes-ni-inner.h"
+#include "aes-ni.h"
+#include <ay/aes.h>
+
+/*
+ * Width-independent GCM kernel for VAES + VPCLMULQDQ.
+ *
+ * `V` describes a vector of `V::lanes` 128-bit blocks (2 for YMM, 4 for ZMM)
+ * and is instantiated once per translation unit, each compiled with the
+ * matching -m flags. The kernel processes GCM_WIDE_BLOCKS blocks per iteration
+ * and uses the same h_table as the 128-bit kernel in aes-ni-gcm.cpp (POLYVAL
+ * form, H^1..H^16 at [0, 16)), so the contexts are interchangeable. Anything
+ * shorter than a full chunk is left to the 128-bit kernel.
+ */
+
+/** @brief Number of blocks hashed per reduction by the wide kernels */
+#define GCM_WIDE_BLOCKS 16
+
+/* Unreduced schoolbook products, one per lane. */
+template <class V> struct ghash_wide_acc {
+  typename V::vec lo, mid, hi;
+};
+
+template <class V>
+static inline void ghash_wide_acc_mul(ghash_wide_acc<V> *acc,
+                                      typename V::vec x, typename V::vec h) {
+  acc->lo = V::xor_(acc->lo, V::template clmul<0x00>(x, h));
+  acc->hi = V::xor_(acc->hi, V::template clmul<0x11>(x, h));
+  acc->mid = V::xor_(acc->mid, V::xor_(V::template clmul<0x01>(x, h),
+                                       V::template clmul<0x10>(x, h)));
+}
+
+/* Sums the lanes and does the Montgomery reduction of aes-ni-gcm.cpp. */
+template <class V>
+static inline __m128i ghash_wide_acc_reduce(const ghash_wide_acc<V> *acc) {
+  const __m128i poly = _mm_set_epi64x((long long)0xc200000000000000ULL, 1);
+
+  __m128i mid = V::fold(acc->mid);
+  __m128i lo = _mm_xor_si128(V::fold(acc->lo), _mm_slli_si128(mid, 8));
+  __m128i hi = _mm_xor_si128(V::fold(acc->hi), _mm_srli_si128(mid, 8));
+
+  __m128i t = _mm_clmulepi64_si128(lo, poly, 0x10);
+  lo = _mm_xor_si128(_mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)), t);
+  t = _mm_clmulepi64_si128(lo, poly, 0x10);
+  lo = _mm_xor_si128(_mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)), t);
+
+  return _mm_xor_si128(hi, lo);
+}
+
+/* State shared by the loops of one call: broadcast round keys and the powers
+ * of H in the lane order of a chunk (H^16, H^15, ... for block 0, 1, ...). */
+template <class V> struct gcm_wide_keys {
+  static const size_t nvec = GCM_WIDE_BLOCKS / V::lanes;
+
+  typename V::vec round_keys[15];
+  typename V::vec hpow[nvec];
+};
+
+template <class V>
+static inline void gcm_wide_hpow_init(typename V::vec *hpow,
+                                      const unsigned char *h_table) {
+  const __m128i *htab = (const __m128i *)h_table;
+
+  for (size_t v = 0; v < gcm_wide_keys<V>::nvec; ++v)
+    hpow[v] = V::reverse_lanes(
+        V::loadu(&htab[GCM_WIDE_BLOCKS - (v + 1) * V::lanes]));
+}
+
+template <class V>
+static inline void gcm_wide_keys_init(gcm_wide_keys<V> *keys,
+                                      const AesGcmContext *ctx) {
+  const __m128i *enc_ks = (const __m128i *)ctx->aes.enc_round_keys;
+
+  for (size_t i = 0; i <= ctx->aes.Nr; ++i)
+    keys->round_keys[i] = V::broadcast(enc_ks[i]);
+
+  gcm_wide_hpow_init<V>(keys->hpow, ctx->h_table);
+}
+
+/* s' = (s ^ x_0) * H^16 ^ ... ^ x_15 * H for the byte-reversed chunk x. */
+template <class V>
+static inline __m128i ghash_wide_chunk(const typename V::vec *hpow, __m128i s,
+                                       const typename V::vec *x) {
+  ghash_wide_acc<V> acc;
+  acc.lo = acc.mid = acc.hi = V::zero();
+
+  ghash_wide_acc_mul<V>(&acc, V::xor_(x[0], V::from_lane0(s)), hpow[0]);
+  for (size_t v = 1; v < gcm_wide_keys<V>::nvec; ++v)
+    ghash_wide_acc_mul<V>(&acc, x[v], hpow[v]);
+
+  return ghash_wide_acc_reduce<V>(&acc);
+}
+
+/* Hashes whole chunks, returns the number of bytes consumed. GHASH
+ * byte-reverses the blocks & the running value, POLYVAL takes them as is. */
+template <class V, bool ByteReverse>
+static size_t ghash_wide(const unsigned char *h_table, unsigned char xi[16],
+                         size_t textsize, const unsigned char *in) {
+  const size_t nvec = gcm_wide_keys<V>::nvec;
+  size_t nchunks = textsize / (GCM_WIDE_BLOCKS * 16);
+  if (!nchunks)
+    return 0;
+
+  typename V::vec hpow[nvec];
+  gcm_wide_hpow_init<V>(hpow, h_table);
+
+  __m128i s = _mm_loadu_si128((const __m128i *)xi);
+  if (ByteReverse)
+    s = m128i_bswap(s);
+  for (size_t c = 0; c < nchunks; ++c) {
+    typename V::vec x[nvec];
+    for (size_t v = 0; v < nvec; ++v) {
+      x[v] = V::loadu(&in[(c * nvec + v) * V::lanes * 16]);
+      if (ByteReverse)
+        x[v] = V::bswap(x[v]);
+    }
+
+    s = ghash_wide_chunk<V>(hpow, s, x);
+  }
+  if (ByteReverse)
+    s = m128i_bswap(s);
+  _mm_storeu_si128((__m128i *)xi, s);
+
+  return nchunks * GCM_WIDE_BLOCKS * 16;
+}
+
+/* Encrypts one chunk of counter blocks, issuing the multiplications for the
+ * byte-reversed chunk hash_in (hash_in[0] includes s in lane 0) between the
+ * AES rounds. */
+template <class V>
+static inline __m128i gcm_wide_encrypt_ghash(const gcm_wide_keys<V> *keys,
+                                             unsigned char Nr,
+                                             typename V::vec *blocks,
+                                             const typename V::vec *hash_in) {
+  const size_t nvec = gcm_wide_keys<V>::nvec;
+  ghash_wide_acc<V> acc;
+  acc.lo = acc.mid = acc.hi = V::zero();
+
+  for (size_t v = 0; v < nvec; ++v)
+    blocks[v] = V::xor_(blocks[v], keys->round_keys[0]);
+
+  /* nvec <= 8 < Nr, so one multiplication per round is enough. */
+  for (size_t r = 1; r <= nvec; ++r) {
+    for (size_t v = 0; v < nvec; ++v)
+      blocks[v] = V::aesenc(blocks[v], keys->round_keys[r]);
+
+    ghash_wide_acc_mul<V>(&acc, hash_in[r - 1], keys->hpow[r - 1]);
+  }
+
+  for (size_t r = nvec + 1; r < Nr; ++r) {
+    for (size_t v = 0; v < nvec; ++v)
+      blocks[v] = V::aesenc(blocks[v], keys->round_keys[r]);
+  }
+
+  for (size_t v = 0; v < nvec; ++v)
+    blocks[v] = V::aesenclast(blocks[v], keys->round_keys[Nr]);
+
+  return ghash_wide_acc_reduce<V>(&acc);
+}
+
+template <class V>
+static inline void gcm_wide_encrypt(const gcm_wide_keys<V> *keys,
+                                    unsigned char Nr, typename V::vec *blocks) {
+  const size_t nvec = gcm_wide_keys<V>::nvec;
+
+  for (size_t v = 0; v < nvec; ++v)
+    blocks[v] = V::xor_(blocks[v], keys->round_keys[0]);
+
+  for (size_t r = 1; r < Nr; ++r) {
+    for (size_t v = 0; v < nvec; ++v)
+      blocks[v] = V::aesenc(blocks[v], keys->round_keys[r]);
+  }
+
+  for (size_t v = 0; v < nvec; ++v)
+    blocks[v] = V::aesenclast(blocks[v], keys->round_keys[Nr]);
+}
+
+/* Fills one chunk of counter blocks, ctr being the byte-reversed counter. */
+template <class V>
+static inline __m128i gcm_wide_next_counters(__m128i ctr,
+                                             typename V::vec *blocks) {
+  const typename V::vec step = V::broadcast(_mm_set_epi32(0, 0, 0, V::lanes));
+  typename V::vec ctrs = V::add_epi32(V::broadcast(ctr), V::lane_index());
+
+  for (size_t v = 0; v < gcm_wide_keys<V>::nvec; ++v) {
+    blocks[v] = V::bswap(ctrs);
+    ctrs = V::add_epi32(ctrs, step);
+  }
+
+  return _mm_add_epi32(ctr, _mm_set_epi32(0, 0, 0, GCM_WIDE_BLOCKS));
+}
+
+/*
+ * Stitched CTR32 + GHASH over whole chunks, with the same schedule as
+ * gcm_ctr32_ghash() in aes-ni-gcm.cpp. Returns the number of bytes processed;
+ * xi & counter are updated so that the caller can finish with the 128-bit
+ * kernel.
+ */
+template <class V, bool Encrypt>
+static size_t gcm_ctr32_ghash_wide(const AesGcmContext *ctx, size_t textsize,
+                                   unsigned char *out, const unsigned char *in,
+                                   unsigned char counter[16],
+                                   unsigned char xi[16]) {
+  const size_t nvec = gcm_wide_keys<V>::nvec;
+  const size_t chunk_size = GCM_WIDE_BLOCKS * 16;
+  const size_t vec_size = V::lanes * 16;
+  const unsigned char Nr = ctx->aes.Nr;
+
+  size_t nchunks = textsize / chunk_size;
+  if (!nchunks)
+    return 0;
+
+  gcm_wide_keys<V> keys;
+  gcm_wide_keys_init<V>(&keys, ctx);
+
+  __m128i s = m128i_bswap(_mm_loadu_si128((const __m128i *)xi));
+  __m128i ctr = m128i_bswap(_mm_loadu_si128((const __m128i *)counter));
+
+  typename V::vec blocks[nvec];
+  typename V::vec hash_in[nvec];
+  size_t c = 0;
+
+  if (Encrypt) {
+    /* Nothing to hash yet for the first chunk. */
+    ctr = gcm_wide_next_counters<V>(ctr, blocks);
+    gcm_wide_encrypt<V>(&keys, Nr, blocks);
+
+    for (size_t v = 0; v < nvec; ++v) {
+      typename V::vec out_block =
+          V::xor_(blocks[v], V::loadu(&in[v * vec_size]));
+      V::storeu(&out[v * vec_size], out_block);
+      hash_in[v] = V::bswap(out_block);
+    }
+    c = 1;
+  }
+
+  for (; c < nchunks; ++c) {
+    const unsigned char *chunk_in = &in[c * chunk_size];
+    unsigned char *chunk_out = &out[c * chunk_size];
+
+    ctr = gcm_wide_next_counters<V>(ctr, blocks);
+
+    if (!Encrypt) {
+      for (size_t v = 0; v < nvec; ++v)
+        hash_in[v] = V::bswap(V::loadu(&chunk_in[v * vec_size]));
+    }
+    hash_in[0] = V::xor_(hash_in[0], V::from_lane0(s));
+
+    s = gcm_wide_encrypt_ghash<V>(&keys, Nr, blocks, hash_in);
+
+    for (size_t v = 0; v < nvec; ++v) {
+      typename V::vec out_block =
+          V::xor_(blocks[v], V::loadu(&chunk_in[v * vec_size]));
+      V::storeu(&chunk_out[v * vec_size], out_block);
+
+      if (Encrypt)
+        hash_in[v] = V::bswap(out_block);
+    }
+  }
+
+  if (Encrypt)
+    s = ghash_wide_chunk<V>(keys.hpow, s, hash_in);
+
+  _mm_storeu_si128((__m128i *)xi, m128i_bswap(s));
+  _mm_storeu_si128((__m128i *)counter, m128i_bswap(ctr));
+
+  return nchunks * chunk_size;
+}
+
+/* Entry points of one vector width: the wide kernels, then the 128-bit kernel
+ * for the tail (less than a chunk). */
+template <class V>
+static inline void wide_ghash(const unsigned char *h_table,
+                              unsigned char xi[16], size_t textsize,
+                              const unsigned char *in) {
+  size_t done = ghash_wide<V, true>(h_table, xi, textsize, in);
+  if (done < textsize)
+    aesni_ghash(h_table, xi, textsize - done, &in[done]);
+}
+
+template <class V>
+static inline void wide_polyval(const unsigned char *h_table,
+                                unsigned char s[16], size_t textsize,
+                                const unsigned char *in) {
+  size_t done = ghash_wide<V, false>(h_table, s, textsize, in);
+  if (done < textsize)
+    aesni_polyval(h_table, s, textsize - done, &in[done]);
+}
+
+template <class V>
+static inline void gcm_wide_ctr32_encrypt(const AesGcmContext *ctx,
+                                          size_t textsize, unsigned char *out,
+                                          const unsigned char *in,
+                                          unsigned char counter[16],
+                                          unsigned char xi[16]) {
+  size_t done =
+      gcm_ctr32_ghash_wide<V, true>(ctx, textsize, out, in, counter, xi);
+  if (done < textsize)
+    aesni_gcm_ctr32_encrypt(ctx, textsize - done, &out[done], &in[done],
+                            counter, xi);
+}
+
+template <class V>
+static inline void gcm_wide_ctr32_decrypt(const AesGcmContext *ctx,
+                                          size_t textsize, unsigned char *out,
+                                          const unsigned char *in,
+                                          unsigned char counter[16],
+                                          unsigned char xi[16]) {
+  size_t done =
+      gcm_ctr32_ghash_wide<V, false>(ctx, textsize, out, in, counter, xi);
+  if (done < textsize)
+    aesni_gcm_ctr32_decrypt(ctx, textsize - done, &out[done], &in[done],
+                            counter, xi);
+}
+
+#endif /* AY_AES_VAES_GCM_INNER_H */
@@ -0,0 +1,83 @@
+#ifndef AY_AES_VAES_H
+#define AY_AES_VAES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ay/aes/hedley.h>
+
+HEDLEY_BEGIN_C_DECLS
+
+#include <ay/aes.h>
+
+/*
+ * Wide GCM kernels on VAES + VPCLMULQDQ. They use the AES-NI key schedule and
+ * the h_table of aesni_gcm_init() (of aesni_polyval_init_wide() for POLYVAL),
+ * so only the bulk functions differ from the 128-bit AES-NI engine.
+ */
+
+/* 256-bit vectors, needs AVX2. */
+void aesvaes256_ghash(const unsigned char *h_table, unsigned char xi[16],
+                     size_t textsize, const unsigned char *in);
+
+void aesvaes256_polyval(const unsigned char *h_table, unsigned char s[16],
+                       size_t textsize, const unsigned char *in);
+
+void aesvaes256_gcm_ghash(const AesGcmContext *ctx, unsigned char xi[16],
+                          size_t textsize, const unsigned char *in);
+
+void aesvaes256_gcm_ctr32_encrypt(const AesGcmContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char counter[16],
+                                  unsigned char xi[16]);
+
+void aesvaes256_gcm_ctr32_decrypt(const AesGcmContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char counter[16],
+                                  unsigned char xi[16]);
+
+/* 512-bit vectors, needs AVX512F, AVX512BW & AVX512VL. */
+void aesvaes512_ghash(const unsigned char *h_table, unsigned char xi[16],
+                     size_t textsize, const unsigned char *in);
+
+void aesvaes512_polyval(const unsigned char *h_table, unsigned char s[16],
+                       size_t textsize, const unsigned char *in);
+
+void aesvaes512_gcm_ghash(const AesGcmContext *ctx, unsigned char xi[16],
+                          size_t textsize, const unsigned char *in);
+
+void aesvaes512_gcm_ctr32_encrypt(const AesGcmContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char counter[16],
+                                  unsigned char xi[16]);
+
+void aesvaes512_gcm_ctr32_decrypt(const AesGcmContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char counter[16],
+                                  unsigned char xi[16]);
+
+/* Fixed-key hashing kernels (see struct aes_fixed_key_vtable), on the AES-NI
+ * key schedule; they only need VAES besides AVX2 or AVX-512. */
+void aesvaes256_fixed_key_cr(const AesContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in);
+
+void aesvaes256_fixed_key_ccr(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in);
+
+void aesvaes256_fixed_key_tccr(const AesContext *ctx, size_t textsize,
+                               unsigned char *out, const unsigned char *in,
+                               uint64_t tweak);
+
+void aesvaes512_fixed_key_cr(const AesContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in);
+
+void aesvaes512_fixed_key_ccr(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in);
+
+void aesvaes512_fixed_key_tccr(const AesContext *ctx, size_t textsize,
+                               unsigned char *out, const unsigned char *in,
+                               uint64_t tweak);
+
+HEDLEY_END_C_DECLS
+
+#endif /* AY_AES_VAES_H */
@@ -0,0 +1,29 @@
+#include <immintrin.h>
+
+#include "aes-vaes-fixed-key-inner.h"
+#include "aes-vaes.h"
+#include "aes-vaes256-inner.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesvaes256_fixed_key_cr(const AesContext *ctx, size_t textsize,
+                            unsigned char *out, const unsigned char *in) {
+  fixed_key_wide_cr<vaes256>(ctx, textsize, out, in);
+}
+
+void aesvaes256_fixed_key_ccr(const AesContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in) {
+  fixed_key_wide_ccr<vaes256>(ctx, textsize, out, in);
+}
+
+void aesvaes256_fixed_key_tccr(const AesContext *ctx, size_t textsize,
+                              unsigned char *out, const unsigned char *in,
+                              uint64_t tweak) {
+  fixed_key_wide_tccr<vaes256>(ctx, textsize, out, in, tweak);
+}
+
+#ifdef __cplusplus
+}
+#endif
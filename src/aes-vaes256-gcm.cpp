@@ -0,0 +1,42 @@
+#include <immintrin.h>
+
+#include "aes-vaes-gcm-inner.h"
+#include "aes-vaes.h"
+#include "aes-vaes256-inner.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void aesvaes256_ghash(const unsigned char *h_table, unsigned char xi[16],
+                     size_t textsize, const unsigned char *in) {
+  wide_ghash<vaes256>(h_table, xi, textsize, in);
+}
+
+void aesvaes256_polyval(const unsigned char *h_table, unsigned char s[16],
+                       size_t textsize, const unsigned char *in) {
+  wide_polyval<vaes256>(h_table, s, textsize, in);
+}
+
+void aesvaes256_gcm_ghash(const AesGcmContext *ctx, unsigned char xi[16],
+                          size_t textsize, const unsigned char *in) {
+  aesvaes256_ghash(ctx->h_table, xi, textsize, in);
+}
+
+void aesvaes256_gcm_ctr32_encrypt(const AesGcmContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char counter[16],
+                                  unsigned char xi[16]) {
+  gcm_wide_ctr32_encrypt<vaes256>(ctx, textsize, out, in, counter, xi);
+}
+
+void aesvaes256_gcm_ctr32_decrypt(const AesGcmContext *ctx, size_t textsize,
+                                  unsigned char *out, const unsigned char *in,
+                                  unsigned char counter[16],
+                                  unsigned char xi[16]) {
+  gcm_wide_ctr32_decrypt<vaes256>(ctx, textsize, out, in, counter, xi);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+#ifndef AY_AES_VAES256_INNER_H
+#define AY_AES_VAES256_INNER_H
+
+#include <immintrin.h>
+#include <stddef.h>
+
+/* Two blocks per YMM register (VAES, VPCLMULQDQ & AVX2). */
+struct vaes256 {
+  typedef __m256i vec;
+  static const size_t lanes = 2;
+
+  static inline vec zero() { return _mm256_setzero_si256(); }
+  static inline vec loadu(const void *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+  }
+  static inline void storeu(void *p, vec x) {
+    _mm256_storeu_si256((__m256i *)p, x);
+  }
+  static inline vec xor_(vec a, vec b) { return _mm256_xor_si256(a, b); }
+  static inline vec add_epi32(vec a, vec b) { return _mm256_add_epi32(a, b); }
+  static inline vec add_epi64(vec a, vec b) { return _mm256_add_epi64(a, b); }
+  static inline vec and_(vec a, vec b) { return _mm256_and_si256(a, b); }
+
+  static inline vec aesenc(vec x, vec k) { return _mm256_aesenc_epi128(x, k); }
+  static inline vec aesenclast(vec x, vec k) {
+    return _mm256_aesenclast_epi128(x, k);
+  }
+
+  template <int imm> static inline vec clmul(vec a, vec b) {
+    return _mm256_clmulepi64_epi128(a, b, imm);
+  }
+
+  static inline vec broadcast(__m128i x) {
+    return _mm256_broadcastsi128_si256(x);
+  }
+  static inline vec from_lane0(__m128i x) {
+    return _mm256_inserti128_si256(_mm256_setzero_si256(), x, 0);
+  }
+  static inline vec lane_index() {
+    return _mm256_set_epi32(0, 0, 0, 1, 0, 0, 0, 0);
+  }
+  static inline vec reverse_lanes(vec x) {
+    return _mm256_permute2x128_si256(x, x, 0x01);
+  }
+  /* Swaps the 64-bit halves of each lane. */
+  static inline vec swap_halves(vec x) {
+    return _mm256_shuffle_epi32(x, 0x4e);
+  }
+  static inline vec bswap(vec x) {
+    const vec reverse_order = broadcast(
+        _mm_set_epi32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f));
+    return _mm256_shuffle_epi8(x, reverse_order);
+  }
+
+  /* XOR of both lanes. */
+  static inline __m128i fold(vec x) {
+    return _mm_xor_si128(_mm256_castsi256_si128(x),
+                         _mm256_extracti128_si256(x, 1));
+  }
+};
+
+#endif /* AY_AES_VAES256_INNER_H */
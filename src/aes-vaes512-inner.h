@@ -0,0 +1,59 @@
+#ifndef AY_AES_VAES512_INNER_H
+#define AY_AES_VAES512_INNER_H
+
+#include <immintrin.h>
+#include <stddef.h>
+
+/* Four blocks per ZMM register (VAES, VPCLMULQDQ, AVX512F & AVX512BW). */
+struct vaes512 {
+  typedef __m512i vec;
+  static const size_t lanes = 4;
+
+  static inline vec zero() { return _mm512_setzero_si512(); }
+  static inline vec loadu(const void *p) { return _mm512_loadu_si512(p); }
+  static inline void storeu(void *p, vec x) { _mm512_storeu_si512(p, x); }
+  static inline vec xor_(vec a, vec b) { return _mm512_xor_si512(a, b); }
+  static inline vec add_epi32(vec a, vec b) { return _mm512_add_epi32(a, b); }
+  static inline vec add_epi64(vec a, vec b) { return _mm512_add_epi64(a, b); }
+  static inline vec and_(vec a, vec b) { return _mm512_and_si512(a, b); }
+
+  static inline vec aesenc(vec x, vec k) { return _mm512_aesenc_epi128(x, k); }
+  static inline vec aesenclast(vec x, vec k) {
+    return _mm512_aesenclast_epi128(x, k);
+  }
+
+  template <int imm> static inline vec clmul(vec a, vec b) {
+    return _mm512_clmulepi64_epi128(a, b, imm);
+  }
+
+  static inline vec broadcast(__m128i x) { return _mm512_broadcast_i32x4(x); }
+  static inline vec from_lane0(__m128i x) {
+    return _mm512_inserti32x4(_mm512_setzero_si512(), x, 0);
+  }
+  static inline vec lane_index() {
+    return _mm512_set_epi32(0, 0, 0, 3, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 0);
+  }
+  static inline vec reverse_lanes(vec x) {
+    return _mm512_shuffle_i64x2(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+  }
+  /* Swaps the 64-bit halves of each lane. */
+  static inline vec swap_halves(vec x) {
+    return _mm512_shuffle_epi32(x, _MM_PERM_BADC);
+  }
+  static inline vec bswap(vec x) {
+    const vec reverse_order = broadcast(
+        _mm_set_epi32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f));
+    return _mm512_shuffle_epi8(x, reverse_order);
+  }
+
+  /* XOR of all the lanes. */
+  static inline __m128i fold(vec x) {
+    x = _mm512_xor_si512(x,
+                         _mm512_shuffle_i64x2(x, x, _MM_SHUFFLE(1, 0, 3, 2)));
+    __m256i y = _mm512_castsi512_si256(x);
+    return _mm_xor_si128(_mm256_castsi256_si128(y),
+                         _mm256_extracti128_si256(y, 1));
+  }
+};
+
+#endif /* AY_AES_VAES512_INNER_H */
@@ -0,0 +1,164 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "inner.h"
+#include <ay/aes.h>
+
+/* Number of sector tweaks encrypted together by the sector functions. */
+#define XTS_SECTOR_BATCH 8
+
+static void xts_encrypt_tweak(AesXtsContext *ctx, unsigned char out[16],
+                              const unsigned char tweak[16]) {
+  ctx->tweak_key.vtable->ecb_encrypt(&ctx->tweak_key, 16, out, tweak);
+}
+
+/* Encrypts one data unit with the already encrypted tweak t (IEEE 1619,
+ * section 5.3.2). */
+static void xts_encrypt_unit(AesXtsContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char t[16]) {
+  size_t tail = textsize % 16;
+  size_t full_size = textsize - tail;
+
+  if (!tail) {
+    ctx->xts_vtable->encrypt_blocks(&ctx->data_key, full_size, out, in, t);
+    return;
+  }
+
+  /* All blocks but the last full one, which is stolen from. */
+  full_size -= 16;
+  ctx->xts_vtable->encrypt_blocks(&ctx->data_key, full_size, out, in, t);
+
+  unsigned char cc[16], pp[16];
+  ctx->xts_vtable->encrypt_blocks(&ctx->data_key, 16, cc, &in[full_size], t);
+
+  memcpy(pp, &in[full_size + 16], tail);
+  memcpy(&pp[tail], &cc[tail], 16 - tail);
+  memcpy(&out[full_size + 16], cc, tail);
+
+  ctx->xts_vtable->encrypt_blocks(&ctx->data_key, 16, &out[full_size], pp, t);
+}
+
+/* Decrypts one data unit with the already encrypted tweak t (IEEE 1619,
+ * section 5.4.2). */
+static void xts_decrypt_unit(AesXtsContext *ctx, size_t textsize,
+                             unsigned char *out, const unsigned char *in,
+                             unsigned char t[16]) {
+  size_t tail = textsize % 16;
+  size_t full_size = textsize - tail;
+
+  if (!tail) {
+    ctx->xts_vtable->decrypt_blocks(&ctx->data_key, full_size, out, in, t);
+    return;
+  }
+
+  full_size -= 16;
+  ctx->xts_vtable->decrypt_blocks(&ctx->data_key, full_size, out, in, t);
+
+  /* The last full cipher text block was encrypted with the tweak after t. */
+  unsigned char t_next[16], pp[16], cc[16];
+  memcpy(t_next, t, 16);
+  aes_xts_mul_alpha(t_next);
+  ctx->xts_vtable->decrypt_blocks(&ctx->data_key, 16, pp, &in[full_size],
+                                  t_next);
+
+  memcpy(cc, &in[full_size + 16], tail);
+  memcpy(&cc[tail], &pp[tail], 16 - tail);
+  memcpy(&out[full_size + 16], pp, tail);
+
+  ctx->xts_vtable->decrypt_blocks(&ctx->data_key, 16, &out[full_size], cc, t);
+}
+
+int aes_xts_encrypt(AesXtsContext *ctx, size_t textsize,
+                    unsigned char *cipher_text,
+                    const unsigned char *plain_text,
+                    const unsigned char tweak[16]) {
+  unsigned char t[16];
+
+  /* Ciphertext stealing needs a full block to steal from. */
+  if (textsize < 16)
+    return -1;
+
+  xts_encrypt_tweak(ctx, t, tweak);
+  xts_encrypt_unit(ctx, textsize, cipher_text, plain_text, t);
+  return 0;
+}
+
+int aes_xts_decrypt(AesXtsContext *ctx, size_t textsize,
+                    unsigned char *plain_text,
+                    const unsigned char *cipher_text,
+                    const unsigned char tweak[16]) {
+  unsigned char t[16];
+
+  if (textsize < 16)
+    return -1;
+
+  xts_encrypt_tweak(ctx, t, tweak);
+  xts_decrypt_unit(ctx, textsize, plain_text, cipher_text, t);
+  return 0;
+}
+
+/* Encrypts the tweaks of `count` sectors starting at `sector` in one call. */
+static void xts_sector_tweaks(AesXtsContext *ctx, size_t count,
+                              uint64_t sector,
+                              unsigned char tweaks[XTS_SECTOR_BATCH * 16]) {
+  memset(tweaks, 0, count * 16);
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = 0; j < 8; ++j)
+      tweaks[i * 16 + j] = (unsigned char)((sector + i) >> (8 * j));
+  }
+
+  ctx->tweak_key.vtable->ecb_encrypt(&ctx->tweak_key, count * 16, tweaks,
+                                     tweaks);
+}
+
+int aes_xts_encrypt_sectors(AesXtsContext *ctx, size_t sector_size,
+                            size_t nsectors, unsigned char *cipher_text,
+                            const unsigned char *plain_text,
+                            uint64_t first_sector) {
+  unsigned char tweaks[XTS_SECTOR_BATCH * 16];
+
+  if (sector_size < 16)
+    return -1;
+
+  for (size_t i = 0; i < nsectors; i += XTS_SECTOR_BATCH) {
+    size_t count = nsectors - i;
+    if (count > XTS_SECTOR_BATCH)
+      count = XTS_SECTOR_BATCH;
+
+    xts_sector_tweaks(ctx, count, first_sector + i, tweaks);
+    for (size_t j = 0; j < count; ++j) {
+      size_t offset = (i + j) * sector_size;
+      xts_encrypt_unit(ctx, sector_size, &cipher_text[offset],
+                       &plain_text[offset], &tweaks[j * 16]);
+    }
+  }
+
+  return 0;
+}
+
+int aes_xts_decrypt_sectors(AesXtsContext *ctx, size_t sector_size,
+                            size_t nsectors, unsigned char *plain_text,
+                            const unsigned char *cipher_text,
+                            uint64_t first_sector) {
+  unsigned char tweaks[XTS_SECTOR_BATCH * 16];
+
+  if (sector_size < 16)
+    return -1;
+
+  for (size_t i = 0; i < nsectors; i += XTS_SECTOR_BATCH) {
+    size_t count = nsectors - i;
+    if (count > XTS_SECTOR_BATCH)
+      count = XTS_SECTOR_BATCH;
+
+    xts_sector_tweaks(ctx, count, first_sector + i, tweaks);
+    for (size_t j = 0; j < count; ++j) {
+      size_t offset = (i + j) * sector_size;
+      xts_decrypt_unit(ctx, sector_size, &plain_text[offset],
+                       &cipher_text[offset], &tweaks[j * 16]);
+    }
+  }
+
+  return 0;
+}
@@ -1,72 +1,766 @@
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "aes-bs.h"
 #include "aes-ni.h"
+#include "aes-vaes.h"
 #include "inner.h"
 #include <ay/aes.h>
 #include <ay/cpu-capability.h>
 
 #define BOOL_TO_STR(b) ((b) ? "true" : "false")
 
+#if !defined(AY_AES_PINNED_ENGINE) || AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+static const struct aes_vtable vtable_ni = {
+  .init = aesni_init,
+  .ctr_xcrypt = aesni_ctr_xcrypt,
+  .ctr_width_xcrypt = aesni_ctr_width_xcrypt,
+  .ecb_encrypt = aesni_ecb_encrypt,
+  .ecb_decrypt = aesni_ecb_decrypt,
+  .cbc_encrypt = aesni_cbc_encrypt,
+  .cbc_decrypt = aesni_cbc_decrypt
+};
+static const struct aes_gcm_vtable gcm_vtable_ni = {
+  .init = aesni_gcm_init,
+  .ghash = aesni_gcm_ghash,
+  .ctr32_encrypt = aesni_gcm_ctr32_encrypt,
+  .ctr32_decrypt = aesni_gcm_ctr32_decrypt
+};
+static const struct aes_gcm_siv_vtable gcm_siv_vtable_ni = {
+  .derive_keys = aesni_gcm_siv_derive_keys,
+  .polyval_init = aesni_polyval_init,
+  .polyval = aesni_polyval,
+  .ctr32le_xcrypt = aesni_gcm_siv_ctr32le_xcrypt
+};
+static const struct aes_haraka_vtable haraka_vtable_ni = {
+  .haraka256 = aesni_haraka256,
+  .haraka512 = aesni_haraka512,
+  .chain = aesni_haraka_chain
+};
+static const struct aes_aegis_vtable aegis_vtable_ni = {
+  .aegis128l_encrypt = aesni_aegis128l_encrypt,
+  .aegis128l_decrypt = aesni_aegis128l_decrypt,
+  .aegis256_encrypt = aesni_aegis256_encrypt,
+  .aegis256_decrypt = aesni_aegis256_decrypt
+};
+static const struct aes_ghash_vtable ghash_vtable_ni = {
+  .init = aesni_ghash_init,
+  .update = aesni_ghash
+};
+static const struct aes_ghash_vtable polyval_vtable_ni = {
+  .init = aesni_polyval_init_wide,
+  .update = aesni_polyval
+};
+static const struct aes_xts_vtable xts_vtable_ni = {
+  .encrypt_blocks = aesni_xts_encrypt_blocks,
+  .decrypt_blocks = aesni_xts_decrypt_blocks
+};
+static const struct aes_hctr2_vtable hctr2_vtable_ni = {
+  .polyval_init = aesni_polyval_init,
+  .polyval = aesni_polyval,
+  .xctr_xcrypt = aesni_xctr_xcrypt
+};
+static const struct aes_ocb_vtable ocb_vtable_ni = {
+  .encrypt_blocks = aesni_ocb_encrypt_blocks,
+  .decrypt_blocks = aesni_ocb_decrypt_blocks,
+  .hash_blocks = aesni_ocb_hash_blocks
+};
+static const struct aes_ccm_vtable ccm_vtable_ni = {
+  .cbc_mac_lanes = aesni_ccm_cbc_mac_lanes,
+  .encrypt = aesni_ccm_encrypt,
+  .decrypt = aesni_ccm_decrypt,
+  .ctr64_xcrypt = aesni_ccm_ctr64_xcrypt
+};
+static const struct aes_cmac_vtable cmac_vtable_ni = {
+  .cbc_mac_lanes = aesni_ccm_cbc_mac_lanes
+};
+static const struct aes_eax_vtable eax_vtable_ni = {
+  .cbc_mac_lanes = aesni_ccm_cbc_mac_lanes,
+  .encrypt = aesni_eax_encrypt,
+  .decrypt = aesni_eax_decrypt
+};
+static const struct aes_fpe_vtable fpe_vtable_ni = {
+  .cbc_mac_lanes = aesni_ccm_cbc_mac_lanes
+};
+static const struct aes_cfb_vtable cfb_vtable_ni = {
+  .cfb128_encrypt = aesni_cfb128_encrypt,
+  .cfb128_decrypt = aesni_cfb128_decrypt,
+  .cfb8_encrypt = aesni_cfb8_encrypt,
+  .cfb8_decrypt = aesni_cfb8_decrypt
+};
+static const struct aes_ofb_vtable ofb_vtable_ni = {
+  .keystream = aesni_ofb_keystream,
+  .xcrypt = aesni_ofb_xcrypt
+};
+static const struct aes_kw_vtable kw_vtable_ni = {
+  .wrap_lanes = aesni_kw_wrap_lanes,
+  .unwrap_lanes = aesni_kw_unwrap_lanes
+};
+static const struct aes_fixed_key_vtable fixed_key_vtable_ni = {
+  .cr = aesni_fixed_key_cr,
+  .ccr = aesni_fixed_key_ccr,
+  .tccr = aesni_fixed_key_tccr
+};
+#endif
+#if !defined(AY_AES_PINNED_ENGINE)
+/* Same key schedule & h_table as gcm_vtable_ni, wider bulk kernels. */
+static const struct aes_gcm_vtable gcm_vtable_vaes256 = {
+  .init = aesni_gcm_init,
+  .ghash = aesvaes256_gcm_ghash,
+  .ctr32_encrypt = aesvaes256_gcm_ctr32_encrypt,
+  .ctr32_decrypt = aesvaes256_gcm_ctr32_decrypt
+};
+static const struct aes_gcm_vtable gcm_vtable_vaes512 = {
+  .init = aesni_gcm_init,
+  .ghash = aesvaes512_gcm_ghash,
+  .ctr32_encrypt = aesvaes512_gcm_ctr32_encrypt,
+  .ctr32_decrypt = aesvaes512_gcm_ctr32_decrypt
+};
+static const struct aes_ghash_vtable ghash_vtable_vaes256 = {
+  .init = aesni_ghash_init,
+  .update = aesvaes256_ghash
+};
+static const struct aes_ghash_vtable ghash_vtable_vaes512 = {
+  .init = aesni_ghash_init,
+  .update = aesvaes512_ghash
+};
+static const struct aes_ghash_vtable polyval_vtable_vaes256 = {
+  .init = aesni_polyval_init_wide,
+  .update = aesvaes256_polyval
+};
+static const struct aes_ghash_vtable polyval_vtable_vaes512 = {
+  .init = aesni_polyval_init_wide,
+  .update = aesvaes512_polyval
+};
+static const struct aes_fixed_key_vtable fixed_key_vtable_vaes256 = {
+  .cr = aesvaes256_fixed_key_cr,
+  .ccr = aesvaes256_fixed_key_ccr,
+  .tccr = aesvaes256_fixed_key_tccr
+};
+static const struct aes_fixed_key_vtable fixed_key_vtable_vaes512 = {
+  .cr = aesvaes512_fixed_key_cr,
+  .ccr = aesvaes512_fixed_key_ccr,
+  .tccr = aesvaes512_fixed_key_tccr
+};
+#endif
+#if !defined(AY_AES_PINNED_ENGINE) || AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+static const struct aes_vtable vtable_bs = {
+  .init = aesbs_init,
+  .ctr_xcrypt = aesbs_ctr_xcrypt,
+  .ctr_width_xcrypt = aesbs_ctr_width_xcrypt,
+  .ecb_encrypt = aesbs_ecb_encrypt,
+  .ecb_decrypt = aesbs_ecb_decrypt,
+  .cbc_encrypt = aesbs_cbc_encrypt,
+  .cbc_decrypt = aesbs_cbc_decrypt
+};
+static const struct aes_gcm_vtable gcm_vtable_bs = {
+  .init = aesbs_gcm_init,
+  .ghash = aesbs_gcm_ghash,
+  .ctr32_encrypt = aesbs_gcm_ctr32_encrypt,
+  .ctr32_decrypt = aesbs_gcm_ctr32_decrypt
+};
+static const struct aes_gcm_siv_vtable gcm_siv_vtable_bs = {
+  .derive_keys = aesbs_gcm_siv_derive_keys,
+  .polyval_init = aesbs_polyval_init,
+  .polyval = aesbs_polyval,
+  .ctr32le_xcrypt = aesbs_gcm_siv_ctr32le_xcrypt
+};
+static const struct aes_haraka_vtable haraka_vtable_bs = {
+  .haraka256 = aesbs_haraka256,
+  .haraka512 = aesbs_haraka512,
+  .chain = aesbs_haraka_chain
+};
+static const struct aes_aegis_vtable aegis_vtable_bs = {
+  .aegis128l_encrypt = aesbs_aegis128l_encrypt,
+  .aegis128l_decrypt = aesbs_aegis128l_decrypt,
+  .aegis256_encrypt = aesbs_aegis256_encrypt,
+  .aegis256_decrypt = aesbs_aegis256_decrypt
+};
+static const struct aes_ghash_vtable ghash_vtable_bs = {
+  .init = aesbs_ghash_init,
+  .update = aesbs_ghash
+};
+static const struct aes_ghash_vtable polyval_vtable_bs = {
+  .init = aesbs_polyval_init,
+  .update = aesbs_polyval
+};
+static const struct aes_xts_vtable xts_vtable_bs = {
+  .encrypt_blocks = aesbs_xts_encrypt_blocks,
+  .decrypt_blocks = aesbs_xts_decrypt_blocks
+};
+static const struct aes_hctr2_vtable hctr2_vtable_bs = {
+  .polyval_init = aesbs_polyval_init,
+  .polyval = aesbs_polyval,
+  .xctr_xcrypt = aesbs_xctr_xcrypt
+};
+static const struct aes_ocb_vtable ocb_vtable_bs = {
+  .encrypt_blocks = aesbs_ocb_encrypt_blocks,
+  .decrypt_blocks = aesbs_ocb_decrypt_blocks,
+  .hash_blocks = aesbs_ocb_hash_blocks
+};
+static const struct aes_ccm_vtable ccm_vtable_bs = {
+  .cbc_mac_lanes = aesbs_ccm_cbc_mac_lanes,
+  .encrypt = aesbs_ccm_encrypt,
+  .decrypt = aesbs_ccm_decrypt,
+  .ctr64_xcrypt = aesbs_ccm_ctr64_xcrypt
+};
+static const struct aes_cmac_vtable cmac_vtable_bs = {
+  .cbc_mac_lanes = aesbs_ccm_cbc_mac_lanes
+};
+static const struct aes_eax_vtable eax_vtable_bs = {
+  .cbc_mac_lanes = aesbs_ccm_cbc_mac_lanes,
+  .encrypt = aesbs_eax_encrypt,
+  .decrypt = aesbs_eax_decrypt
+};
+static const struct aes_fpe_vtable fpe_vtable_bs = {
+  .cbc_mac_lanes = aesbs_ccm_cbc_mac_lanes
+};
+static const struct aes_cfb_vtable cfb_vtable_bs = {
+  .cfb128_encrypt = aesbs_cfb128_encrypt,
+  .cfb128_decrypt = aesbs_cfb128_decrypt,
+  .cfb8_encrypt = aesbs_cfb8_encrypt,
+  .cfb8_decrypt = aesbs_cfb8_decrypt
+};
+static const struct aes_ofb_vtable ofb_vtable_bs = {
+  .keystream = aesbs_ofb_keystream,
+  .xcrypt = aesbs_ofb_xcrypt
+};
+static const struct aes_kw_vtable kw_vtable_bs = {
+  .wrap_lanes = aesbs_kw_wrap_lanes,
+  .unwrap_lanes = aesbs_kw_unwrap_lanes
+};
+static const struct aes_fixed_key_vtable fixed_key_vtable_bs = {
+  .cr = aesbs_fixed_key_cr,
+  .ccr = aesbs_fixed_key_ccr,
+  .tccr = aesbs_fixed_key_tccr
+};
+#endif
+
+/* With a pinned engine the vtable is a compile-time constant, so every call
+ * below becomes a direct call into the engine. */
+#if !defined(AY_AES_PINNED_ENGINE)
+#define AES_VTABLE(ctx) ((ctx)->vtable)
+#elif AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+#define AES_VTABLE(ctx) (&vtable_ni)
+#elif AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+#define AES_VTABLE(ctx) (&vtable_bs)
+#else
+#error "Unknown value of AY_AES_PINNED_ENGINE"
+#endif
+
+static const struct aes_vtable *aes_select_vtable(void) {
+#if defined(AY_AES_PINNED_ENGINE)
+  return AES_VTABLE(NULL);
+#else
+  struct cpu_capability_x86 cpufeat;
+  cpu_capability_x86_init(&cpufeat);
+
+  if (cpufeat.sse && cpufeat.sse2 && cpufeat.ssse3 && cpufeat.aes)
+    return &vtable_ni;
+
+  return &vtable_bs;
+#endif
+}
+
 void aes_init(AesContext *ctx, enum AesKeyType key_type,
               const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+
+  ctx->vtable = (struct aes_vtable *)vtable;
+  vtable->init(ctx, key_type, key);
+}
+
+/* GCM additionally needs PCLMULQDQ on the AES-NI engine. Without it, both the
+ * block cipher and GHASH fall back to the constant-time bitsliced engine. With
+ * VAES & VPCLMULQDQ (and OS support for the wider registers), the bulk of the
+ * work goes to the 512-bit or 256-bit kernels instead. */
+void aes_gcm_init(AesGcmContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key) {
+  const struct aes_vtable *vtable;
+  const struct aes_gcm_vtable *gcm_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  vtable = &vtable_ni;
+  gcm_vtable = &gcm_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  vtable = &vtable_bs;
+  gcm_vtable = &gcm_vtable_bs;
+#else
+  vtable = aes_select_vtable();
+  gcm_vtable = &gcm_vtable_bs;
+
   struct cpu_capability_x86 cpufeat;
   cpu_capability_x86_init(&cpufeat);
+  if (vtable == &vtable_ni && cpufeat.pclmulqdq) {
+    bool vaes = cpufeat.vaes && cpufeat.vpclmulqdq;
 
-  static const struct aes_vtable vtable_ni = {
-    .init = aesni_init,
-    .ctr_xcrypt = aesni_ctr_xcrypt,
-    .ecb_encrypt = aesni_ecb_encrypt,
-    .ecb_decrypt = aesni_ecb_decrypt,
-    .cbc_encrypt = aesni_cbc_encrypt,
-    .cbc_decrypt = aesni_cbc_decrypt
-  };
-  static const struct aes_vtable vtable_bs = {
-    .init = aesbs_init,
-    .ctr_xcrypt = aesbs_ctr_xcrypt,
-    .ecb_encrypt = aesbs_ecb_encrypt,
-    .ecb_decrypt = aesbs_ecb_decrypt,
-    .cbc_encrypt = aesbs_cbc_encrypt,
-    .cbc_decrypt = aesbs_cbc_decrypt
-  };
-
-  if (cpufeat.sse && cpufeat.sse2 && cpufeat.ssse3 && cpufeat.aes) {
-    ctx->vtable = &vtable_ni;
-    aesni_init(ctx, key_type, key);
+    if (vaes && cpufeat.avx512f && cpufeat.avx512bw && cpufeat.avx512vl &&
+        cpufeat.os_zmm)
+      gcm_vtable = &gcm_vtable_vaes512;
+    else if (vaes && cpufeat.avx2 && cpufeat.os_ymm)
+      gcm_vtable = &gcm_vtable_vaes256;
+    else
+      gcm_vtable = &gcm_vtable_ni;
   } else {
-    ctx->vtable = &vtable_bs;
-    aesbs_init(ctx, key_type, key);
+    vtable = &vtable_bs;
+  }
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->gcm_vtable = (struct aes_gcm_vtable *)gcm_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  gcm_vtable->init(ctx);
+}
+
+/* The GHASH & POLYVAL engines of GCM, selected the same way (without AES-NI,
+ * which is not needed for hashing alone). */
+static void aes_ghash_select(AesGhashContext *ctx, bool polyval,
+                             const unsigned char h[16]) {
+  const struct aes_ghash_vtable *ghash_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  ghash_vtable = polyval ? &polyval_vtable_ni : &ghash_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  ghash_vtable = polyval ? &polyval_vtable_bs : &ghash_vtable_bs;
+#else
+  ghash_vtable = polyval ? &polyval_vtable_bs : &ghash_vtable_bs;
+
+  struct cpu_capability_x86 cpufeat;
+  cpu_capability_x86_init(&cpufeat);
+  if (cpufeat.sse2 && cpufeat.ssse3 && cpufeat.pclmulqdq) {
+    bool vaes = cpufeat.vaes && cpufeat.vpclmulqdq;
+
+    if (vaes && cpufeat.avx512f && cpufeat.avx512bw && cpufeat.avx512vl &&
+        cpufeat.os_zmm)
+      ghash_vtable = polyval ? &polyval_vtable_vaes512 : &ghash_vtable_vaes512;
+    else if (vaes && cpufeat.avx2 && cpufeat.os_ymm)
+      ghash_vtable = polyval ? &polyval_vtable_vaes256 : &ghash_vtable_vaes256;
+    else
+      ghash_vtable = polyval ? &polyval_vtable_ni : &ghash_vtable_ni;
+  }
+#endif
+
+  ctx->ghash_vtable = (struct aes_ghash_vtable *)ghash_vtable;
+  ghash_vtable->init(ctx->h_table, h);
+  aes_ghash_reset(ctx);
+}
+
+void aes_ghash_init(AesGhashContext *ctx, const unsigned char h[16]) {
+  aes_ghash_select(ctx, false, h);
+}
+
+void aes_polyval_init(AesGhashContext *ctx, const unsigned char h[16]) {
+  aes_ghash_select(ctx, true, h);
+}
+
+/* Like GCM, POLYVAL needs PCLMULQDQ on the AES-NI engine. */
+int aes_gcm_siv_init(AesGcmSivContext *ctx, enum AesKeyType key_type,
+                     const unsigned char *key) {
+  const struct aes_vtable *vtable;
+  const struct aes_gcm_siv_vtable *siv_vtable;
+
+  /* The key derivation of RFC 8452 only makes 128 or 256-bit keys. */
+  if (key_type == KEY_TYPE_AES192)
+    return -1;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  vtable = &vtable_ni;
+  siv_vtable = &gcm_siv_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  vtable = &vtable_bs;
+  siv_vtable = &gcm_siv_vtable_bs;
+#else
+  vtable = aes_select_vtable();
+  siv_vtable = &gcm_siv_vtable_bs;
+
+  struct cpu_capability_x86 cpufeat;
+  cpu_capability_x86_init(&cpufeat);
+  if (vtable == &vtable_ni && cpufeat.pclmulqdq)
+    siv_vtable = &gcm_siv_vtable_ni;
+  else
+    vtable = &vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->siv_vtable = (struct aes_gcm_siv_vtable *)siv_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  return 0;
+}
+
+/* XTS only needs the block cipher, so it uses the engine aes_init() would. */
+int aes_xts_init(AesXtsContext *ctx, enum AesKeyType key_type,
+                 const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_xts_vtable *xts_vtable;
+
+  /* IEEE 1619 only defines XTS-AES-128 & XTS-AES-256. */
+  if (key_type == KEY_TYPE_AES192)
+    return -1;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  xts_vtable = &xts_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  xts_vtable = &xts_vtable_bs;
+#else
+  xts_vtable = vtable == &vtable_ni ? &xts_vtable_ni : &xts_vtable_bs;
+#endif
+
+  ctx->data_key.vtable = (struct aes_vtable *)vtable;
+  ctx->tweak_key.vtable = (struct aes_vtable *)vtable;
+  ctx->xts_vtable = (struct aes_xts_vtable *)xts_vtable;
+  vtable->init(&ctx->data_key, key_type, key);
+  vtable->init(&ctx->tweak_key, key_type, &key[key_type / 8]);
+  return 0;
+}
+
+/* AEGIS has no key schedule: only the round function of the engine is used,
+ * so it is selected like aes_init() does. */
+static const struct aes_aegis_vtable *aes_aegis_select_vtable(void) {
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  return &aegis_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  return &aegis_vtable_bs;
+#else
+  return aes_select_vtable() == &vtable_ni ? &aegis_vtable_ni
+                                           : &aegis_vtable_bs;
+#endif
+}
+
+void aes_aegis128l_init(AesAegis128lContext *ctx, const unsigned char key[16]) {
+  ctx->aegis_vtable = (struct aes_aegis_vtable *)aes_aegis_select_vtable();
+  memcpy(ctx->key, key, sizeof ctx->key);
+}
+
+void aes_aegis256_init(AesAegis256Context *ctx, const unsigned char key[32]) {
+  ctx->aegis_vtable = (struct aes_aegis_vtable *)aes_aegis_select_vtable();
+  memcpy(ctx->key, key, sizeof ctx->key);
+}
+
+/* HCTR2 hashes with POLYVAL, so it is selected like AES-GCM-SIV. */
+void aes_hctr2_init(AesHctr2Context *ctx, enum AesKeyType key_type,
+                    const unsigned char *key) {
+  const struct aes_vtable *vtable;
+  const struct aes_hctr2_vtable *hctr2_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  vtable = &vtable_ni;
+  hctr2_vtable = &hctr2_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  vtable = &vtable_bs;
+  hctr2_vtable = &hctr2_vtable_bs;
+#else
+  vtable = aes_select_vtable();
+  hctr2_vtable = &hctr2_vtable_bs;
+
+  struct cpu_capability_x86 cpufeat;
+  cpu_capability_x86_init(&cpufeat);
+  if (vtable == &vtable_ni && cpufeat.pclmulqdq)
+    hctr2_vtable = &hctr2_vtable_ni;
+  else
+    vtable = &vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->hctr2_vtable = (struct aes_hctr2_vtable *)hctr2_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  aes_hctr2_init_keys(ctx);
+}
+
+/* Like XTS, OCB only needs the block cipher. */
+void aes_ocb_init(AesOcbContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_ocb_vtable *ocb_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  ocb_vtable = &ocb_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  ocb_vtable = &ocb_vtable_bs;
+#else
+  ocb_vtable = vtable == &vtable_ni ? &ocb_vtable_ni : &ocb_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->ocb_vtable = (struct aes_ocb_vtable *)ocb_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  aes_ocb_init_l_table(ctx);
+}
+
+/* CCM is built from CTR & CBC-MAC, so it only needs the block cipher too. */
+void aes_ccm_init(AesCcmContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_ccm_vtable *ccm_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  ccm_vtable = &ccm_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  ccm_vtable = &ccm_vtable_bs;
+#else
+  ccm_vtable = vtable == &vtable_ni ? &ccm_vtable_ni : &ccm_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->ccm_vtable = (struct aes_ccm_vtable *)ccm_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+}
+
+void aes_cmac_init(AesCmacContext *ctx, enum AesKeyType key_type,
+                   const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_cmac_vtable *cmac_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  cmac_vtable = &cmac_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  cmac_vtable = &cmac_vtable_bs;
+#else
+  cmac_vtable = vtable == &vtable_ni ? &cmac_vtable_ni : &cmac_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->cmac_vtable = (struct aes_cmac_vtable *)cmac_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  aes_cmac_init_subkeys(ctx);
+}
+
+void aes_eax_init(AesEaxContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_eax_vtable *eax_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  eax_vtable = &eax_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  eax_vtable = &eax_vtable_bs;
+#else
+  eax_vtable = vtable == &vtable_ni ? &eax_vtable_ni : &eax_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->eax_vtable = (struct aes_eax_vtable *)eax_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  aes_eax_init_subkeys(ctx);
+}
+
+int aes_ff1_init(AesFf1Context *ctx, enum AesKeyType key_type,
+                 const unsigned char *key, unsigned radix) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_fpe_vtable *fpe_vtable;
+
+  if (radix < 2 || radix > AES_FPE_MAX_RADIX)
+    return -1;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  fpe_vtable = &fpe_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  fpe_vtable = &fpe_vtable_bs;
+#else
+  fpe_vtable = vtable == &vtable_ni ? &fpe_vtable_ni : &fpe_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->fpe_vtable = (struct aes_fpe_vtable *)fpe_vtable;
+  ctx->radix = radix;
+  vtable->init(&ctx->aes, key_type, key);
+  return 0;
+}
+
+/* FF3-1 only encrypts single blocks, under the byte-reversed key. */
+int aes_ff3_init(AesFf3Context *ctx, enum AesKeyType key_type,
+                 const unsigned char *key, unsigned radix) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_fpe_vtable *fpe_vtable;
+  unsigned char reversed_key[32];
+  size_t key_size = (size_t)key_type / 8;
+
+  if (radix < 2 || radix > AES_FPE_MAX_RADIX)
+    return -1;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  fpe_vtable = &fpe_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  fpe_vtable = &fpe_vtable_bs;
+#else
+  fpe_vtable = vtable == &vtable_ni ? &fpe_vtable_ni : &fpe_vtable_bs;
+#endif
+
+  for (size_t i = 0; i < key_size; ++i)
+    reversed_key[i] = key[key_size - 1 - i];
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->fpe_vtable = (struct aes_fpe_vtable *)fpe_vtable;
+  ctx->radix = radix;
+  vtable->init(&ctx->aes, key_type, reversed_key);
+  return 0;
+}
+
+void aes_cfb_init(AesCfbContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key, const unsigned char iv[16]) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_cfb_vtable *cfb_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  cfb_vtable = &cfb_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  cfb_vtable = &cfb_vtable_bs;
+#else
+  cfb_vtable = vtable == &vtable_ni ? &cfb_vtable_ni : &cfb_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->cfb_vtable = (struct aes_cfb_vtable *)cfb_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  aes_cfb_set_iv(ctx, iv);
+}
+
+void aes_ofb_init(AesOfbContext *ctx, enum AesKeyType key_type,
+                  const unsigned char *key, const unsigned char iv[16]) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_ofb_vtable *ofb_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  ofb_vtable = &ofb_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  ofb_vtable = &ofb_vtable_bs;
+#else
+  ofb_vtable = vtable == &vtable_ni ? &ofb_vtable_ni : &ofb_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->ofb_vtable = (struct aes_ofb_vtable *)ofb_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+  aes_ofb_set_ring(ctx, NULL, 0);
+  aes_ofb_set_iv(ctx, iv);
+}
+
+void aes_kw_init(AesKwContext *ctx, enum AesKeyType key_type,
+                 const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_kw_vtable *kw_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  kw_vtable = &kw_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  kw_vtable = &kw_vtable_bs;
+#else
+  kw_vtable = vtable == &vtable_ni ? &kw_vtable_ni : &kw_vtable_bs;
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->kw_vtable = (struct aes_kw_vtable *)kw_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+}
+
+/* The fixed-key hashes only need VAES (no VPCLMULQDQ) for the wide kernels. */
+void aes_fixed_key_init(AesFixedKeyContext *ctx, enum AesKeyType key_type,
+                        const unsigned char *key) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_fixed_key_vtable *fixed_key_vtable;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  fixed_key_vtable = &fixed_key_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  fixed_key_vtable = &fixed_key_vtable_bs;
+#else
+  fixed_key_vtable = &fixed_key_vtable_bs;
+  if (vtable == &vtable_ni) {
+    struct cpu_capability_x86 cpufeat;
+    cpu_capability_x86_init(&cpufeat);
+
+    if (cpufeat.vaes && cpufeat.avx512f && cpufeat.avx512bw &&
+        cpufeat.avx512vl && cpufeat.os_zmm)
+      fixed_key_vtable = &fixed_key_vtable_vaes512;
+    else if (cpufeat.vaes && cpufeat.avx2 && cpufeat.os_ymm)
+      fixed_key_vtable = &fixed_key_vtable_vaes256;
+    else
+      fixed_key_vtable = &fixed_key_vtable_ni;
   }
+#endif
+
+  ctx->aes.vtable = (struct aes_vtable *)vtable;
+  ctx->fixed_key_vtable = (struct aes_fixed_key_vtable *)fixed_key_vtable;
+  vtable->init(&ctx->aes, key_type, key);
+}
+
+void aes_fixed_key_cr(AesFixedKeyContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in) {
+  ctx->fixed_key_vtable->cr(&ctx->aes, textsize, out, in);
+}
+
+void aes_fixed_key_ccr(AesFixedKeyContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in) {
+  ctx->fixed_key_vtable->ccr(&ctx->aes, textsize, out, in);
+}
+
+void aes_fixed_key_tccr(AesFixedKeyContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        uint64_t tweak) {
+  ctx->fixed_key_vtable->tccr(&ctx->aes, textsize, out, in, tweak);
+}
+
+/* Haraka only needs AES rounds, so it is selected like aes_init(); the block
+ * cipher of the same engine derives the round constants. */
+void aes_haraka_init(AesHarakaContext *ctx, const unsigned char key[16]) {
+  const struct aes_vtable *vtable = aes_select_vtable();
+  const struct aes_haraka_vtable *haraka_vtable;
+  AesContext aes;
+
+#if defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_NI
+  haraka_vtable = &haraka_vtable_ni;
+#elif defined(AY_AES_PINNED_ENGINE) && AY_AES_PINNED_ENGINE == AY_AES_ENGINE_BS
+  haraka_vtable = &haraka_vtable_bs;
+#else
+  haraka_vtable = vtable == &vtable_ni ? &haraka_vtable_ni : &haraka_vtable_bs;
+#endif
+
+  ctx->haraka_vtable = (struct aes_haraka_vtable *)haraka_vtable;
+
+  /* rc[i] = AES(key, LE128(i)) */
+  memset(ctx->rc, 0, sizeof ctx->rc);
+  for (size_t i = 0; i < sizeof ctx->rc / 16; ++i)
+    ctx->rc[i * 16] = (unsigned char)i;
+
+  aes.vtable = (struct aes_vtable *)vtable;
+  vtable->init(&aes, KEY_TYPE_AES128, key);
+  vtable->ecb_encrypt(&aes, sizeof ctx->rc, ctx->rc, ctx->rc);
 }
 
 void aes_ctr_xcrypt(AesContext *ctx, size_t textsize, unsigned char *out,
                     const unsigned char *in, unsigned char next_iv[16],
                     const unsigned char iv[16]) {
-  ctx->vtable->ctr_xcrypt(ctx, textsize, out, in, next_iv, iv);
+  AES_VTABLE(ctx)->ctr_xcrypt(ctx, textsize, out, in, next_iv, iv);
+}
+
+void aes_ctr_width_xcrypt(AesContext *ctx, enum AesCtrWidth width,
+                          size_t textsize, unsigned char *out,
+                          const unsigned char *in, unsigned char next_iv[16],
+                          const unsigned char iv[16]) {
+  AES_VTABLE(ctx)->ctr_width_xcrypt(ctx, width, textsize, out, in, next_iv, iv);
 }
 
 void aes_ecb_encrypt(AesContext *ctx, size_t textsize,
                      unsigned char *cipher_text,
                      const unsigned char *plain_text) {
-  ctx->vtable->ecb_encrypt(ctx, textsize, cipher_text, plain_text);
+  AES_VTABLE(ctx)->ecb_encrypt(ctx, textsize, cipher_text, plain_text);
 }
 
 void aes_ecb_decrypt(AesContext *ctx, size_t textsize,
                      unsigned char *plain_text,
                      const unsigned char *cipher_text) {
-  ctx->vtable->ecb_decrypt(ctx, textsize, plain_text, cipher_text);
+  AES_VTABLE(ctx)->ecb_decrypt(ctx, textsize, plain_text, cipher_text);
 }
 
 void aes_cbc_encrypt(AesContext *ctx, size_t textsize,
                      unsigned char *cipher_text,
                      const unsigned char *plain_text, const unsigned char *iv) {
-  ctx->vtable->cbc_encrypt(ctx, textsize, cipher_text, plain_text, iv);
+  AES_VTABLE(ctx)->cbc_encrypt(ctx, textsize, cipher_text, plain_text, iv);
 }
 
 void aes_cbc_decrypt(AesContext *ctx, size_t textsize,
                      unsigned char *plain_text,
                      const unsigned char *cipher_text,
                      const unsigned char *iv) {
-  ctx->vtable->cbc_decrypt(ctx, textsize, plain_text, cipher_text, iv);
+  AES_VTABLE(ctx)->cbc_decrypt(ctx, textsize, plain_text, cipher_text, iv);
 }
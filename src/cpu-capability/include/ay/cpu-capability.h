@@ -19,9 +19,29 @@ struct cpu_capability_x86 {
   bool pclmulqdq : 1;
   bool ssse3 : 1;
   bool aes : 1;
+
+  /* Leaf = 07h, subleaf = 0 */
+
+  /* register = EBX */
+  bool avx2 : 1;
+  bool avx512f : 1;
+  bool avx512bw : 1;
+  bool avx512vl : 1;
+
+  /* register = ECX */
+  bool vaes : 1;
+  bool vpclmulqdq : 1;
+
+  /* XCR0, only meaningful if OSXSAVE is set */
+
+  /* The OS saves the YMM registers on context switches */
+  bool os_ymm : 1;
+  /* The OS saves the ZMM & opmask registers on context switches */
+  bool os_zmm : 1;
 };
 
 void cpu_capability_x86_init(struct cpu_capability_x86 *ctx);
 void cpuid_x86(uint32_t regs[4], uint32_t leaf);
+void cpuid_x86_count(uint32_t regs[4], uint32_t leaf, uint32_t subleaf);
 
 #endif /* AY_CPU_CAPABILITY_X86 */
@@ -4,6 +4,7 @@
 #include <ay/cpu-capability.h>
 
 #if defined(_MSC_VER)
+#include <immintrin.h>
 #include <intrin.h>
 #elif defined(__GNUC__)
 #include <cpuid.h>
@@ -17,6 +18,27 @@ void cpuid_x86(uint32_t regs[4], uint32_t leaf) {
 #endif
 }
 
+void cpuid_x86_count(uint32_t regs[4], uint32_t leaf, uint32_t subleaf) {
+#if defined(_MSC_VER)
+  __cpuidex((int *)regs, leaf, subleaf);
+#elif defined(__GNUC__)
+  __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+}
+
+static uint64_t xgetbv_x86(uint32_t index) {
+#if defined(_MSC_VER)
+  return _xgetbv(index);
+#elif defined(__GNUC__)
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+  return ((uint64_t)edx << 32) | eax;
+#else
+  (void)index;
+  return 0;
+#endif
+}
+
 static inline bool is_bit_set(uint32_t reg, unsigned char bit_location) {
   return (reg >> bit_location) & 0x01;
 }
@@ -36,4 +58,23 @@ void cpu_capability_x86_init(struct cpu_capability_x86 *ctx) {
   ctx->pclmulqdq = is_bit_set(cpuid_regs_01h[2], 1);
   ctx->ssse3 = is_bit_set(cpuid_regs_01h[2], 9);
   ctx->aes = is_bit_set(cpuid_regs_01h[2], 25);
+
+  unsigned int cpuid_regs_07h[4] = {0};
+  cpuid_x86(cpuid_regs_07h, 0x00);
+  if (cpuid_regs_07h[0] >= 0x07)
+    cpuid_x86_count(cpuid_regs_07h, 0x07, 0x00);
+  else
+    cpuid_regs_07h[1] = cpuid_regs_07h[2] = 0;
+
+  ctx->avx2 = is_bit_set(cpuid_regs_07h[1], 5);
+  ctx->avx512f = is_bit_set(cpuid_regs_07h[1], 16);
+  ctx->avx512bw = is_bit_set(cpuid_regs_07h[1], 30);
+  ctx->avx512vl = is_bit_set(cpuid_regs_07h[1], 31);
+  ctx->vaes = is_bit_set(cpuid_regs_07h[2], 9);
+  ctx->vpclmulqdq = is_bit_set(cpuid_regs_07h[2], 10);
+
+  /* XCR0 bits: 1 = SSE, 2 = AVX, 5-7 = opmask & ZMM state. */
+  uint64_t xcr0 = is_bit_set(cpuid_regs_01h[2], 27) ? xgetbv_x86(0) : 0;
+  ctx->os_ymm = (xcr0 & 0x06) == 0x06;
+  ctx->os_zmm = (xcr0 & 0xe6) == 0xe6;
 }
@@ -1,6 +1,9 @@
 #ifndef AY_AES_INNER_H
 #define AY_AES_INNER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <ay/aes.h>
 
 #if defined(__GNUC__)
@@ -23,6 +26,10 @@ struct aes_vtable {
   void (*ctr_xcrypt)(AesContext *ctx, size_t textsize, unsigned char *out,
                      const unsigned char *in, unsigned char next_iv[16],
                      const unsigned char iv[16]);
+  void (*ctr_width_xcrypt)(AesContext *ctx, enum AesCtrWidth width,
+                           size_t textsize, unsigned char *out,
+                           const unsigned char *in, unsigned char next_iv[16],
+                           const unsigned char iv[16]);
   void (*ecb_encrypt)(AesContext *ctx, size_t textsize,
                       unsigned char *cipher_text,
                       const unsigned char *plain_text);
@@ -41,4 +48,375 @@ struct aes_vtable {
                       const unsigned char iv[16]);
 };
 
+/*
+ * GHASH and counter-mode kernels used by AES-GCM. `xi` is the running GHASH
+ * value and `counter` the counter block, both in the byte order of NIST SP
+ * 800-38D; only the last 32 bits of `counter` are incremented.
+ */
+struct aes_gcm_vtable {
+  /* Fills ctx->h_table from the hash key H = E(K, 0^128). */
+  void (*init)(AesGcmContext *ctx);
+
+  /* Absorbs `textsize` bytes from `in` into `xi`. textsize must be divisible
+   * by 16. */
+  void (*ghash)(const AesGcmContext *ctx, unsigned char xi[16], size_t textsize,
+                const unsigned char *in);
+
+  /* Encrypts `in` to `out` and absorbs the cipher text into `xi`. A trailing
+   * partial block is absorbed zero-padded. */
+  void (*ctr32_encrypt)(const AesGcmContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char counter[16], unsigned char xi[16]);
+
+  /* Absorbs the cipher text in `in` into `xi` and decrypts it to `out`. */
+  void (*ctr32_decrypt)(const AesGcmContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char counter[16], unsigned char xi[16]);
+};
+
+/* Size of a table of powers of a hash key, as in AesGcmContext. */
+#define AES_HTABLE_SIZE (sizeof((AesGcmContext *)0)->h_table)
+
+/*
+ * Kernels used by AES-GCM-SIV (RFC 8452). POLYVAL tables are filled by
+ * polyval_init() from a hash key and have to be 16-byte aligned and
+ * AES_HTABLE_SIZE bytes long; `s` is the running POLYVAL value.
+ */
+struct aes_gcm_siv_vtable {
+  /* Derives the per-nonce message authentication key (16 bytes) & message
+   * encryption key (as long as the key of ctx) from the key-generating key. */
+  void (*derive_keys)(AesContext *ctx, const unsigned char nonce[12],
+                      unsigned char auth_key[16], unsigned char enc_key[32]);
+
+  void (*polyval_init)(unsigned char *h_table, const unsigned char h[16]);
+
+  /* Absorbs `textsize` bytes from `in` into `s`. textsize must be divisible
+   * by 16. */
+  void (*polyval)(const unsigned char *h_table, unsigned char s[16],
+                  size_t textsize, const unsigned char *in);
+
+  /* CTR with the little-endian 32-bit counter in the first 4 bytes of
+   * `counter`, which wraps without carrying into the rest of the block. */
+  void (*ctr32le_xcrypt)(AesContext *ctx, size_t textsize, unsigned char *out,
+                         const unsigned char *in,
+                         const unsigned char counter[16]);
+};
+
+/*
+ * Kernels used by AEGIS-128L & AEGIS-256. Each call runs a whole message, from
+ * the initialization with the key & nonce to the tag (16 or 32 bytes), so that
+ * the state never leaves the registers; decryption also computes the tag,
+ * which is compared by the caller.
+ */
+struct aes_aegis_vtable {
+  void (*aegis128l_encrypt)(const unsigned char key[16],
+                            const unsigned char nonce[16], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag);
+  void (*aegis128l_decrypt)(const unsigned char key[16],
+                            const unsigned char nonce[16], size_t aadsize,
+                            const unsigned char *aad, size_t textsize,
+                            unsigned char *out, const unsigned char *in,
+                            size_t tagsize, unsigned char *tag);
+  void (*aegis256_encrypt)(const unsigned char key[32],
+                           const unsigned char nonce[32], size_t aadsize,
+                           const unsigned char *aad, size_t textsize,
+                           unsigned char *out, const unsigned char *in,
+                           size_t tagsize, unsigned char *tag);
+  void (*aegis256_decrypt)(const unsigned char key[32],
+                           const unsigned char nonce[32], size_t aadsize,
+                           const unsigned char *aad, size_t textsize,
+                           unsigned char *out, const unsigned char *in,
+                           size_t tagsize, unsigned char *tag);
+};
+
+/*
+ * Kernels behind AesGhashContext: GHASH (NIST SP 800-38D) or POLYVAL (RFC
+ * 8452) over a table filled by init() from the hash key, in the layout of the
+ * engine; the table has to be 16-byte aligned and AES_HTABLE_SIZE bytes long.
+ * `s` is the running value in the byte order of the hash.
+ */
+struct aes_ghash_vtable {
+  void (*init)(unsigned char *h_table, const unsigned char h[16]);
+
+  /* Absorbs `textsize` bytes from `in` into `s`. textsize must be divisible
+   * by 16. */
+  void (*update)(const unsigned char *h_table, unsigned char s[16],
+                 size_t textsize, const unsigned char *in);
+};
+
+/*
+ * Kernels used by AES-XTS (IEEE 1619). `tweak` is the encrypted tweak of the
+ * first block and is advanced past the last one; textsize must be divisible by
+ * 16. Ciphertext stealing is done by the caller.
+ */
+struct aes_xts_vtable {
+  void (*encrypt_blocks)(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char tweak[16]);
+  void (*decrypt_blocks)(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char tweak[16]);
+};
+
+/* Multiplies an XTS tweak by x in GF(2^128), without branching on its bits. */
+static inline void aes_xts_mul_alpha(unsigned char tweak[16]) {
+  unsigned char carry = tweak[15] >> 7;
+  for (size_t i = 15; i > 0; --i)
+    tweak[i] = (unsigned char)((tweak[i] << 1) | (tweak[i - 1] >> 7));
+  tweak[0] = (unsigned char)((tweak[0] << 1) ^ (0x87 & -carry));
+}
+
+/*
+ * Kernels used by HCTR2. The POLYVAL table is filled by polyval_init() as for
+ * AES-GCM-SIV; `s` is the running POLYVAL value.
+ */
+struct aes_hctr2_vtable {
+  void (*polyval_init)(unsigned char *h_table, const unsigned char h[16]);
+
+  /* Absorbs `textsize` bytes from `in` into `s`. textsize must be divisible
+   * by 16. */
+  void (*polyval)(const unsigned char *h_table, unsigned char s[16],
+                  size_t textsize, const unsigned char *in);
+
+  /* XCTR: block i (from 1) of the key stream is E(K, iv ^ LE128(i)). */
+  void (*xctr_xcrypt)(const AesContext *ctx, size_t textsize,
+                      unsigned char *out, const unsigned char *in,
+                      const unsigned char iv[16]);
+};
+
+/* Derives the POLYVAL table & ctx->l once ctx->aes is initialized. */
+void aes_hctr2_init_keys(AesHctr2Context *ctx);
+
+/*
+ * Kernels used by AES-OCB3 (RFC 7253) for the full blocks of a message or of
+ * the associated data. `block_index` is the (1-based) index of the first
+ * block; `offset` is advanced past the last block. textsize must be divisible
+ * by 16.
+ */
+struct aes_ocb_vtable {
+  /* Also absorbs the plain text into `checksum`. */
+  void (*encrypt_blocks)(const AesOcbContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         uint64_t block_index, unsigned char offset[16],
+                         unsigned char checksum[16]);
+  void (*decrypt_blocks)(const AesOcbContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         uint64_t block_index, unsigned char offset[16],
+                         unsigned char checksum[16]);
+
+  /* Absorbs associated data into `sum` (HASH of RFC 7253, section 4.1). */
+  void (*hash_blocks)(const AesOcbContext *ctx, size_t textsize,
+                      const unsigned char *in, uint64_t block_index,
+                      unsigned char offset[16], unsigned char sum[16]);
+};
+
+/* Fills ctx->l_table once ctx->aes is initialized. Shared by all engines. */
+void aes_ocb_init_l_table(AesOcbContext *ctx);
+
+/* Maximum number of CBC-MAC chains advanced together by cbc_mac_lanes(). */
+#define AES_CCM_LANES 8
+
+/*
+ * Kernels used by AES-CCM (NIST SP 800-38C). Counter blocks carry the counter
+ * in their last 8 bytes (big-endian), which is wider than any CCM counter
+ * field, so it never carries into the nonce.
+ */
+struct aes_ccm_vtable {
+  /* Advances `nlanes` (at most AES_CCM_LANES) independent CBC-MAC chains by
+   * `nblocks` full blocks each: chain i reads from in[i] & keeps its state at
+   * &macs[i * 16]. */
+  void (*cbc_mac_lanes)(const AesContext *ctx, size_t nlanes, size_t nblocks,
+                        const unsigned char *const *in, unsigned char *macs);
+
+  /* CTR starting at `counter`, together with the CBC-MAC of the plain text
+   * (a trailing partial block is absorbed zero-padded). */
+  void (*encrypt)(const AesContext *ctx, size_t textsize, unsigned char *out,
+                  const unsigned char *in, const unsigned char counter[16],
+                  unsigned char mac[16]);
+  void (*decrypt)(const AesContext *ctx, size_t textsize, unsigned char *out,
+                  const unsigned char *in, const unsigned char counter[16],
+                  unsigned char mac[16]);
+
+  /* CTR alone. */
+  void (*ctr64_xcrypt)(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       const unsigned char counter[16]);
+};
+
+/* Maximum number of CMAC chains advanced together by cbc_mac_lanes(). */
+#define AES_CMAC_LANES AES_CCM_LANES
+
+/* Kernels used by AES-CMAC (RFC 4493); the engines share their CBC-MAC lanes
+ * with CCM. */
+struct aes_cmac_vtable {
+  void (*cbc_mac_lanes)(const AesContext *ctx, size_t nlanes, size_t nblocks,
+                        const unsigned char *const *in, unsigned char *macs);
+};
+
+/* Derives ctx->k1 & ctx->k2 once ctx->aes is initialized. */
+void aes_cmac_init_subkeys(AesCmacContext *ctx);
+
+/* Kernels used by AES-EAX; the engines share their CBC-MAC lanes with CCM. */
+struct aes_eax_vtable {
+  void (*cbc_mac_lanes)(const AesContext *ctx, size_t nlanes, size_t nblocks,
+                        const unsigned char *const *in, unsigned char *macs);
+
+  /* CTR starting at `counter`, with a 128-bit counter, together with the
+   * OMAC chain of the cipher text. The last block of the text (full or not)
+   * is left out of the chain, as it has to be masked first. */
+  void (*encrypt)(const AesContext *ctx, size_t textsize, unsigned char *out,
+                  const unsigned char *in, const unsigned char counter[16],
+                  unsigned char mac[16]);
+  void (*decrypt)(const AesContext *ctx, size_t textsize, unsigned char *out,
+                  const unsigned char *in, const unsigned char counter[16],
+                  unsigned char mac[16]);
+};
+
+/* Derives the OMAC subkeys & ctx->l once ctx->aes is initialized. */
+void aes_eax_init_subkeys(AesEaxContext *ctx);
+
+/* Kernels used by FF1 & FF3-1, whose round functions are a CBC-MAC & a single
+ * block encryption (a one-block CBC-MAC); the rounds of several tokens advance
+ * as lanes of the CCM kernel. */
+struct aes_fpe_vtable {
+  void (*cbc_mac_lanes)(const AesContext *ctx, size_t nlanes, size_t nblocks,
+                        const unsigned char *const *in, unsigned char *macs);
+};
+
+/*
+ * Kernels used by AES-CFB. `iv` is the shift register; it is advanced past the
+ * processed text. The CFB128 kernels only process full blocks.
+ */
+struct aes_cfb_vtable {
+  void (*cfb128_encrypt)(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char iv[16]);
+  void (*cfb128_decrypt)(const AesContext *ctx, size_t textsize,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char iv[16]);
+  void (*cfb8_encrypt)(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       unsigned char iv[16]);
+  void (*cfb8_decrypt)(const AesContext *ctx, size_t textsize,
+                       unsigned char *out, const unsigned char *in,
+                       unsigned char iv[16]);
+};
+
+/*
+ * Kernels used by AES-OFB, for full blocks only. `iv` holds the last key
+ * stream block & is advanced past the processed blocks.
+ */
+struct aes_ofb_vtable {
+  /* Writes `size` bytes of key stream. */
+  void (*keystream)(const AesContext *ctx, size_t size, unsigned char *out,
+                    unsigned char iv[16]);
+  void (*xcrypt)(const AesContext *ctx, size_t textsize, unsigned char *out,
+                 const unsigned char *in, unsigned char iv[16]);
+};
+
+/* Maximum number of keys wrapped or unwrapped together. */
+#define AES_KW_LANES 8
+
+/* A key being wrapped or unwrapped with the W & W^-1 functions of RFC 3394. */
+struct aes_kw_lane {
+  /* Integrity check register A */
+  unsigned char a[8];
+  /* Registers R[1] to R[n], 8 bytes each */
+  unsigned char *r;
+  size_t n;
+  /* The next step uses R[i + 1] & t; t goes from 1 to 6n when wrapping, from
+   * 6n down to 1 when unwrapping. */
+  size_t i;
+  uint64_t t;
+};
+
+/* Kernels used by AES key wrap; they run `nsteps` steps of each of `nlanes`
+ * (at most AES_KW_LANES) lanes. */
+struct aes_kw_vtable {
+  void (*wrap_lanes)(const AesContext *ctx, size_t nlanes,
+                     struct aes_kw_lane *lanes, size_t nsteps);
+  void (*unwrap_lanes)(const AesContext *ctx, size_t nlanes,
+                       struct aes_kw_lane *lanes, size_t nsteps);
+};
+
+/*
+ * Fixed-key hashes of 128-bit blocks, pi being AES under the key of ctx:
+ * CR: pi(x) ^ x; CCR: pi(sigma(x)) ^ sigma(x) with sigma(L || R) = (L ^ R) ||
+ * L; TCCR: pi(pi(x) ^ i) ^ pi(x), where the tweak i of block j is the 64-bit
+ * tweak + j in little-endian order, then 8 zero bytes. L is the first half of
+ * a block. textsize must be divisible by 16.
+ */
+enum aes_fixed_key_hash {
+  AES_FIXED_KEY_CR,
+  AES_FIXED_KEY_CCR,
+  AES_FIXED_KEY_TCCR
+};
+
+struct aes_fixed_key_vtable {
+  void (*cr)(const AesContext *ctx, size_t textsize, unsigned char *out,
+             const unsigned char *in);
+  void (*ccr)(const AesContext *ctx, size_t textsize, unsigned char *out,
+              const unsigned char *in);
+  void (*tccr)(const AesContext *ctx, size_t textsize, unsigned char *out,
+               const unsigned char *in, uint64_t tweak);
+};
+
+/* Maximum number of Haraka-512 chains advanced together by chain(). */
+#define AES_HARAKA_LANES 2
+
+/*
+ * Kernels of the keyed Haraka v2 hashes. rc holds the 40 round constants;
+ * round r of Haraka-256 uses rc[4r..4r+3] & round r of Haraka-512
+ * rc[8r..8r+7], two per state block.
+ */
+struct aes_haraka_vtable {
+  /* Haraka-256 of `count` 32-byte inputs, to as many 32-byte digests. */
+  void (*haraka256)(const unsigned char *rc, size_t count, unsigned char *out,
+                    const unsigned char *in);
+
+  /* Haraka-512 of `count` 64-byte inputs, to as many 32-byte digests. */
+  void (*haraka512)(const unsigned char *rc, size_t count, unsigned char *out,
+                    const unsigned char *in);
+
+  /* Advances `nlanes` (at most AES_HARAKA_LANES) chains by `nblocks` 32-byte
+   * blocks each: chain i reads from blocks[i], keeps its 32-byte chaining
+   * value at &h[i * 32] & replaces it by Haraka-512(h || block). */
+  void (*chain)(const unsigned char *rc, size_t nlanes, unsigned char *h,
+                size_t nblocks, const unsigned char *const *blocks);
+};
+
+/* Number of trailing zeros of x, which must not be 0. */
+static inline unsigned aes_ntz64(uint64_t x) {
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctzll(x);
+#else
+  unsigned n = 0;
+  for (; !(x & 1); x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+/* Multiplies a big-endian block by x in GF(2^128): double() of RFC 7253, the
+ * subkey derivation of CMAC. Doesn't branch on the bits of src. */
+static inline void aes_gf128_double(unsigned char dest[16],
+                                    const unsigned char src[16]) {
+  unsigned char carry = src[0] >> 7;
+  for (size_t i = 0; i < 15; ++i)
+    dest[i] = (unsigned char)((src[i] << 1) | (src[i + 1] >> 7));
+  dest[15] = (unsigned char)((src[15] << 1) ^ (0x87 & -carry));
+}
+
+/* Compares a & b in time independent of their contents; returns 0 if equal. */
+static inline int aes_ct_memcmp(const unsigned char *a, const unsigned char *b,
+                                size_t size) {
+  unsigned char diff = 0;
+  for (size_t i = 0; i < size; ++i)
+    diff |= a[i] ^ b[i];
+
+  return -(int)((diff + 0xffu) >> 8);
+}
+
 #endif
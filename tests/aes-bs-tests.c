@@ -424,6 +424,77 @@ static MunitResult test_aes256_ctr(const MunitParameter params[],
   return MUNIT_OK;
 }
 
+static MunitResult test_aes128_gcm(const MunitParameter params[],
+                                   void *user_data_or_fixture) {
+  /* Test Case 4 of "The Galois/Counter Mode of Operation (GCM)", run through
+   * the GHASH & CTR32 kernels directly. */
+  const unsigned char key[16] = {
+      0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94,
+      0x67, 0x30, 0x83, 0x08};
+  const unsigned char plain_text[60] = {
+      0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5,
+      0xaf, 0xf5, 0x26, 0x9a, 0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+      0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 0x1c, 0x3c, 0x0c, 0x95,
+      0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+      0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39};
+  /* AAD zero-padded to a whole number of blocks. */
+  const unsigned char aad[32] = {
+      0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce,
+      0xde, 0xad, 0xbe, 0xef, 0xab, 0xad, 0xda, 0xd2, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  const unsigned char j0[16] = {0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce,
+                                0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88,
+                                0x00, 0x00, 0x00, 0x01};
+  /* [len(A)]_64 || [len(C)]_64 in bits */
+  const unsigned char lengths[16] = {0, 0, 0, 0, 0, 0, 0, 0xa0,
+                                     0, 0, 0, 0, 0, 0, 0x01, 0xe0};
+  const unsigned char expected_cipher_text[60] = {
+      0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7,
+      0x84, 0xd0, 0xd4, 0x9c, 0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+      0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e, 0x21, 0xd5, 0x14, 0xb2,
+      0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+      0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91};
+  const unsigned char expected_tag[16] = {
+      0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a,
+      0xe7, 0x12, 0x1a, 0x47};
+  unsigned char counter[16], xi[16] = {0}, tag[16], cipher_text[60],
+      dec_text[60];
+
+  AesGcmContext ctx;
+  aesbs_init(&ctx.aes, 128, key);
+  aesbs_gcm_init(&ctx);
+
+  memcpy(counter, j0, 16);
+  counter[15] = 2;
+  aesbs_gcm_ghash(&ctx, xi, sizeof aad, aad);
+  aesbs_gcm_ctr32_encrypt(&ctx, sizeof plain_text, cipher_text, plain_text,
+                          counter, xi);
+  aesbs_gcm_ghash(&ctx, xi, sizeof lengths, lengths);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text);
+
+  aesbs_ecb_encrypt(&ctx.aes, 16, tag, j0);
+  for (size_t i = 0; i < 16; ++i)
+    tag[i] ^= xi[i];
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag);
+
+  memcpy(counter, j0, 16);
+  counter[15] = 2;
+  memset(xi, 0, sizeof xi);
+  aesbs_gcm_ghash(&ctx, xi, sizeof aad, aad);
+  aesbs_gcm_ctr32_decrypt(&ctx, sizeof cipher_text, dec_text, cipher_text,
+                          counter, xi);
+  aesbs_gcm_ghash(&ctx, xi, sizeof lengths, lengths);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  aesbs_ecb_encrypt(&ctx.aes, 16, tag, j0);
+  for (size_t i = 0; i < 16; ++i)
+    tag[i] ^= xi[i];
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag);
+
+  return MUNIT_OK;
+}
+
 static MunitTest tests[] = {
     {
         "/aes-128-ecb",         /* name */
@@ -439,6 +510,7 @@ static MunitTest tests[] = {
     {"/aes-128-ctr", test_aes128_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     {"/aes-192-ctr", test_aes192_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     {"/aes-256-ctr", test_aes256_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-128-gcm", test_aes128_gcm, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     /* Mark the end of the array with an entry where the test
      * function is NULL */
     {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};
@@ -424,6 +424,1712 @@ static MunitResult test_aes256_ctr(const MunitParameter params[],
   return MUNIT_OK;
 }
 
+static MunitResult test_aes_ctr_width(const MunitParameter params[],
+                                      void *user_data_or_fixture) {
+  const enum AesCtrWidth widths[3] = {AES_CTR_WIDTH_32, AES_CTR_WIDTH_64,
+                                      AES_CTR_WIDTH_128};
+  unsigned char key[16], zeros[56] = {0}, stream[56], next_iv[16];
+  AesContext ctx;
+
+  for (size_t i = 0; i < sizeof key; ++i)
+    key[i] = (unsigned char)i;
+  aes_init(&ctx, KEY_TYPE_AES128, key);
+
+  for (size_t w = 0; w < 3; ++w) {
+    size_t counter_size = (size_t)widths[w] / 8;
+    unsigned char iv[16], counter_blocks[64], expected_stream[64];
+
+    /* The counter starts 2 below its wrap; bytes before it stay fixed. */
+    for (size_t i = 0; i < 16; ++i)
+      iv[i] = (unsigned char)(i < 16 - counter_size ? 0xa0 + i : 0xff);
+    iv[15] = 0xfe;
+    for (size_t j = 0; j < 4; ++j) {
+      memcpy(&counter_blocks[j * 16], iv, 16 - counter_size);
+      memset(&counter_blocks[j * 16 + 16 - counter_size], 0, counter_size);
+      counter_blocks[j * 16 + 15] = (unsigned char)(j - 2);
+      if (j < 2)
+        memset(&counter_blocks[j * 16 + 16 - counter_size], 0xff,
+               counter_size - 1);
+    }
+    aes_ecb_encrypt(&ctx, sizeof counter_blocks, expected_stream,
+                    counter_blocks);
+
+    /* 3 full blocks & a partial one, which does not consume its counter */
+    aes_ctr_width_xcrypt(&ctx, widths[w], sizeof stream, stream, zeros, next_iv,
+                         iv);
+    munit_assert_memory_equal(sizeof stream, stream, expected_stream);
+    munit_assert_memory_equal(16, next_iv, &counter_blocks[48]);
+  }
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_stream(const MunitParameter params[],
+                                   void *user_data_or_fixture) {
+  /* From NIST SP 800-38A, F.2.1 (CBC-AES128) & F.5.1 (CTR-AES128) */
+  const unsigned char key[16] = {
+      0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+      0x09, 0xcf, 0x4f, 0x3c};
+  const unsigned char cbc_iv[16] = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+      0x0c, 0x0d, 0x0e, 0x0f};
+  const unsigned char ctr_iv[16] = {
+      0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+      0xfc, 0xfd, 0xfe, 0xff};
+  const unsigned char plain_text[64] = {
+      0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+      0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+      0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+      0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+      0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+      0xe6, 0x6c, 0x37, 0x10};
+  const unsigned char expected_cbc_cipher_text[64] = {
+      0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b,
+      0x12, 0xe9, 0x19, 0x7d, 0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee,
+      0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2, 0x73, 0xbe, 0xd6, 0xb8,
+      0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+      0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30,
+      0x75, 0x86, 0xe1, 0xa7};
+  const unsigned char expected_ctr_cipher_text[64] = {
+      0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64,
+      0x99, 0x0d, 0xb6, 0xce, 0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+      0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff, 0x5a, 0xe4, 0xdf, 0x3e,
+      0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+      0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0,
+      0xf3, 0x00, 0x9c, 0xee};
+  unsigned char text[64 + 15];
+  AesContext ctx;
+  AesCtrStreamContext ctr_ctx;
+  AesCbcStreamContext cbc_ctx;
+  size_t written;
+
+  /* Parts that don't line up with the blocks */
+  aes_ctr_stream_init(&ctr_ctx, KEY_TYPE_AES128, key, ctr_iv);
+  aes_ctr_stream_update(&ctr_ctx, 5, text, plain_text);
+  aes_ctr_stream_update(&ctr_ctx, 40, &text[5], &plain_text[5]);
+  aes_ctr_stream_update(&ctr_ctx, 19, &text[45], &plain_text[45]);
+  aes_ctr_stream_final(&ctr_ctx);
+  munit_assert_memory_equal(64, text, expected_ctr_cipher_text);
+
+  aes_ctr_stream_set_iv(&ctr_ctx, ctr_iv);
+  aes_ctr_stream_update(&ctr_ctx, 17, text, text);
+  aes_ctr_stream_update(&ctr_ctx, 1, &text[17], &text[17]);
+  aes_ctr_stream_update(&ctr_ctx, 46, &text[18], &text[18]);
+  aes_ctr_stream_final(&ctr_ctx);
+  munit_assert_memory_equal(64, text, plain_text);
+
+  /* Ranges of the message, from an offset in the middle of a block */
+  aes_init(&ctx, KEY_TYPE_AES128, key);
+  aes_ctr_xcrypt_at(&ctx, ctr_iv, 21, 30, text, &plain_text[21]);
+  munit_assert_memory_equal(30, text, &expected_ctr_cipher_text[21]);
+
+  aes_ctr_stream_seek(&ctr_ctx, ctr_iv, 37);
+  aes_ctr_stream_update(&ctr_ctx, 3, text, &plain_text[37]);
+  aes_ctr_stream_update(&ctr_ctx, 24, &text[3], &plain_text[40]);
+  aes_ctr_stream_final(&ctr_ctx);
+  munit_assert_memory_equal(27, text, &expected_ctr_cipher_text[37]);
+
+  /* Only whole blocks are written, the rest is held until the next part. */
+  aes_cbc_stream_init(&cbc_ctx, KEY_TYPE_AES128, key, cbc_iv);
+  written = aes_cbc_stream_encrypt_update(&cbc_ctx, 5, text, plain_text);
+  munit_assert_size(written, ==, 0);
+  written = aes_cbc_stream_encrypt_update(&cbc_ctx, 40, text, &plain_text[5]);
+  munit_assert_size(written, ==, 32);
+  written += aes_cbc_stream_encrypt_update(&cbc_ctx, 19, &text[written],
+                                           &plain_text[45]);
+  munit_assert_size(written, ==, 64);
+  munit_assert_int(aes_cbc_stream_final(&cbc_ctx), ==, 0);
+  munit_assert_memory_equal(64, text, expected_cbc_cipher_text);
+
+  aes_cbc_stream_set_iv(&cbc_ctx, cbc_iv);
+  written = aes_cbc_stream_decrypt_update(&cbc_ctx, 20, text,
+                                          expected_cbc_cipher_text);
+  munit_assert_size(written, ==, 16);
+  written += aes_cbc_stream_decrypt_update(&cbc_ctx, 44, &text[written],
+                                           &expected_cbc_cipher_text[20]);
+  munit_assert_size(written, ==, 64);
+  munit_assert_int(aes_cbc_stream_final(&cbc_ctx), ==, 0);
+  munit_assert_memory_equal(64, text, plain_text);
+
+  /* A message that is not a whole number of blocks */
+  aes_cbc_stream_set_iv(&cbc_ctx, cbc_iv);
+  written = aes_cbc_stream_encrypt_update(&cbc_ctx, 20, text, plain_text);
+  munit_assert_size(written, ==, 16);
+  munit_assert_int(aes_cbc_stream_final(&cbc_ctx), ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_gcm(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* From "The Galois/Counter Mode of Operation (GCM)" by McGrew & Viega */
+  const unsigned char key[16] = {
+      0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94,
+      0x67, 0x30, 0x83, 0x08};
+  const unsigned char key256[32] = {
+      0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94,
+      0x67, 0x30, 0x83, 0x08, 0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+      0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08};
+  const unsigned char plain_text[60] = {
+      0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5,
+      0xaf, 0xf5, 0x26, 0x9a, 0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+      0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 0x1c, 0x3c, 0x0c, 0x95,
+      0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+      0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39};
+  const unsigned char aad[20] = {
+      0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce,
+      0xde, 0xad, 0xbe, 0xef, 0xab, 0xad, 0xda, 0xd2};
+  const unsigned char iv[12] = {
+      0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88};
+  const unsigned char iv6[60] = {
+      0x93, 0x13, 0x22, 0x5d, 0xf8, 0x84, 0x06, 0xe5, 0x55, 0x90, 0x9c, 0x5a,
+      0xff, 0x52, 0x69, 0xaa, 0x6a, 0x7a, 0x95, 0x38, 0x53, 0x4f, 0x7d, 0xa1,
+      0xe4, 0xc3, 0x03, 0xd2, 0xa3, 0x18, 0xa7, 0x28, 0xc3, 0xc0, 0xc9, 0x51,
+      0x56, 0x80, 0x95, 0x39, 0xfc, 0xf0, 0xe2, 0x42, 0x9a, 0x6b, 0x52, 0x54,
+      0x16, 0xae, 0xdb, 0xf5, 0xa0, 0xde, 0x6a, 0x57, 0xa6, 0x37, 0xb3, 0x9b};
+  unsigned char cipher_text[60], dec_text[60], tag[16];
+  AesGcmContext ctx;
+
+  /* Test Case 4 */
+  const unsigned char expected_cipher_text4[60] = {
+      0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7,
+      0x84, 0xd0, 0xd4, 0x9c, 0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+      0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e, 0x21, 0xd5, 0x14, 0xb2,
+      0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+      0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91};
+  const unsigned char expected_tag4[16] = {
+      0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a,
+      0xe7, 0x12, 0x1a, 0x47};
+
+  aes_gcm_init(&ctx, KEY_TYPE_AES128, key);
+  aes_gcm_seal(&ctx, sizeof plain_text, cipher_text, plain_text, sizeof aad,
+               aad, sizeof iv, iv, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text4);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag4);
+
+  munit_assert_int(aes_gcm_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof aad, aad, sizeof iv, iv,
+                                sizeof tag, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  tag[15] ^= 1;
+  munit_assert_int(aes_gcm_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof aad, aad, sizeof iv, iv,
+                                sizeof tag, tag),
+                   ==, -1);
+
+  /* Tags are at most one block */
+  unsigned char long_tag[17];
+  munit_assert_int(aes_gcm_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, sizeof aad, aad, sizeof iv, iv,
+                                sizeof long_tag, long_tag),
+                   ==, -1);
+  munit_assert_int(aes_gcm_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, sizeof aad, aad, sizeof iv, iv, 0,
+                                long_tag),
+                   ==, -1);
+
+  /* IVs are at least 1 byte. */
+  munit_assert_int(aes_gcm_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, sizeof aad, aad, 0, NULL,
+                                sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_gcm_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof aad, aad, 0, NULL,
+                                sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_gmac(&ctx, sizeof aad, aad, 0, NULL, sizeof tag, tag),
+                   ==, -1);
+
+#if SIZE_MAX > UINT32_MAX
+  /* Past 2^32 - 2 blocks, the 32-bit counter would wrap back to J0. The
+   * sizes are rejected before any data is read. */
+  const size_t too_long = ((size_t)1 << 36) - 31;
+  munit_assert_int(aes_gcm_seal(&ctx, too_long, cipher_text, plain_text,
+                                sizeof aad, aad, sizeof iv, iv, sizeof tag,
+                                tag),
+                   ==, -1);
+  munit_assert_int(aes_gcm_open(&ctx, too_long, dec_text, cipher_text,
+                                sizeof aad, aad, sizeof iv, iv, sizeof tag,
+                                tag),
+                   ==, -1);
+#endif
+
+  /* Test Case 6 (60-byte IV) */
+  const unsigned char expected_cipher_text6[60] = {
+      0x8c, 0xe2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xb6, 0x03, 0xa0, 0x33, 0xac,
+      0xa1, 0x3f, 0xb8, 0x94, 0xbe, 0x91, 0x12, 0xa5, 0xc3, 0xa2, 0x11, 0xa8,
+      0xba, 0x26, 0x2a, 0x3c, 0xca, 0x7e, 0x2c, 0xa7, 0x01, 0xe4, 0xa9, 0xa4,
+      0xfb, 0xa4, 0x3c, 0x90, 0xcc, 0xdc, 0xb2, 0x81, 0xd4, 0x8c, 0x7c, 0x6f,
+      0xd6, 0x28, 0x75, 0xd2, 0xac, 0xa4, 0x17, 0x03, 0x4c, 0x34, 0xae, 0xe5};
+  const unsigned char expected_tag6[16] = {
+      0x61, 0x9c, 0xc5, 0xae, 0xff, 0xfe, 0x0b, 0xfa, 0x46, 0x2a, 0xf4, 0x3c,
+      0x16, 0x99, 0xd0, 0x50};
+
+  aes_gcm_seal(&ctx, sizeof plain_text, cipher_text, plain_text, sizeof aad,
+               aad, sizeof iv6, iv6, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text6);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag6);
+
+  /* Test Case 16 */
+  const unsigned char expected_cipher_text16[60] = {
+      0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37, 0xa3,
+      0x2a, 0x84, 0x42, 0x7d, 0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9,
+      0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa, 0x8c, 0xb0, 0x8e, 0x48,
+      0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38,
+      0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 0xbc, 0xc9, 0xf6, 0x62};
+  const unsigned char expected_tag16[16] = {
+      0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53,
+      0xbb, 0x2d, 0x55, 0x1b};
+
+  aes_gcm_init(&ctx, KEY_TYPE_AES256, key256);
+  aes_gcm_seal(&ctx, sizeof plain_text, cipher_text, plain_text, sizeof aad,
+               aad, sizeof iv, iv, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text16);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag16);
+
+  munit_assert_int(aes_gcm_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof aad, aad, sizeof iv, iv,
+                                sizeof tag, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  /* 16 KiB + 5 bytes, to go through the stitched loop & the tail */
+  static unsigned char long_text[16389], long_cipher_text[16389];
+  for (size_t i = 0; i < sizeof long_text; ++i)
+    long_text[i] = (unsigned char)(i * 7);
+  const unsigned char expected_long_tag[16] = {
+      0xcb, 0x62, 0x87, 0xaf, 0xe9, 0x57, 0xf2, 0x27, 0x12, 0x7e, 0x17, 0x02,
+      0xfa, 0xfc, 0x1e, 0x94};
+
+  aes_gcm_init(&ctx, KEY_TYPE_AES128, key);
+  aes_gcm_seal(&ctx, sizeof long_text, long_cipher_text, long_text,
+               sizeof aad, aad, sizeof iv, iv, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof tag, tag, expected_long_tag);
+
+  munit_assert_int(aes_gcm_open(&ctx, sizeof long_cipher_text,
+                                long_cipher_text, long_cipher_text, sizeof aad,
+                                aad, sizeof iv, iv, sizeof tag, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof long_text, long_cipher_text, long_text);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_gcm_siv(const MunitParameter params[],
+                                    void *user_data_or_fixture) {
+  /* From RFC 8452, Appendix C */
+  const unsigned char key128[16] = {
+      0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00};
+  const unsigned char key256[32] = {
+      0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  const unsigned char nonce[12] = {
+      0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  const unsigned char plain_text[36] = {
+      0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00};
+  const unsigned char aad[18] = {
+      0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x02, 0x00};
+  const unsigned char plain_text128[32] = {
+      0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  unsigned char cipher_text[36], dec_text[36], tag[16];
+  AesGcmSivContext ctx;
+
+  /* AES-128, 2 blocks of plain text & 1 byte of AAD */
+  const unsigned char expected_cipher_text128[32] = {
+      0x9b, 0x12, 0xb6, 0xf5, 0xe3, 0x01, 0x4e, 0x46, 0x20, 0xb2, 0x9f, 0x37,
+      0xda, 0xf6, 0x7d, 0xfe, 0x2b, 0x35, 0x8c, 0x81, 0x57, 0xd8, 0xcb, 0x9e,
+      0x3f, 0x35, 0x38, 0x1a, 0x25, 0x6f, 0xd4, 0xdb};
+  const unsigned char expected_tag128[16] = {
+      0xb5, 0xe7, 0xa1, 0xa1, 0xc0, 0x52, 0x9a, 0x16, 0x21, 0x5d, 0x3c, 0x7e,
+      0xf4, 0xe1, 0x36, 0x1c};
+
+  aes_gcm_siv_init(&ctx, KEY_TYPE_AES128, key128);
+  aes_gcm_siv_seal(&ctx, 32, cipher_text, plain_text128, 1, aad, nonce, tag);
+  munit_assert_memory_equal(32, cipher_text, expected_cipher_text128);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag128);
+
+  munit_assert_int(
+      aes_gcm_siv_open(&ctx, 32, dec_text, cipher_text, 1, aad, nonce, tag),
+      ==, 0);
+  munit_assert_memory_equal(32, dec_text, plain_text128);
+
+  tag[0] ^= 0x80;
+  munit_assert_int(
+      aes_gcm_siv_open(&ctx, 32, dec_text, cipher_text, 1, aad, nonce, tag),
+      ==, -1);
+
+  /* AES-256, partial blocks of plain text & AAD */
+  const unsigned char expected_cipher_text256[36] = {
+      0xc0, 0xba, 0x42, 0x3f, 0xad, 0x64, 0x17, 0x64, 0x4c, 0xe4, 0x6d, 0x05,
+      0xc1, 0xc4, 0x1e, 0x48, 0x6c, 0xbe, 0x9f, 0x78, 0xaf, 0x8d, 0xe0, 0x03,
+      0x62, 0x82, 0xd1, 0x29, 0xee, 0xb2, 0x04, 0x80, 0xd1, 0xfe, 0x67, 0x46};
+  const unsigned char expected_tag256[16] = {
+      0xdc, 0x11, 0x40, 0xea, 0xc4, 0xe9, 0xf6, 0xe3, 0xfa, 0xd6, 0xd5, 0xde,
+      0x24, 0x50, 0x33, 0xd6};
+
+  aes_gcm_siv_init(&ctx, KEY_TYPE_AES256, key256);
+  aes_gcm_siv_seal(&ctx, sizeof plain_text, cipher_text, plain_text,
+                   sizeof aad, aad, nonce, tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text256);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag256);
+
+  munit_assert_int(aes_gcm_siv_open(&ctx, sizeof cipher_text, dec_text,
+                                    cipher_text, sizeof aad, aad, nonce, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+#if SIZE_MAX > UINT32_MAX
+  /* RFC 8452 allows at most 2^36 bytes of text & of AAD; the sizes are
+   * rejected before any data is read. */
+  const size_t too_long = ((size_t)1 << 36) + 1;
+  munit_assert_int(aes_gcm_siv_seal(&ctx, too_long, cipher_text, plain_text,
+                                    sizeof aad, aad, nonce, tag),
+                   ==, -1);
+  munit_assert_int(aes_gcm_siv_seal(&ctx, sizeof plain_text, cipher_text,
+                                    plain_text, too_long, aad, nonce, tag),
+                   ==, -1);
+  munit_assert_int(aes_gcm_siv_open(&ctx, too_long, dec_text, cipher_text,
+                                    sizeof aad, aad, nonce, tag),
+                   ==, -1);
+#endif
+
+  /* RFC 8452 has no AES-192 variant. */
+  munit_assert_int(aes_gcm_siv_init(&ctx, KEY_TYPE_AES192, key256), ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_aegis(const MunitParameter params[],
+                                  void *user_data_or_fixture) {
+  /* Test vectors 3 & 4 of draft-irtf-cfrg-aegis-aead; vector 4 encrypts the
+   * first 14 bytes of vector 3 and is checked with its 256-bit tags. */
+  const unsigned char key[32] = {0x10, 0x01};
+  const unsigned char nonce[32] = {0x10, 0x00, 0x02};
+  const unsigned char aad[8] = {0x00, 0x01, 0x02, 0x03,
+                                0x04, 0x05, 0x06, 0x07};
+  const unsigned char plain_text[32] = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+      0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+      0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f};
+  const unsigned char expected_128l[32] = {
+      0x79, 0xd9, 0x45, 0x93, 0xd8, 0xc2, 0x11, 0x9d, 0x7e, 0x8f, 0xd9, 0xb8,
+      0xfc, 0x77, 0x84, 0x5c, 0x5c, 0x07, 0x7a, 0x05, 0xb2, 0x52, 0x8b, 0x6a,
+      0xc5, 0x4b, 0x56, 0x3a, 0xed, 0x8e, 0xfe, 0x84};
+  const unsigned char expected_tag_128l[16] = {
+      0xcc, 0x6f, 0x33, 0x72, 0xf6, 0xaa, 0x1b, 0xb8, 0x23, 0x88, 0xd6, 0x95,
+      0xc3, 0x96, 0x2d, 0x9a};
+  const unsigned char expected_tag256_128l[32] = {
+      0x86, 0xf1, 0xb8, 0x0b, 0xfb, 0x46, 0x3a, 0xba, 0x71, 0x1d, 0x15, 0x40,
+      0x5d, 0x09, 0x4b, 0xaf, 0x4a, 0x55, 0xa1, 0x5d, 0xbf, 0xec, 0x81, 0xa7,
+      0x6f, 0x35, 0xed, 0x0b, 0x9c, 0x8b, 0x04, 0xac};
+  const unsigned char expected_256[32] = {
+      0xf3, 0x73, 0x07, 0x9e, 0xd8, 0x4b, 0x27, 0x09, 0xfa, 0xee, 0x37, 0x35,
+      0x84, 0x58, 0x5d, 0x60, 0xac, 0xcd, 0x19, 0x1d, 0xb3, 0x10, 0xef, 0x5d,
+      0x8b, 0x11, 0x83, 0x3d, 0xf9, 0xde, 0xc7, 0x11};
+  const unsigned char expected_tag_256[16] = {
+      0x8d, 0x86, 0xf9, 0x1e, 0xe6, 0x06, 0xe9, 0xff, 0x26, 0xa0, 0x1b, 0x64,
+      0xcc, 0xbd, 0xd9, 0x1d};
+  const unsigned char expected_tag256_256[32] = {
+      0x8c, 0x1c, 0xc7, 0x03, 0xc8, 0x12, 0x81, 0xbe, 0xe3, 0xf6, 0xd9, 0x96,
+      0x6e, 0x14, 0x94, 0x8b, 0x4a, 0x17, 0x5b, 0x2e, 0xfb, 0xdc, 0x31, 0xe6,
+      0x1a, 0x98, 0xb4, 0x46, 0x52, 0x35, 0xc2, 0xd9};
+  static const unsigned char zeros[14];
+  unsigned char text[32], tag[32];
+  AesAegis128lContext ctx128l;
+  AesAegis256Context ctx256;
+
+  aes_aegis128l_init(&ctx128l, key);
+  aes_aegis128l_seal(&ctx128l, sizeof plain_text, text, plain_text, sizeof aad,
+                     aad, nonce, 16, tag);
+  munit_assert_memory_equal(sizeof expected_128l, text, expected_128l);
+  munit_assert_memory_equal(16, tag, expected_tag_128l);
+  munit_assert_int(aes_aegis128l_open(&ctx128l, sizeof text, text, text,
+                                      sizeof aad, aad, nonce, 16, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof plain_text, text, plain_text);
+
+  /* A partial last block & a 256-bit tag */
+  aes_aegis128l_seal(&ctx128l, 14, text, plain_text, sizeof aad, aad, nonce,
+                     32, tag);
+  munit_assert_memory_equal(14, text, expected_128l);
+  munit_assert_memory_equal(32, tag, expected_tag256_128l);
+
+  /* A tampered tag zeroes the plain text. */
+  tag[31] ^= 1;
+  munit_assert_int(aes_aegis128l_open(&ctx128l, 14, text, text, sizeof aad, aad,
+                                      nonce, 32, tag),
+                   ==, -1);
+  munit_assert_memory_equal(14, text, zeros);
+
+  aes_aegis256_init(&ctx256, key);
+  aes_aegis256_seal(&ctx256, sizeof plain_text, text, plain_text, sizeof aad,
+                    aad, nonce, 16, tag);
+  munit_assert_memory_equal(sizeof expected_256, text, expected_256);
+  munit_assert_memory_equal(16, tag, expected_tag_256);
+  munit_assert_int(aes_aegis256_open(&ctx256, sizeof text, text, text,
+                                     sizeof aad, aad, nonce, 16, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof plain_text, text, plain_text);
+
+  aes_aegis256_seal(&ctx256, 14, text, plain_text, sizeof aad, aad, nonce, 32,
+                    tag);
+  munit_assert_memory_equal(14, text, expected_256);
+  munit_assert_memory_equal(32, tag, expected_tag256_256);
+  munit_assert_int(aes_aegis256_open(&ctx256, 14, text, text, sizeof aad, aad,
+                                     nonce, 32, tag),
+                   ==, 0);
+  munit_assert_memory_equal(14, text, plain_text);
+
+  /* Only 128 & 256-bit tags exist. */
+  munit_assert_int(aes_aegis256_open(&ctx256, 14, text, text, sizeof aad, aad,
+                                     nonce, 24, tag),
+                   ==, -1);
+  unsigned char short_tag[8];
+  munit_assert_int(aes_aegis128l_seal(&ctx128l, 14, text, plain_text,
+                                      sizeof aad, aad, nonce, sizeof short_tag,
+                                      short_tag),
+                   ==, -1);
+  munit_assert_int(aes_aegis256_seal(&ctx256, 14, text, plain_text, sizeof aad,
+                                     aad, nonce, 24, tag),
+                   ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_ghash(const MunitParameter params[],
+                                  void *user_data_or_fixture) {
+  /* GMAC: gcmEncryptExtIV128.rsp of the NIST CAVP, an empty plain text */
+  const unsigned char key[16] = {0x77, 0xbe, 0x63, 0x70, 0x89, 0x71,
+                                 0xc4, 0xe2, 0x40, 0xd1, 0xcb, 0x79,
+                                 0xe8, 0xd7, 0x7f, 0xeb};
+  const unsigned char iv[12] = {0xe0, 0xe0, 0x0f, 0x19, 0xfe, 0xd7,
+                                0xba, 0x01, 0x36, 0xa7, 0x97, 0xf3};
+  const unsigned char aad[16] = {0x7a, 0x43, 0xec, 0x1d, 0x9c, 0x0a,
+                                 0x5a, 0x78, 0xa0, 0xb1, 0x65, 0x33,
+                                 0xa6, 0x21, 0x3c, 0xab};
+  const unsigned char expected_tag[16] = {0x20, 0x9f, 0xcc, 0x8d, 0x36, 0x75,
+                                          0xed, 0x93, 0x8e, 0x9c, 0x71, 0x66,
+                                          0x70, 0x9d, 0xd9, 0x46};
+  unsigned char tag[16];
+  AesGcmContext gcm_ctx;
+
+  aes_gcm_init(&gcm_ctx, KEY_TYPE_AES128, key);
+  aes_gmac(&gcm_ctx, sizeof aad, aad, sizeof iv, iv, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag);
+  munit_assert_int(aes_gmac_verify(&gcm_ctx, sizeof aad, aad, sizeof iv, iv,
+                                   sizeof tag, tag),
+                   ==, 0);
+  tag[15] ^= 1;
+  munit_assert_int(aes_gmac_verify(&gcm_ctx, sizeof aad, aad, sizeof iv, iv,
+                                   sizeof tag, tag),
+                   ==, -1);
+
+  unsigned char long_tag[17];
+  munit_assert_int(aes_gmac(&gcm_ctx, sizeof aad, aad, sizeof iv, iv,
+                            sizeof long_tag, long_tag),
+                   ==, -1);
+
+  /* GHASH of test case 2 of the GCM spec: C, then the lengths block */
+  const unsigned char h[16] = {0x66, 0xe9, 0x4b, 0xd4, 0xef, 0x8a, 0x2c, 0x3b,
+                               0x88, 0x4c, 0xfa, 0x59, 0xca, 0x34, 0x2b, 0x2e};
+  const unsigned char cipher_text[16] = {0x03, 0x88, 0xda, 0xce, 0x60, 0xb6,
+                                         0xa3, 0x92, 0xf3, 0x28, 0xc2, 0xb9,
+                                         0x71, 0xb2, 0xfe, 0x78};
+  const unsigned char lengths[16] = {0, 0, 0, 0, 0, 0, 0, 0,
+                                     0, 0, 0, 0, 0, 0, 0, 0x80};
+  const unsigned char expected_ghash[16] = {
+      0xf3, 0x8c, 0xbb, 0x1a, 0xd6, 0x92, 0x23, 0xdc,
+      0xc3, 0x45, 0x7a, 0xe5, 0xb6, 0xb0, 0xf8, 0x85};
+  unsigned char hash[16];
+  AesGhashContext ctx;
+
+  aes_ghash_init(&ctx, h);
+  aes_ghash_update(&ctx, 5, cipher_text);
+  aes_ghash_update(&ctx, sizeof cipher_text - 5, &cipher_text[5]);
+  aes_ghash_update(&ctx, sizeof lengths, lengths);
+  aes_ghash_final(&ctx, hash);
+  munit_assert_memory_equal(sizeof hash, hash, expected_ghash);
+
+  /* Padding between parts, as with the AAD of GCM */
+  aes_ghash_reset(&ctx);
+  aes_ghash_update(&ctx, 0, NULL);
+  aes_ghash_pad(&ctx);
+  aes_ghash_update(&ctx, sizeof cipher_text, cipher_text);
+  aes_ghash_pad(&ctx);
+  aes_ghash_update(&ctx, sizeof lengths, lengths);
+  aes_ghash_final(&ctx, hash);
+  munit_assert_memory_equal(sizeof hash, hash, expected_ghash);
+
+  /* POLYVAL: RFC 8452, appendix A */
+  const unsigned char polyval_h[16] = {0x25, 0x62, 0x93, 0x47, 0x58, 0x92,
+                                       0x42, 0x76, 0x1d, 0x31, 0xf8, 0x26,
+                                       0xba, 0x4b, 0x75, 0x7b};
+  const unsigned char blocks[32] = {
+      0x4f, 0x4f, 0x95, 0x66, 0x8c, 0x83, 0xdf, 0xb6, 0x40, 0x17, 0x62,
+      0xbb, 0x2d, 0x01, 0xa2, 0x62, 0xd1, 0xa2, 0x4d, 0xdd, 0x27, 0x21,
+      0xd0, 0x06, 0xbb, 0xe4, 0x5f, 0x20, 0xd3, 0xc9, 0xf3, 0x62};
+  const unsigned char expected_polyval[16] = {
+      0xf7, 0xa3, 0xb4, 0x7b, 0x84, 0x61, 0x19, 0xfa,
+      0xe5, 0xb7, 0x86, 0x6c, 0xf5, 0xe5, 0xb7, 0x7e};
+
+  aes_polyval_init(&ctx, polyval_h);
+  aes_ghash_update(&ctx, sizeof blocks, blocks);
+  aes_ghash_final(&ctx, hash);
+  munit_assert_memory_equal(sizeof hash, hash, expected_polyval);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_xts(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* Keys & tweak of IEEE 1619 vector 15; 9 full blocks & ciphertext stealing
+   * (cipher text from OpenSSL) */
+  const unsigned char key[32] = {
+      0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4,
+      0xf3, 0xf2, 0xf1, 0xf0, 0xbf, 0xbe, 0xbd, 0xbc, 0xbb, 0xba, 0xb9, 0xb8,
+      0xb7, 0xb6, 0xb5, 0xb4, 0xb3, 0xb2, 0xb1, 0xb0};
+  const unsigned char tweak[16] = {0x12, 0x34, 0x56, 0x78, 0x9a};
+  const unsigned char expected_cts[150] = {
+      0x95, 0xc8, 0x71, 0xf6, 0x52, 0x24, 0x69, 0xcc, 0x73, 0x71, 0x09, 0x59,
+      0x4a, 0xb0, 0xfe, 0xda, 0x38, 0x3a, 0x90, 0xc3, 0x32, 0x0b, 0x91, 0xb5,
+      0xba, 0x5b, 0xc8, 0xbc, 0xf0, 0x89, 0xa0, 0x9e, 0xdd, 0x10, 0xa7, 0x3b,
+      0x56, 0x38, 0xee, 0x92, 0x4f, 0x7a, 0xbd, 0x22, 0x3f, 0xc6, 0x34, 0xcf,
+      0xe3, 0xde, 0x81, 0xcd, 0x3d, 0x1f, 0x9b, 0x71, 0x9b, 0xb7, 0x9a, 0x9f,
+      0x8d, 0x0b, 0x02, 0x7b, 0x0d, 0x89, 0x26, 0xb1, 0x38, 0xe2, 0x76, 0xd5,
+      0x88, 0xa5, 0x80, 0x57, 0x26, 0xba, 0x51, 0x72, 0x39, 0xe6, 0xad, 0x02,
+      0x48, 0xee, 0x82, 0xbf, 0xb5, 0x5f, 0x91, 0x3c, 0x89, 0x00, 0xd5, 0x1d,
+      0xeb, 0xc3, 0xbf, 0xca, 0xe9, 0xd6, 0x6d, 0x29, 0xe6, 0x47, 0xaf, 0x82,
+      0xc1, 0x3a, 0x62, 0x9d, 0x1d, 0xca, 0x13, 0x10, 0x1d, 0x5d, 0x75, 0x6c,
+      0x86, 0x24, 0x3d, 0x29, 0xfd, 0x1a, 0x97, 0x0a, 0x50, 0x51, 0xfa, 0x23,
+      0xb3, 0xcc, 0xd3, 0x14, 0x9d, 0x32, 0xa9, 0x18, 0x52, 0x30, 0x30, 0x9b,
+      0x9d, 0x37, 0xdf, 0xd9, 0xda, 0x61};
+  unsigned char plain_text[150], cipher_text[150], dec_text[150];
+  AesXtsContext ctx;
+
+  for (size_t i = 0; i < sizeof plain_text; ++i)
+    plain_text[i] = (unsigned char)i;
+
+  munit_assert_int(aes_xts_init(&ctx, KEY_TYPE_AES128, key), ==, 0);
+  aes_xts_encrypt(&ctx, sizeof plain_text, cipher_text, plain_text, tweak);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text, expected_cts);
+
+  aes_xts_decrypt(&ctx, sizeof cipher_text, dec_text, cipher_text, tweak);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  /* IEEE 1619 vector 4 is sector 0; 10 sectors span two tweak batches */
+  const unsigned char key_sectors[32] = {
+      0x27, 0x18, 0x28, 0x18, 0x28, 0x45, 0x90, 0x45, 0x23, 0x53, 0x60, 0x28,
+      0x74, 0x71, 0x35, 0x26, 0x31, 0x41, 0x59, 0x26, 0x53, 0x58, 0x97, 0x93,
+      0x23, 0x84, 0x62, 0x64, 0x33, 0x83, 0x27, 0x95};
+  const unsigned char expected_sector0[32] = {
+      0x27, 0xa7, 0x47, 0x9b, 0xef, 0xa1, 0xd4, 0x76, 0x48, 0x9f, 0x30, 0x8c,
+      0xd4, 0xcf, 0xa6, 0xe2, 0xa9, 0x6e, 0x4b, 0xbe, 0x32, 0x08, 0xff, 0x25,
+      0x28, 0x7d, 0xd3, 0x81, 0x96, 0x16, 0xe8, 0x9c};
+  const unsigned char expected_sector2[16] = {
+      0x6f, 0xc5, 0x04, 0x7c, 0xa7, 0x9b, 0x06, 0x22, 0x07, 0xbe, 0x63, 0x85,
+      0xd3, 0xb6, 0xbd, 0x44};
+  const unsigned char tweak_sector9[16] = {9};
+  static unsigned char sectors[10 * 512], enc_sectors[10 * 512],
+      dec_sectors[10 * 512];
+  unsigned char enc_sector9[512];
+
+  for (size_t i = 0; i < sizeof sectors; ++i)
+    sectors[i] = (unsigned char)i;
+
+  aes_xts_init(&ctx, KEY_TYPE_AES128, key_sectors);
+  aes_xts_encrypt_sectors(&ctx, 512, 10, enc_sectors, sectors, 0);
+  munit_assert_memory_equal(sizeof expected_sector0, enc_sectors,
+                            expected_sector0);
+  munit_assert_memory_equal(sizeof expected_sector2, &enc_sectors[2 * 512],
+                            expected_sector2);
+
+  aes_xts_encrypt(&ctx, 512, enc_sector9, &sectors[9 * 512], tweak_sector9);
+  munit_assert_memory_equal(512, &enc_sectors[9 * 512], enc_sector9);
+
+  aes_xts_decrypt_sectors(&ctx, 512, 10, dec_sectors, enc_sectors, 0);
+  munit_assert_memory_equal(sizeof dec_sectors, dec_sectors, sectors);
+
+  /* Data units shorter than a block have nothing to steal from. */
+  munit_assert_int(aes_xts_encrypt(&ctx, 15, enc_sector9, sectors,
+                                   tweak_sector9),
+                   ==, -1);
+  munit_assert_int(aes_xts_decrypt(&ctx, 1, dec_sectors, enc_sectors,
+                                   tweak_sector9),
+                   ==, -1);
+  munit_assert_int(aes_xts_encrypt_sectors(&ctx, 15, 2, enc_sectors, sectors,
+                                           0),
+                   ==, -1);
+  munit_assert_int(aes_xts_decrypt_sectors(&ctx, 0, 2, dec_sectors,
+                                           enc_sectors, 0),
+                   ==, -1);
+
+  /* IEEE 1619 has no AES-192 variant. */
+  munit_assert_int(aes_xts_init(&ctx, KEY_TYPE_AES192, key_sectors), ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_hctr2(const MunitParameter params[],
+                                  void *user_data_or_fixture) {
+  /* Computed with an independent implementation of HCTR2 */
+  const unsigned char key[16] = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+      0x0c, 0x0d, 0x0e, 0x0f};
+  const unsigned char tweak[16] = {
+      0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b,
+      0x2c, 0x2d, 0x2e, 0x2f};
+  const unsigned char plain_text[31] = {
+      0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b,
+      0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+      0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e};
+  const unsigned char expected_cipher_text[31] = {
+      0x03, 0xf8, 0x75, 0xce, 0x51, 0x94, 0x5c, 0xbc, 0xd7, 0xe3, 0x55, 0x91,
+      0xb5, 0xdd, 0xf2, 0x2d, 0xe6, 0xbe, 0x23, 0x0a, 0xc0, 0x7f, 0x3b, 0x82,
+      0xd9, 0x2a, 0x03, 0xf7, 0xc5, 0x55, 0x25};
+  /* A single block, with an empty tweak */
+  const unsigned char block[16] = {
+      0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b,
+      0x8c, 0x8d, 0x8e, 0x8f};
+  const unsigned char expected_block[16] = {
+      0x7c, 0x30, 0x6a, 0x1d, 0x86, 0xd1, 0x15, 0x83, 0x68, 0x73, 0xef, 0x88,
+      0x08, 0x0e, 0x2f, 0x9c};
+  unsigned char cipher_text[31], dec_text[31];
+  AesHctr2Context ctx;
+
+  aes_hctr2_init(&ctx, KEY_TYPE_AES128, key);
+  aes_hctr2_encrypt(&ctx, sizeof cipher_text, cipher_text, plain_text,
+                    sizeof tweak, tweak);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text);
+
+  /* Decrypting in place */
+  memcpy(dec_text, cipher_text, sizeof dec_text);
+  aes_hctr2_decrypt(&ctx, sizeof dec_text, dec_text, dec_text, sizeof tweak,
+                    tweak);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  aes_hctr2_encrypt(&ctx, sizeof block, cipher_text, block, 0, NULL);
+  munit_assert_memory_equal(sizeof expected_block, cipher_text,
+                            expected_block);
+  aes_hctr2_decrypt(&ctx, sizeof block, dec_text, cipher_text, 0, NULL);
+  munit_assert_memory_equal(sizeof block, dec_text, block);
+
+  /* AES-256 with a 32-byte tweak, & whole blocks (the other domain of the
+   * hash) */
+  const unsigned char expected_cipher_text256[64] = {
+      0x3c, 0xc3, 0x78, 0xf4, 0xec, 0xfd, 0xa3, 0x53, 0x23, 0x31, 0xf9, 0xc9,
+      0x53, 0xe7, 0x71, 0xdf, 0x5b, 0x23, 0x2c, 0x08, 0x06, 0xce, 0x67, 0x5d,
+      0x73, 0x25, 0x3c, 0x21, 0xb5, 0xcb, 0xd5, 0x57, 0x9a, 0x85, 0xe1, 0x88,
+      0x18, 0xd8, 0xc3, 0x1d, 0x6f, 0x14, 0x90, 0x06, 0x0d, 0x05, 0x17, 0xbd,
+      0x61, 0x2c, 0x09, 0xe8, 0x11, 0x1d, 0xd5, 0x1b, 0x76, 0xdd, 0xa0, 0xe4,
+      0xf0, 0x50, 0xad, 0x5f};
+  unsigned char key256[32], tweak256[32], text256[64];
+
+  for (size_t i = 0; i < sizeof key256; ++i) {
+    key256[i] = (unsigned char)(0x60 + i);
+    tweak256[i] = (unsigned char)(0xa0 + i);
+  }
+  for (size_t i = 0; i < sizeof text256; ++i)
+    text256[i] = (unsigned char)(0xc0 + i);
+
+  aes_hctr2_init(&ctx, KEY_TYPE_AES256, key256);
+  aes_hctr2_encrypt(&ctx, sizeof text256, text256, text256, sizeof tweak256,
+                    tweak256);
+  munit_assert_memory_equal(sizeof text256, text256, expected_cipher_text256);
+  aes_hctr2_decrypt(&ctx, sizeof text256, text256, text256, sizeof tweak256,
+                    tweak256);
+  for (size_t i = 0; i < sizeof text256; ++i)
+    munit_assert_uint8(text256[i], ==, 0xc0 + i);
+
+  /* Shorter than a block */
+  munit_assert_int(aes_hctr2_encrypt(&ctx, 15, cipher_text, block, 0, NULL),
+                   ==, -1);
+  munit_assert_int(aes_hctr2_decrypt(&ctx, 15, dec_text, cipher_text, 0, NULL),
+                   ==, -1);
+
+  return MUNIT_OK;
+}
+
+/* num2str(n, 96) of RFC 7253 */
+static void ocb_test_nonce(unsigned char nonce[12], size_t n) {
+  memset(nonce, 0, 12);
+  nonce[10] = (unsigned char)(n >> 8);
+  nonce[11] = (unsigned char)n;
+}
+
+static MunitResult test_aes_ocb(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* From RFC 7253, Appendix A */
+  const unsigned char key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+                                 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+                                 0x0c, 0x0d, 0x0e, 0x0f};
+  const unsigned char nonce[12] = {
+      0xbb, 0xaa, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x0d};
+  const unsigned char expected_cipher_text[40] = {
+      0xd5, 0xca, 0x91, 0x74, 0x84, 0x10, 0xc1, 0x75, 0x1f, 0xf8, 0xa2, 0xf6,
+      0x18, 0x25, 0x5b, 0x68, 0xa0, 0xa1, 0x2e, 0x09, 0x3f, 0xf4, 0x54, 0x60,
+      0x6e, 0x59, 0xf9, 0xc1, 0xd0, 0xdd, 0xc5, 0x4b, 0x65, 0xe8, 0x62, 0x8e,
+      0x56, 0x8b, 0xad, 0x7a};
+  const unsigned char expected_tag[16] = {
+      0xed, 0x07, 0xba, 0x06, 0xa4, 0xa6, 0x94, 0x83, 0xa7, 0x03, 0x54, 0x90,
+      0xc5, 0x76, 0x9e, 0x60};
+  unsigned char plain_text[40], cipher_text[40], dec_text[40], tag[16];
+  AesOcbContext ctx;
+
+  for (size_t i = 0; i < sizeof plain_text; ++i)
+    plain_text[i] = (unsigned char)i;
+
+  aes_ocb_init(&ctx, KEY_TYPE_AES128, key);
+  aes_ocb_seal(&ctx, sizeof plain_text, cipher_text, plain_text,
+               sizeof plain_text, plain_text, sizeof nonce, nonce, sizeof tag,
+               tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag);
+
+  munit_assert_int(aes_ocb_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof plain_text, plain_text,
+                                sizeof nonce, nonce, sizeof tag, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  tag[15] ^= 1;
+  munit_assert_int(aes_ocb_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof plain_text, plain_text,
+                                sizeof nonce, nonce, sizeof tag, tag),
+                   ==, -1);
+
+  /* Nonces must leave room for the 1 bit before them in the nonce block. */
+  unsigned char long_nonce[16] = {0}, long_tag[17];
+  munit_assert_int(aes_ocb_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, 0, NULL, sizeof long_nonce,
+                                long_nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ocb_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, 0, NULL, 0, NULL, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ocb_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, 0, NULL, sizeof long_nonce,
+                                long_nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ocb_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, 0, NULL, sizeof nonce, nonce,
+                                sizeof long_tag, long_tag),
+                   ==, -1);
+
+#if SIZE_MAX > UINT32_MAX
+  /* Blocks are numbered below 2^32; the sizes are rejected before any data
+   * is read. */
+  const size_t too_long = (size_t)1 << 36;
+  munit_assert_int(aes_ocb_seal(&ctx, too_long, cipher_text, plain_text, 0,
+                                NULL, sizeof nonce, nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ocb_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, too_long, plain_text, sizeof nonce,
+                                nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ocb_open(&ctx, too_long, dec_text, cipher_text, 0, NULL,
+                                sizeof nonce, nonce, sizeof tag, tag),
+                   ==, -1);
+#endif
+
+  /* The iterated test of RFC 7253, Appendix A, for 128-bit tags */
+  const unsigned char iterated_key[16] = {[15] = 0x80};
+  const unsigned char expected_iterated_tag[16] = {
+      0x67, 0xe9, 0x44, 0xd2, 0x32, 0x56, 0xc5, 0xe0, 0xb6, 0xc6, 0x1f, 0xa2,
+      0x2f, 0xdf, 0x1e, 0xa2};
+  static unsigned char c[22400];
+  unsigned char s[128] = {0}, iterated_nonce[12];
+  size_t c_size = 0;
+
+  aes_ocb_init(&ctx, KEY_TYPE_AES128, iterated_key);
+  for (size_t i = 0; i < 128; ++i) {
+    ocb_test_nonce(iterated_nonce, 3 * i + 1);
+    aes_ocb_seal(&ctx, i, &c[c_size], s, i, s, 12, iterated_nonce, 16,
+                 &c[c_size + i]);
+    c_size += i + 16;
+
+    ocb_test_nonce(iterated_nonce, 3 * i + 2);
+    aes_ocb_seal(&ctx, i, &c[c_size], s, 0, NULL, 12, iterated_nonce, 16,
+                 &c[c_size + i]);
+    c_size += i + 16;
+
+    ocb_test_nonce(iterated_nonce, 3 * i + 3);
+    aes_ocb_seal(&ctx, 0, NULL, NULL, i, s, 12, iterated_nonce, 16,
+                 &c[c_size]);
+    c_size += 16;
+  }
+
+  ocb_test_nonce(iterated_nonce, 385);
+  aes_ocb_seal(&ctx, 0, NULL, NULL, c_size, c, 12, iterated_nonce, 16, tag);
+  munit_assert_size(c_size, ==, sizeof c);
+  munit_assert_memory_equal(sizeof tag, tag, expected_iterated_tag);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_ccm(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* Packet Vector #1 of RFC 3610 */
+  const unsigned char key[16] = {
+      0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb,
+      0xcc, 0xcd, 0xce, 0xcf};
+  const unsigned char nonce[13] = {
+      0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4,
+      0xa5};
+  const unsigned char expected_cipher_text[23] = {
+      0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2,
+      0xc0, 0xf9, 0x89, 0x80, 0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84};
+  const unsigned char expected_tag[8] = {
+      0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0};
+  unsigned char packet[31], cipher_text[23], dec_text[23], tag[8];
+  AesCcmContext ctx;
+
+  for (size_t i = 0; i < sizeof packet; ++i)
+    packet[i] = (unsigned char)i;
+
+  /* The first 8 bytes of the packet are authenticated only. */
+  aes_ccm_init(&ctx, KEY_TYPE_AES128, key);
+  aes_ccm_seal(&ctx, sizeof cipher_text, cipher_text, &packet[8], 8, packet,
+               sizeof nonce, nonce, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag);
+
+  munit_assert_int(aes_ccm_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, 8, packet, sizeof nonce, nonce,
+                                sizeof tag, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, &packet[8]);
+
+  tag[7] ^= 1;
+  munit_assert_int(aes_ccm_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, 8, packet, sizeof nonce, nonce,
+                                sizeof tag, tag),
+                   ==, -1);
+
+  /* Tags of more than 16 bytes or of an odd size, & nonces of more than 13
+   * bytes don't fit in B0. */
+  unsigned char long_tag[18], long_nonce[16] = {0};
+  munit_assert_int(aes_ccm_seal(&ctx, sizeof cipher_text, cipher_text,
+                                &packet[8], 8, packet, sizeof nonce, nonce,
+                                sizeof long_tag, long_tag),
+                   ==, -1);
+  munit_assert_int(aes_ccm_seal(&ctx, sizeof cipher_text, cipher_text,
+                                &packet[8], 8, packet, sizeof nonce, nonce, 7,
+                                long_tag),
+                   ==, -1);
+  munit_assert_int(aes_ccm_seal(&ctx, sizeof cipher_text, cipher_text,
+                                &packet[8], 8, packet, sizeof long_nonce,
+                                long_nonce, sizeof tag, tag),
+                   ==, -1);
+
+  /* With a 13-byte nonce, B0 holds the text size in 2 bytes. */
+  static unsigned char long_text[1 << 16];
+  munit_assert_int(aes_ccm_seal(&ctx, sizeof long_text, long_text, long_text,
+                                0, NULL, sizeof nonce, nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ccm_open(&ctx, sizeof long_text, long_text, long_text,
+                                0, NULL, sizeof nonce, nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_ccm_seal(&ctx, sizeof long_text - 1, long_text,
+                                long_text, 0, NULL, sizeof nonce, nonce,
+                                sizeof tag, tag),
+                   ==, 0);
+
+  /* Messages of different sizes sealed & opened together must match the
+   * single message API. */
+  unsigned char nonces[11][13], tags[11][8], multi_cipher_text[11][31],
+      single_cipher_text[31], single_tag[8], multi_dec_text[11][31];
+  AesCcmMessage messages[11];
+  int results[11];
+
+  for (size_t i = 0; i < 11; ++i) {
+    memcpy(nonces[i], nonce, sizeof nonce);
+    nonces[i][0] = (unsigned char)i;
+    messages[i] = (AesCcmMessage){.textsize = 3 * i,
+                                  .out = multi_cipher_text[i],
+                                  .in = packet,
+                                  .aadsize = 31 - 3 * i,
+                                  .aad = packet,
+                                  .nonce = nonces[i],
+                                  .tag = tags[i]};
+  }
+
+  aes_ccm_seal_multi(&ctx, 11, messages, sizeof nonce, sizeof tag);
+  for (size_t i = 0; i < 11; ++i) {
+    aes_ccm_seal(&ctx, 3 * i, single_cipher_text, packet, 31 - 3 * i, packet,
+                 sizeof nonce, nonces[i], sizeof tag, single_tag);
+    munit_assert_memory_equal(3 * i, multi_cipher_text[i], single_cipher_text);
+    munit_assert_memory_equal(sizeof tag, tags[i], single_tag);
+
+    messages[i].out = multi_dec_text[i];
+    messages[i].in = multi_cipher_text[i];
+  }
+
+  tags[5][0] ^= 1;
+  munit_assert_int(
+      aes_ccm_open_multi(&ctx, 11, messages, sizeof nonce, sizeof tag, results),
+      ==, -1);
+  for (size_t i = 0; i < 11; ++i) {
+    munit_assert_int(results[i], ==, i == 5 ? -1 : 0);
+    if (i != 5)
+      munit_assert_memory_equal(3 * i, multi_dec_text[i], packet);
+  }
+
+  munit_assert_int(aes_ccm_seal_multi(&ctx, 11, messages, sizeof nonce,
+                                      sizeof long_tag),
+                   ==, -1);
+
+  messages[3].textsize = sizeof long_text;
+  messages[3].out = long_text;
+  messages[3].in = long_text;
+  munit_assert_int(
+      aes_ccm_seal_multi(&ctx, 11, messages, sizeof nonce, sizeof tag), ==, -1);
+  munit_assert_int(
+      aes_ccm_open_multi(&ctx, 11, messages, sizeof nonce, sizeof tag, results),
+      ==, -1);
+  for (size_t i = 0; i < 11; ++i)
+    munit_assert_int(results[i], ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_cmac(const MunitParameter params[],
+                                 void *user_data_or_fixture) {
+  /* From RFC 4493, section 4 */
+  const unsigned char key[16] = {
+      0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+      0x09, 0xcf, 0x4f, 0x3c};
+  const unsigned char message[64] = {
+      0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+      0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+      0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+      0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+      0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+      0xe6, 0x6c, 0x37, 0x10};
+  const size_t sizes[4] = {0, 16, 40, 64};
+  const unsigned char expected_macs[4][16] = {
+      {0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12,
+       0x9b, 0x75, 0x67, 0x46},
+      {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d,
+       0xd0, 0x4a, 0x28, 0x7c},
+      {0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61,
+       0x14, 0x97, 0xc8, 0x27},
+      {0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17,
+       0x79, 0x36, 0x3c, 0xfe}};
+  unsigned char mac[16], multi_macs[4][16];
+  AesCmacMessage messages[4];
+  AesCmacContext ctx;
+
+  aes_cmac_init(&ctx, KEY_TYPE_AES128, key);
+  for (size_t i = 0; i < 4; ++i) {
+    aes_cmac(&ctx, sizes[i], message, mac);
+    munit_assert_memory_equal(sizeof mac, mac, expected_macs[i]);
+
+    messages[i] = (AesCmacMessage){
+        .size = sizes[i], .in = message, .mac = multi_macs[i]};
+  }
+
+  aes_cmac_multi(&ctx, 4, messages);
+  for (size_t i = 0; i < 4; ++i)
+    munit_assert_memory_equal(sizeof mac, multi_macs[i], expected_macs[i]);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_eax(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* From the test vectors of the EAX paper (Bellare, Rogaway & Wagner) */
+  const unsigned char key[16] = {
+      0x83, 0x95, 0xfc, 0xf1, 0xe9, 0x5b, 0xeb, 0xd6, 0x97, 0xbd, 0x01, 0x0b,
+      0xc7, 0x66, 0xaa, 0xc3};
+  const unsigned char nonce[16] = {
+      0x22, 0xe7, 0xad, 0xd9, 0x3c, 0xfc, 0x63, 0x93, 0xc5, 0x7e, 0xc0, 0xb3,
+      0xc1, 0x7d, 0x6b, 0x44};
+  const unsigned char header[8] = {
+      0x12, 0x67, 0x35, 0xfc, 0xc3, 0x20, 0xd2, 0x5a};
+  const unsigned char plain_text[21] = {
+      0xca, 0x40, 0xd7, 0x44, 0x6e, 0x54, 0x5f, 0xfa, 0xed, 0x3b, 0xd1, 0x2a,
+      0x74, 0x0a, 0x65, 0x9f, 0xfb, 0xbb, 0x3c, 0xea, 0xb7};
+  const unsigned char expected_cipher_text[21] = {
+      0xcb, 0x89, 0x20, 0xf8, 0x7a, 0x6c, 0x75, 0xcf, 0xf3, 0x96, 0x27, 0xb5,
+      0x6e, 0x3e, 0xd1, 0x97, 0xc5, 0x52, 0xd2, 0x95, 0xa7};
+  const unsigned char expected_tag[16] = {
+      0xcf, 0xc4, 0x6a, 0xfc, 0x25, 0x3b, 0x46, 0x52, 0xb1, 0xaf, 0x37, 0x95,
+      0xb1, 0x24, 0xab, 0x6e};
+  unsigned char cipher_text[21], dec_text[21], tag[16];
+  AesEaxContext ctx;
+
+  aes_eax_init(&ctx, KEY_TYPE_AES128, key);
+  aes_eax_seal(&ctx, sizeof cipher_text, cipher_text, plain_text,
+               sizeof header, header, sizeof nonce, nonce, sizeof tag, tag);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text);
+  munit_assert_memory_equal(sizeof tag, tag, expected_tag);
+
+  /* Decrypting in place */
+  memcpy(dec_text, cipher_text, sizeof dec_text);
+  munit_assert_int(aes_eax_open(&ctx, sizeof dec_text, dec_text, dec_text,
+                                sizeof header, header, sizeof nonce, nonce,
+                                sizeof tag, tag),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  /* A truncated tag is a prefix of the full one. */
+  tag[15] ^= 1;
+  munit_assert_int(aes_eax_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof header, header,
+                                sizeof nonce, nonce, sizeof tag, tag),
+                   ==, -1);
+  munit_assert_int(aes_eax_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, sizeof header, header,
+                                sizeof nonce, nonce, 8, tag),
+                   ==, 0);
+
+  unsigned char long_tag[17];
+  munit_assert_int(aes_eax_seal(&ctx, sizeof cipher_text, cipher_text,
+                                plain_text, sizeof header, header,
+                                sizeof nonce, nonce, sizeof long_tag, long_tag),
+                   ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_pmac(const MunitParameter params[],
+                                 void *user_data_or_fixture) {
+  /* From the test vectors of the PMAC1 reference code */
+  const unsigned char key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+                                 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+                                 0x0c, 0x0d, 0x0e, 0x0f};
+  const size_t sizes[3] = {0, 16, 34};
+  const unsigned char expected_macs[3][16] = {
+      {0x43, 0x99, 0x57, 0x2c, 0xd6, 0xea, 0x53, 0x41, 0xb8, 0xd3, 0x58, 0x76,
+       0xa7, 0x09, 0x8a, 0xf7},
+      {0xeb, 0xbd, 0x82, 0x2f, 0xa4, 0x58, 0xda, 0xf6, 0xdf, 0xda, 0xd7, 0xc2,
+       0x7d, 0xa7, 0x63, 0x38},
+      {0x5c, 0xba, 0x7d, 0x5e, 0xb2, 0x4f, 0x7c, 0x86, 0xcc, 0xc5, 0x46, 0x04,
+       0xe5, 0x3d, 0x55, 0x12}};
+  const unsigned char expected_zeros_mac[16] = {
+      0xc2, 0xc9, 0xfa, 0x1d, 0x99, 0x85, 0xf6, 0xf0, 0xd2, 0xaf, 0xf9, 0x15,
+      0xa0, 0xe8, 0xd9, 0x10};
+  unsigned char message[34], mac[16];
+  static const unsigned char zeros[1000];
+  AesPmacState states[3];
+  AesPmacContext ctx;
+
+  for (size_t i = 0; i < sizeof message; ++i)
+    message[i] = (unsigned char)i;
+
+  aes_pmac_init(&ctx, KEY_TYPE_AES128, key);
+  for (size_t i = 0; i < 3; ++i) {
+    aes_pmac(&ctx, sizes[i], message, mac);
+    munit_assert_memory_equal(sizeof mac, mac, expected_macs[i]);
+  }
+
+  aes_pmac(&ctx, sizeof zeros, zeros, mac);
+  munit_assert_memory_equal(sizeof mac, mac, expected_zeros_mac);
+
+  /* The same message in chunks of 17, 40 & the remaining blocks, processed
+   * out of order */
+  aes_pmac_start(&ctx, &states[2], 57);
+  aes_pmac_update(&ctx, &states[2], sizeof zeros - 57 * 16, zeros);
+  aes_pmac_start(&ctx, &states[1], 17);
+  aes_pmac_update(&ctx, &states[1], 40 * 16, zeros);
+  aes_pmac_start(&ctx, &states[0], 0);
+  aes_pmac_update(&ctx, &states[0], 7, zeros);
+  aes_pmac_update(&ctx, &states[0], 17 * 16 - 7, zeros);
+
+  munit_assert_int(aes_pmac_combine(&ctx, &states[0], &states[2]), ==, -1);
+  munit_assert_int(aes_pmac_combine(&ctx, &states[0], &states[1]), ==, 0);
+  munit_assert_int(aes_pmac_combine(&ctx, &states[0], &states[2]), ==, 0);
+  aes_pmac_final(&ctx, &states[0], mac);
+  munit_assert_memory_equal(sizeof mac, mac, expected_zeros_mac);
+
+  /* Messages end at byte 2^36 at most. */
+  munit_assert_int(aes_pmac_start(&ctx, &states[0], (uint64_t)1 << 32), ==,
+                   -1);
+  munit_assert_int(aes_pmac_start(&ctx, &states[0], 0xfffffffe), ==, 0);
+  munit_assert_int(aes_pmac_update(&ctx, &states[0], 48, zeros), ==, -1);
+  munit_assert_int(aes_pmac_update(&ctx, &states[0], 24, zeros), ==, 0);
+  munit_assert_int(aes_pmac_update(&ctx, &states[0], 9, zeros), ==, -1);
+  munit_assert_int(aes_pmac_update(&ctx, &states[0], 8, zeros), ==, 0);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_cfb(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* From NIST SP 800-38A, F.3.7 (CFB8-AES128) & F.3.13 (CFB128-AES128) */
+  const unsigned char key[16] = {
+      0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+      0x09, 0xcf, 0x4f, 0x3c};
+  const unsigned char iv[16] = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+      0x0c, 0x0d, 0x0e, 0x0f};
+  const unsigned char plain_text[64] = {
+      0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+      0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+      0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+      0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+      0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+      0xe6, 0x6c, 0x37, 0x10};
+  const unsigned char expected_cfb128_cipher_text[64] = {
+      0x3b, 0x3f, 0xd9, 0x2e, 0xb7, 0x2d, 0xad, 0x20, 0x33, 0x34, 0x49, 0xf8,
+      0xe8, 0x3c, 0xfb, 0x4a, 0xc8, 0xa6, 0x45, 0x37, 0xa0, 0xb3, 0xa9, 0x3f,
+      0xcd, 0xe3, 0xcd, 0xad, 0x9f, 0x1c, 0xe5, 0x8b, 0x26, 0x75, 0x1f, 0x67,
+      0xa3, 0xcb, 0xb1, 0x40, 0xb1, 0x80, 0x8c, 0xf1, 0x87, 0xa4, 0xf4, 0xdf,
+      0xc0, 0x4b, 0x05, 0x35, 0x7c, 0x5d, 0x1c, 0x0e, 0xea, 0xc4, 0xc6, 0x6f,
+      0x9f, 0xf7, 0xf2, 0xe6};
+  const unsigned char expected_cfb8_cipher_text[18] = {
+      0x3b, 0x79, 0x42, 0x4c, 0x9c, 0x0d, 0xd4, 0x36, 0xba, 0xce, 0x9e, 0x0e,
+      0xd4, 0x58, 0x6a, 0x4f, 0x32, 0xb9};
+  unsigned char cipher_text[64], dec_text[64];
+  AesCfbContext ctx;
+
+  aes_cfb_init(&ctx, KEY_TYPE_AES128, key, iv);
+  aes_cfb128_encrypt(&ctx, sizeof cipher_text, cipher_text, plain_text);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cfb128_cipher_text);
+
+  /* Streaming, in parts that don't line up with the blocks */
+  aes_cfb_set_iv(&ctx, iv);
+  aes_cfb128_decrypt(&ctx, 5, dec_text, cipher_text);
+  aes_cfb128_decrypt(&ctx, 40, &dec_text[5], &cipher_text[5]);
+  aes_cfb128_decrypt(&ctx, 19, &dec_text[45], &cipher_text[45]);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  aes_cfb_set_iv(&ctx, iv);
+  aes_cfb8_encrypt(&ctx, sizeof expected_cfb8_cipher_text, cipher_text,
+                   plain_text);
+  munit_assert_memory_equal(sizeof expected_cfb8_cipher_text, cipher_text,
+                            expected_cfb8_cipher_text);
+
+  aes_cfb_set_iv(&ctx, iv);
+  aes_cfb8_decrypt(&ctx, 11, dec_text, cipher_text);
+  aes_cfb8_decrypt(&ctx, sizeof expected_cfb8_cipher_text - 11, &dec_text[11],
+                   &cipher_text[11]);
+  munit_assert_memory_equal(sizeof expected_cfb8_cipher_text, dec_text,
+                            plain_text);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_ofb(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* From NIST SP 800-38A, F.4.1 */
+  const unsigned char key[16] = {
+      0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+      0x09, 0xcf, 0x4f, 0x3c};
+  const unsigned char iv[16] = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+      0x0c, 0x0d, 0x0e, 0x0f};
+  const unsigned char plain_text[64] = {
+      0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+      0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+      0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+      0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+      0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+      0xe6, 0x6c, 0x37, 0x10};
+  const unsigned char expected_cipher_text[64] = {
+      0x3b, 0x3f, 0xd9, 0x2e, 0xb7, 0x2d, 0xad, 0x20, 0x33, 0x34, 0x49, 0xf8,
+      0xe8, 0x3c, 0xfb, 0x4a, 0x77, 0x89, 0x50, 0x8d, 0x16, 0x91, 0x8f, 0x03,
+      0xf5, 0x3c, 0x52, 0xda, 0xc5, 0x4e, 0xd8, 0x25, 0x97, 0x40, 0x05, 0x1e,
+      0x9c, 0x5f, 0xec, 0xf6, 0x43, 0x44, 0xf7, 0xa8, 0x22, 0x60, 0xed, 0xcc,
+      0x30, 0x4c, 0x65, 0x28, 0xf6, 0x59, 0xc7, 0x78, 0x66, 0xa5, 0x10, 0xd9,
+      0xc1, 0xd6, 0xae, 0x5e};
+  unsigned char cipher_text[64], dec_text[64], ring[40];
+  AesOfbContext ctx;
+
+  aes_ofb_init(&ctx, KEY_TYPE_AES128, key, iv);
+  aes_ofb_xcrypt(&ctx, sizeof cipher_text, cipher_text, plain_text);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_cipher_text);
+
+  /* Precomputed key stream, consumed in parts that wrap around the ring */
+  aes_ofb_set_iv(&ctx, iv);
+  aes_ofb_set_ring(&ctx, ring, sizeof ring);
+  munit_assert_size(aes_ofb_precompute(&ctx), ==, sizeof ring);
+  aes_ofb_xcrypt(&ctx, 25, dec_text, cipher_text);
+  munit_assert_size(aes_ofb_precompute(&ctx), ==, sizeof ring);
+  aes_ofb_xcrypt(&ctx, 39, &dec_text[25], &cipher_text[25]);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, plain_text);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_kw(const MunitParameter params[],
+                               void *user_data_or_fixture) {
+  /* From RFC 3394, section 4.1 */
+  const unsigned char kek[16] = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+      0x0c, 0x0d, 0x0e, 0x0f};
+  const unsigned char key[16] = {
+      0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+      0xcc, 0xdd, 0xee, 0xff};
+  const unsigned char expected_wrapped_key[24] = {
+      0x1f, 0xa6, 0x8b, 0x0a, 0x81, 0x12, 0xb4, 0x47, 0xae, 0xf3, 0x4b, 0xd8,
+      0xfb, 0x5a, 0x7b, 0x82, 0x9d, 0x3e, 0x86, 0x23, 0x71, 0xd2, 0xcf, 0xe5};
+  /* From RFC 5649, section 6 */
+  const unsigned char kwp_kek[24] = {
+      0x58, 0x40, 0xdf, 0x6e, 0x29, 0xb0, 0x2a, 0xf1, 0xab, 0x49, 0x3b, 0x70,
+      0x5b, 0xf1, 0x6e, 0xa1, 0xae, 0x83, 0x38, 0xf4, 0xdc, 0xc1, 0x76, 0xa8};
+  const unsigned char kwp_key[20] = {
+      0xc3, 0x7b, 0x7e, 0x64, 0x92, 0x58, 0x43, 0x40, 0xbe, 0xd1, 0x22, 0x07,
+      0x80, 0x89, 0x41, 0x15, 0x50, 0x68, 0xf7, 0x38};
+  const unsigned char expected_kwp_wrapped_key[32] = {
+      0x13, 0x8b, 0xde, 0xaa, 0x9b, 0x8f, 0xa7, 0xfc, 0x61, 0xf9, 0x77, 0x42,
+      0xe7, 0x22, 0x48, 0xee, 0x5a, 0xe6, 0xae, 0x53, 0x60, 0xd1, 0xae, 0x6a,
+      0x5f, 0x54, 0xf3, 0x73, 0xfa, 0x54, 0x3b, 0x6a};
+  const unsigned char short_key[7] = {0x46, 0x6f, 0x72, 0x50, 0x61, 0x73, 0x69};
+  const unsigned char expected_short_wrapped_key[16] = {
+      0xaf, 0xbe, 0xb0, 0xf0, 0x7d, 0xfb, 0xf5, 0x41, 0x92, 0x00, 0xf2, 0xcc,
+      0xb5, 0x0b, 0xb2, 0x4f};
+  const unsigned char zeros[16] = {0};
+  unsigned char wrapped[3][32], unwrapped[3][24];
+  AesKwItem items[3];
+  int results[3];
+  size_t size;
+  AesKwContext ctx;
+
+  aes_kw_init(&ctx, KEY_TYPE_AES128, kek);
+  munit_assert_int(aes_kw_wrap(&ctx, sizeof key, wrapped[0], key), ==, 0);
+  munit_assert_memory_equal(sizeof expected_wrapped_key, wrapped[0],
+                            expected_wrapped_key);
+  munit_assert_int(aes_kw_unwrap(&ctx, sizeof expected_wrapped_key,
+                                 unwrapped[0], expected_wrapped_key),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof key, unwrapped[0], key);
+
+  /* A tampered key is rejected & its output cleared */
+  wrapped[0][20] ^= 1;
+  munit_assert_int(aes_kw_unwrap(&ctx, sizeof expected_wrapped_key,
+                                 unwrapped[0], wrapped[0]),
+                   ==, -1);
+  munit_assert_memory_equal(sizeof key, unwrapped[0], zeros);
+
+  aes_kw_init(&ctx, KEY_TYPE_AES192, kwp_kek);
+  munit_assert_int(aes_kwp_wrap(&ctx, sizeof kwp_key, wrapped[0], kwp_key), ==,
+                   0);
+  munit_assert_memory_equal(sizeof expected_kwp_wrapped_key, wrapped[0],
+                            expected_kwp_wrapped_key);
+  munit_assert_int(aes_kwp_unwrap(&ctx, sizeof expected_short_wrapped_key,
+                                  unwrapped[0], &size,
+                                  expected_short_wrapped_key),
+                   ==, 0);
+  munit_assert_size(size, ==, sizeof short_key);
+  munit_assert_memory_equal(sizeof short_key, unwrapped[0], short_key);
+
+  /* Batch of both sizes, with a wrapped key in its own buffer */
+  memcpy(wrapped[2], expected_wrapped_key, sizeof expected_wrapped_key);
+  items[0] = (AesKwItem){.insize = sizeof expected_kwp_wrapped_key,
+                         .in = expected_kwp_wrapped_key,
+                         .out = unwrapped[0]};
+  items[1] = (AesKwItem){.insize = sizeof expected_short_wrapped_key,
+                         .in = expected_short_wrapped_key,
+                         .out = unwrapped[1]};
+  items[2] = (AesKwItem){.insize = sizeof expected_wrapped_key,
+                         .in = wrapped[2],
+                         .out = unwrapped[2]};
+  munit_assert_int(aes_kwp_unwrap_multi(&ctx, 3, items, results), ==, -1);
+  munit_assert_int(results[0], ==, 0);
+  munit_assert_size(items[0].outsize, ==, sizeof kwp_key);
+  munit_assert_memory_equal(sizeof kwp_key, unwrapped[0], kwp_key);
+  munit_assert_int(results[1], ==, 0);
+  munit_assert_memory_equal(sizeof short_key, unwrapped[1], short_key);
+  /* Wrapped under another key */
+  munit_assert_int(results[2], ==, -1);
+  munit_assert_size(items[2].outsize, ==, 0);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_siv(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* From RFC 5297, appendix A.1 (deterministic) */
+  const unsigned char key[32] = {
+      0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4,
+      0xf3, 0xf2, 0xf1, 0xf0, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+      0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+  const unsigned char ad[24] = {
+      0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b,
+      0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27};
+  const unsigned char plain_text[14] = {
+      0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc,
+      0xdd, 0xee};
+  const unsigned char expected_siv[16] = {
+      0x85, 0x63, 0x2d, 0x07, 0xc6, 0xe8, 0xf3, 0x7f, 0x95, 0x0a, 0xcd, 0x32,
+      0x0a, 0x2e, 0xcc, 0x93};
+  const unsigned char expected_cipher_text[14] = {
+      0x40, 0xc0, 0x2b, 0x96, 0x90, 0xc4, 0xdc, 0x04, 0xda, 0xef, 0x7f, 0x6a,
+      0xfe, 0x5c};
+  /* From RFC 5297, appendix A.2 (nonce-based) */
+  const unsigned char nonce_key[32] = {
+      0x7f, 0x7e, 0x7d, 0x7c, 0x7b, 0x7a, 0x79, 0x78, 0x77, 0x76, 0x75, 0x74,
+      0x73, 0x72, 0x71, 0x70, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+      0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f};
+  const unsigned char ad1[40] = {
+      0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+      0xcc, 0xdd, 0xee, 0xff, 0xde, 0xad, 0xda, 0xda, 0xde, 0xad, 0xda, 0xda,
+      0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44,
+      0x33, 0x22, 0x11, 0x00};
+  const unsigned char ad2[10] = {
+      0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0x90, 0xa0};
+  const unsigned char nonce[16] = {
+      0x09, 0xf9, 0x11, 0x02, 0x9d, 0x74, 0xe3, 0x5b, 0xd8, 0x41, 0x56, 0xc5,
+      0x63, 0x56, 0x88, 0xc0};
+  const unsigned char nonce_plain_text[47] = {
+      0x74, 0x68, 0x69, 0x73, 0x20, 0x69, 0x73, 0x20, 0x73, 0x6f, 0x6d, 0x65,
+      0x20, 0x70, 0x6c, 0x61, 0x69, 0x6e, 0x74, 0x65, 0x78, 0x74, 0x20, 0x74,
+      0x6f, 0x20, 0x65, 0x6e, 0x63, 0x72, 0x79, 0x70, 0x74, 0x20, 0x75, 0x73,
+      0x69, 0x6e, 0x67, 0x20, 0x53, 0x49, 0x56, 0x2d, 0x41, 0x45, 0x53};
+  const unsigned char expected_nonce_siv[16] = {
+      0x7b, 0xdb, 0x6e, 0x3b, 0x43, 0x26, 0x67, 0xeb, 0x06, 0xf4, 0xd1, 0x4b,
+      0xff, 0x2f, 0xbd, 0x0f};
+  const unsigned char expected_nonce_cipher_text[47] = {
+      0xcb, 0x90, 0x0f, 0x2f, 0xdd, 0xbe, 0x40, 0x43, 0x26, 0x60, 0x19, 0x65,
+      0xc8, 0x89, 0xbf, 0x17, 0xdb, 0xa7, 0x7c, 0xeb, 0x09, 0x4f, 0xa6, 0x63,
+      0xb7, 0xa3, 0xf7, 0x48, 0xba, 0x8a, 0xf8, 0x29, 0xea, 0x64, 0xad, 0x54,
+      0x4a, 0x27, 0x2e, 0x9c, 0x48, 0x5b, 0x62, 0xa3, 0xfd, 0x5c, 0x0d};
+  const AesSivData ads[1] = {{sizeof ad, ad}};
+  const AesSivData nonce_ads[3] = {
+      {sizeof ad1, ad1}, {sizeof ad2, ad2}, {sizeof nonce, nonce}};
+  unsigned char cipher_text[47], dec_text[47], siv[16];
+  AesSivContext ctx;
+
+  aes_siv_init(&ctx, KEY_TYPE_AES128, key);
+  munit_assert_int(aes_siv_seal(&ctx, sizeof plain_text, cipher_text,
+                                plain_text, 1, ads, siv),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof siv, siv, expected_siv);
+  munit_assert_memory_equal(sizeof expected_cipher_text, cipher_text,
+                            expected_cipher_text);
+  munit_assert_int(aes_siv_open(&ctx, sizeof plain_text, dec_text,
+                                cipher_text, 1, ads, siv),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof plain_text, dec_text, plain_text);
+
+  aes_siv_init(&ctx, KEY_TYPE_AES128, nonce_key);
+  munit_assert_int(aes_siv_seal(&ctx, sizeof nonce_plain_text, cipher_text,
+                                nonce_plain_text, 3, nonce_ads, siv),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof siv, siv, expected_nonce_siv);
+  munit_assert_memory_equal(sizeof cipher_text, cipher_text,
+                            expected_nonce_cipher_text);
+  munit_assert_int(aes_siv_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, 3, nonce_ads, siv),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof dec_text, dec_text, nonce_plain_text);
+
+  /* Dropping the nonce changes S2V */
+  munit_assert_int(aes_siv_open(&ctx, sizeof cipher_text, dec_text,
+                                cipher_text, 2, nonce_ads, siv),
+                   ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_ctr_drbg(const MunitParameter params[],
+                                     void *user_data_or_fixture) {
+  /* NIST CAVP, CTR_DRBG no_reseed, [AES-256 no df], COUNT = 0: the second
+   * 512 bits generated after instantiating with no personalization string */
+  const unsigned char cavp_entropy[48] = {
+      0xdf, 0x5d, 0x73, 0xfa, 0xa4, 0x68, 0x64, 0x9e, 0xdd, 0xa3, 0x3b, 0x5c,
+      0xca, 0x79, 0xb0, 0xb0, 0x56, 0x00, 0x41, 0x9c, 0xcb, 0x7a, 0x87, 0x9d,
+      0xdf, 0xec, 0x9d, 0xb3, 0x2e, 0xe4, 0x94, 0xe5, 0x53, 0x1b, 0x51, 0xde,
+      0x16, 0xa3, 0x0f, 0x76, 0x92, 0x62, 0x47, 0x4c, 0x73, 0xbe, 0xc0, 0x10};
+  const unsigned char cavp_output[64] = {
+      0xd1, 0xc0, 0x7c, 0xd9, 0x5a, 0xf8, 0xa7, 0xf1, 0x10, 0x12, 0xc8, 0x4c,
+      0xe4, 0x8b, 0xb8, 0xcb, 0x87, 0x18, 0x9e, 0x99, 0xd4, 0x0f, 0xcc, 0xb1,
+      0x77, 0x1c, 0x61, 0x9b, 0xdf, 0x82, 0xab, 0x22, 0x80, 0xb1, 0xdc, 0x2f,
+      0x25, 0x81, 0xf3, 0x91, 0x64, 0xf7, 0xac, 0x0c, 0x51, 0x04, 0x94, 0xb3,
+      0xa4, 0x3c, 0x41, 0xb7, 0xdb, 0x17, 0x51, 0x4c, 0x87, 0xb1, 0x07, 0xae,
+      0x79, 0x3e, 0x01, 0xc5};
+  /* Personalization, reseeding & additional input: computed with an
+   * independent implementation of SP 800-90A, 10.2.1 */
+  const unsigned char pers[10] = "aes-c test";
+  const unsigned char expected_output[64] = {
+      0xc8, 0x88, 0x0c, 0xd2, 0xa7, 0x9c, 0x22, 0x95, 0x68, 0x88, 0x13, 0x07,
+      0x4f, 0xee, 0x21, 0xb2, 0x37, 0x50, 0x37, 0xa8, 0xe5, 0xc9, 0x27, 0xf4,
+      0xd2, 0xad, 0xa8, 0x60, 0x16, 0xc0, 0x15, 0xbd, 0x5f, 0x86, 0x35, 0xb2,
+      0xd5, 0x30, 0x05, 0x78, 0x4b, 0xa4, 0x21, 0xa2, 0x1d, 0x86, 0x3d, 0x7e,
+      0xf1, 0x4b, 0x59, 0xf7, 0x8f, 0xe6, 0x00, 0x3d, 0x1a, 0xef, 0xd5, 0x4f,
+      0xb6, 0x37, 0x7c, 0x37};
+  const unsigned char expected_reseeded_output[40] = {
+      0x16, 0xae, 0xd1, 0xad, 0x25, 0x90, 0xb4, 0x6c, 0xe0, 0x60, 0xe4, 0x1e,
+      0xdf, 0x33, 0x71, 0x66, 0x8b, 0x13, 0x06, 0x1c, 0x74, 0x5d, 0xdf, 0xf0,
+      0xc2, 0x38, 0xe0, 0x1d, 0x73, 0x7f, 0x31, 0xb4, 0xaa, 0x26, 0x08, 0x36,
+      0x18, 0x6c, 0x49, 0x18};
+  unsigned char entropy[48], reseed_entropy[48], additional[16], output[64],
+      child_output[2][16];
+  AesCtrDrbgContext ctx, children[2];
+
+  for (size_t i = 0; i < sizeof entropy; ++i) {
+    entropy[i] = (unsigned char)i;
+    reseed_entropy[i] = (unsigned char)(0x80 + i);
+  }
+  for (size_t i = 0; i < sizeof additional; ++i)
+    additional[i] = (unsigned char)(0xc0 + i);
+
+  munit_assert_int(aes_ctr_drbg_init(&ctx, cavp_entropy, 0, NULL), ==, 0);
+  for (size_t i = 0; i < 2; ++i)
+    munit_assert_int(aes_ctr_drbg_generate(&ctx, sizeof output, output, 0,
+                                           NULL),
+                     ==, 0);
+  munit_assert_memory_equal(sizeof cavp_output, output, cavp_output);
+
+  munit_assert_int(aes_ctr_drbg_init(&ctx, entropy, sizeof pers, pers), ==, 0);
+  munit_assert_int(aes_ctr_drbg_generate(&ctx, sizeof output, output, 0, NULL),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof expected_output, output, expected_output);
+
+  munit_assert_int(aes_ctr_drbg_reseed(&ctx, reseed_entropy, 0, NULL), ==, 0);
+  munit_assert_int(aes_ctr_drbg_generate(&ctx, sizeof expected_reseeded_output,
+                                         output, sizeof additional,
+                                         additional),
+                   ==, 0);
+  munit_assert_memory_equal(sizeof expected_reseeded_output, output,
+                            expected_reseeded_output);
+
+  /* Instances spawned for different threads diverge */
+  munit_assert_int(aes_ctr_drbg_spawn(&ctx, &children[0], 1,
+                                      (const unsigned char *)"0"),
+                   ==, 0);
+  munit_assert_int(aes_ctr_drbg_spawn(&ctx, &children[1], 1,
+                                      (const unsigned char *)"1"),
+                   ==, 0);
+  for (size_t i = 0; i < 2; ++i)
+    aes_ctr_drbg_generate(&children[i], 16, child_output[i], 0, NULL);
+  munit_assert_memory_not_equal(16, child_output[0], child_output[1]);
+
+  munit_assert_int(aes_ctr_drbg_generate(&ctx, sizeof output, output, 49,
+                                         entropy),
+                   ==, -1);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_fixed_key(const MunitParameter params[],
+                                      void *user_data_or_fixture) {
+  /* Computed with an independent implementation of the hashes */
+  const unsigned char expected_cr[64] = {
+      0x0a, 0x95, 0x09, 0xb6, 0x45, 0x6b, 0xf6, 0x42, 0xf9, 0xca, 0x9e, 0x53,
+      0xca, 0x5e, 0xe4, 0x55, 0x17, 0xef, 0xfd, 0x67, 0xf5, 0xc0, 0x15, 0x79,
+      0x88, 0x17, 0xf4, 0x0a, 0x92, 0x89, 0x8c, 0x8c, 0x7b, 0xc9, 0x5c, 0x0d,
+      0x7f, 0x61, 0x5a, 0xb3, 0x63, 0x08, 0xe3, 0x84, 0x5b, 0x7b, 0xee, 0xf7,
+      0x33, 0xc3, 0xf1, 0x8e, 0xfe, 0xb7, 0x5d, 0xc7, 0xba, 0xee, 0xf5, 0x8b,
+      0x09, 0xf0, 0x86, 0xfe};
+  const unsigned char expected_ccr[64] = {
+      0x40, 0xe6, 0x55, 0x05, 0x4f, 0xd4, 0x0a, 0x7c, 0x7e, 0x68, 0x5b, 0x76,
+      0x5f, 0x13, 0x73, 0x91, 0xd7, 0xc9, 0xa9, 0x79, 0x6d, 0xa4, 0x1e, 0x29,
+      0x21, 0xe7, 0xb3, 0x92, 0xa0, 0x44, 0xf3, 0x34, 0xe5, 0xb4, 0x8e, 0x61,
+      0x85, 0xea, 0x71, 0xb1, 0x9d, 0x39, 0xf8, 0xa7, 0xb0, 0x03, 0x6a, 0x6c,
+      0x04, 0x55, 0x61, 0xa8, 0xda, 0x7d, 0x68, 0x42, 0xcb, 0x7a, 0xc0, 0x28,
+      0x2e, 0x47, 0xff, 0x70};
+  const unsigned char expected_tccr[64] = {
+      0x7b, 0x6d, 0xbd, 0x0d, 0x1b, 0x7a, 0x52, 0x30, 0xf9, 0x9d, 0x50, 0x52,
+      0x18, 0x37, 0x5b, 0x20, 0xc2, 0x9a, 0xf0, 0x74, 0xbd, 0x6e, 0xb3, 0xcf,
+      0xd0, 0xd2, 0x23, 0x5c, 0x60, 0xc0, 0xa9, 0x3e, 0x0f, 0x8f, 0x8b, 0xe8,
+      0x4d, 0x3a, 0x0c, 0x94, 0x2a, 0x44, 0xf3, 0x6c, 0x71, 0xb5, 0x54, 0xc3,
+      0xa3, 0xef, 0x68, 0x37, 0x09, 0x8c, 0xd6, 0xcc, 0x14, 0x2c, 0xd6, 0x39,
+      0x3c, 0x81, 0x18, 0xb9};
+  unsigned char key[16], in[64], out[64];
+  AesFixedKeyContext ctx;
+
+  for (size_t i = 0; i < sizeof key; ++i)
+    key[i] = (unsigned char)i;
+  for (size_t i = 0; i < sizeof in; ++i)
+    in[i] = (unsigned char)i;
+
+  aes_fixed_key_init(&ctx, KEY_TYPE_AES128, key);
+
+  aes_fixed_key_cr(&ctx, sizeof in, out, in);
+  munit_assert_memory_equal(sizeof expected_cr, out, expected_cr);
+  aes_fixed_key_ccr(&ctx, sizeof in, out, in);
+  munit_assert_memory_equal(sizeof expected_ccr, out, expected_ccr);
+
+  /* The tweak of the last two blocks wraps around */
+  aes_fixed_key_tccr(&ctx, sizeof in, out, in, UINT64_MAX - 1);
+  munit_assert_memory_equal(sizeof expected_tccr, out, expected_tccr);
+
+  memcpy(out, in, sizeof in);
+  aes_fixed_key_ccr(&ctx, sizeof out, out, out);
+  munit_assert_memory_equal(sizeof expected_ccr, out, expected_ccr);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_haraka(const MunitParameter params[],
+                                   void *user_data_or_fixture) {
+  /* Computed with an independent implementation of keyed Haraka */
+  const unsigned char expected_256[32] = {
+      0xaf, 0x55, 0xf6, 0xa0, 0x28, 0xdd, 0x9c, 0x21, 0xa7, 0xc3, 0x11, 0x13,
+      0xca, 0x69, 0x66, 0xd8, 0x8e, 0xfa, 0x0d, 0x68, 0xed, 0xb7, 0x19, 0x28,
+      0x74, 0xcc, 0x3a, 0x39, 0x04, 0x08, 0x33, 0xc9};
+  const unsigned char expected_512[32] = {
+      0x11, 0x79, 0x78, 0xca, 0x0d, 0xb0, 0x6f, 0x38, 0x2f, 0xc4, 0x3c, 0xcd,
+      0x17, 0xd6, 0xa8, 0xb4, 0x50, 0xf4, 0x41, 0xf1, 0x13, 0x3c, 0xbd, 0xa2,
+      0x7e, 0x1b, 0x83, 0xa0, 0x42, 0xd0, 0xe0, 0xbe};
+  const unsigned char expected_empty[32] = {
+      0xef, 0x07, 0x58, 0x2c, 0xba, 0xd1, 0xf2, 0xf9, 0x07, 0xe5, 0xe7, 0x2f,
+      0x66, 0xbb, 0x47, 0x0d, 0x5d, 0x79, 0x03, 0x8e, 0x24, 0xa2, 0xcc, 0x23,
+      0x15, 0xa3, 0xde, 0xa0, 0xd5, 0xfb, 0x79, 0x6f};
+  const unsigned char expected_100[32] = {
+      0xb1, 0xc1, 0x93, 0xf6, 0x13, 0xa0, 0xb9, 0x1e, 0x64, 0xd7, 0x04, 0x35,
+      0x74, 0x5d, 0x54, 0xe2, 0xed, 0xbd, 0x88, 0xb8, 0xda, 0xa7, 0xe6, 0x49,
+      0xb0, 0x1e, 0xc9, 0xf4, 0x29, 0xcd, 0xa8, 0x2c};
+  static const unsigned char zeros[32];
+  unsigned char key[16], in[100], out[3][64];
+  AesHarakaContext ctx;
+
+  for (size_t i = 0; i < sizeof key; ++i)
+    key[i] = (unsigned char)i;
+  for (size_t i = 0; i < sizeof in; ++i)
+    in[i] = (unsigned char)i;
+
+  aes_haraka_init(&ctx, key);
+
+  aes_haraka256(&ctx, 1, out[0], in);
+  munit_assert_memory_equal(sizeof expected_256, out[0], expected_256);
+  aes_haraka512(&ctx, 1, out[0], in);
+  munit_assert_memory_equal(sizeof expected_512, out[0], expected_512);
+
+  /* Inputs of a batch are independent. */
+  memcpy(out[0], in, 64);
+  memcpy(out[1], in, 64);
+  aes_haraka512(&ctx, 2, out[0], out[0]);
+  munit_assert_memory_equal(sizeof expected_512, out[0], expected_512);
+  munit_assert_memory_equal(sizeof expected_512, &out[0][32], expected_512);
+
+  aes_haraka_hash(&ctx, 0, NULL, out[0]);
+  munit_assert_memory_equal(sizeof expected_empty, out[0], expected_empty);
+  aes_haraka_hash(&ctx, sizeof in, in, out[0]);
+  munit_assert_memory_equal(sizeof expected_100, out[0], expected_100);
+
+  /* Messages of different sizes in one batch */
+  AesHarakaMessage messages[3] = {
+      {.size = sizeof in, .data = in, .digest = out[0]},
+      {.size = 0, .data = NULL, .digest = out[1]},
+      {.size = sizeof in, .data = in, .digest = out[2]}};
+  aes_haraka_hash_multi(&ctx, 3, messages);
+  munit_assert_memory_equal(sizeof expected_100, out[0], expected_100);
+  munit_assert_memory_equal(sizeof expected_empty, out[1], expected_empty);
+  munit_assert_memory_equal(sizeof expected_100, out[2], expected_100);
+
+  /* Parts of every size give the digest of the whole message. */
+  AesHarakaStreamContext stream;
+  aes_haraka_stream_init(&stream, key);
+  aes_haraka_stream_final(&stream, out[0]);
+  munit_assert_memory_equal(sizeof expected_empty, out[0], expected_empty);
+
+  for (size_t part = 1; part <= 70; ++part) {
+    aes_haraka_stream_start(&stream);
+    for (size_t i = 0; i < sizeof in; i += part)
+      aes_haraka_stream_update(&stream,
+                               sizeof in - i < part ? sizeof in - i : part,
+                               &in[i]);
+    aes_haraka_stream_final(&stream, out[0]);
+    munit_assert_memory_equal(sizeof expected_100, out[0], expected_100);
+  }
+
+  /* The size in the last block tells trailing zero bytes from padding. */
+  aes_haraka_hash(&ctx, 31, zeros, out[0]);
+  aes_haraka_hash(&ctx, 32, zeros, out[1]);
+  munit_assert_memory_not_equal(32, out[0], out[1]);
+  aes_haraka_hash(&ctx, 1, zeros, out[0]);
+  munit_assert_memory_not_equal(32, out[0], expected_empty);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_aes_fpe(const MunitParameter params[],
+                                void *user_data_or_fixture) {
+  /* FF1 samples 1 to 3 of NIST, & an FF3-1 vector of the NIST ACVP */
+  const unsigned char ff1_key[16] = {
+      0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+      0x09, 0xcf, 0x4f, 0x3c};
+  const unsigned char ff1_tweak[10] = {0x39, 0x38, 0x37, 0x36, 0x35,
+                                       0x34, 0x33, 0x32, 0x31, 0x30};
+  const unsigned char ff1_tweak36[11] = {0x37, 0x37, 0x37, 0x37, 0x70, 0x71,
+                                         0x72, 0x73, 0x37, 0x37, 0x37};
+  const uint16_t digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  const uint16_t expected_ff1[2][10] = {{2, 4, 3, 3, 4, 7, 7, 4, 8, 4},
+                                        {6, 1, 2, 4, 2, 0, 0, 7, 7, 3}};
+  const uint16_t numerals36[19] = {0,  1,  2,  3,  4,  5,  6,  7,  8, 9,
+                                   10, 11, 12, 13, 14, 15, 16, 17, 18};
+  /* a9tv40mll9kdu509eum */
+  const uint16_t expected_ff1_36[19] = {10, 9,  29, 31, 4,  0, 22, 21, 21, 9,
+                                        20, 13, 30, 5,  0,  9, 14, 30, 22};
+  const unsigned char ff3_key[16] = {
+      0x2d, 0xe7, 0x9d, 0x23, 0x2d, 0xf5, 0x58, 0x5d, 0x68, 0xce, 0x47, 0x88,
+      0x2a, 0xe2, 0x56, 0xd6};
+  const unsigned char ff3_tweak[7] = {0xcb, 0xd0, 0x92, 0x80,
+                                      0x97, 0x95, 0x64};
+  const uint16_t ff3_plain[10] = {3, 9, 9, 2, 5, 2, 0, 2, 4, 0};
+  const uint16_t expected_ff3[10] = {8, 9, 0, 1, 8, 0, 1, 1, 0, 6};
+  static const uint16_t zeros[57];
+  uint16_t out[2][57];
+  AesFf1Context ff1;
+  AesFf3Context ff3;
+
+  munit_assert_int(aes_ff1_init(&ff1, KEY_TYPE_AES128, ff1_key, 1), ==, -1);
+  munit_assert_int(aes_ff1_init(&ff1, KEY_TYPE_AES128, ff1_key, 10), ==, 0);
+  munit_assert_int(aes_ff1_encrypt(&ff1, 10, out[0], digits, 0, NULL), ==, 0);
+  munit_assert_memory_equal(sizeof expected_ff1[0], out[0], expected_ff1[0]);
+
+  /* Decrypting in place */
+  munit_assert_int(aes_ff1_decrypt(&ff1, 10, out[0], out[0], 0, NULL), ==, 0);
+  munit_assert_memory_equal(sizeof digits, out[0], digits);
+
+  /* Every token of a batch matches its single-token result. */
+  AesFpeToken tokens[2] = {{.out = out[0], .in = digits, .tweak = ff1_tweak},
+                           {.out = out[1], .in = digits, .tweak = ff1_tweak}};
+  munit_assert_int(
+      aes_ff1_encrypt_multi(&ff1, 2, tokens, 10, sizeof ff1_tweak), ==, 0);
+  munit_assert_memory_equal(sizeof expected_ff1[1], out[0], expected_ff1[1]);
+  munit_assert_memory_equal(sizeof expected_ff1[1], out[1], expected_ff1[1]);
+
+  /* 10^5 < 1000000 */
+  munit_assert_int(aes_ff1_encrypt(&ff1, 5, out[0], digits, 0, NULL), ==, -1);
+  /* A numeral is not less than the radix. */
+  munit_assert_int(aes_ff1_encrypt(&ff1, 19, out[0], numerals36, 0, NULL), ==,
+                   -1);
+
+  aes_ff1_init(&ff1, KEY_TYPE_AES128, ff1_key, 36);
+  aes_ff1_encrypt(&ff1, 19, out[0], numerals36, sizeof ff1_tweak36,
+                  ff1_tweak36);
+  munit_assert_memory_equal(sizeof expected_ff1_36, out[0], expected_ff1_36);
+  aes_ff1_decrypt(&ff1, 19, out[0], out[0], sizeof ff1_tweak36, ff1_tweak36);
+  munit_assert_memory_equal(sizeof numerals36, out[0], numerals36);
+
+  munit_assert_int(aes_ff3_init(&ff3, KEY_TYPE_AES128, ff3_key, 10), ==, 0);
+  munit_assert_int(aes_ff3_encrypt(&ff3, 10, out[0], ff3_plain, ff3_tweak), ==,
+                   0);
+  munit_assert_memory_equal(sizeof expected_ff3, out[0], expected_ff3);
+  aes_ff3_decrypt(&ff3, 10, out[0], out[0], ff3_tweak);
+  munit_assert_memory_equal(sizeof ff3_plain, out[0], ff3_plain);
+
+  /* At most 2 * floor(log_10(2^96)) = 56 numerals */
+  munit_assert_int(aes_ff3_encrypt(&ff3, 56, out[0], zeros, ff3_tweak), ==, 0);
+  munit_assert_int(aes_ff3_encrypt(&ff3, 57, out[0], zeros, ff3_tweak), ==,
+                   -1);
+
+  return MUNIT_OK;
+}
+
 static MunitTest tests[] = {
     {
         "/aes-128-ecb",         /* name */
@@ -439,6 +2145,31 @@ static MunitTest tests[] = {
     {"/aes-128-ctr", test_aes128_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     {"/aes-192-ctr", test_aes192_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     {"/aes-256-ctr", test_aes256_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-ctr-width", test_aes_ctr_width, NULL, NULL, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/aes-stream", test_aes_stream, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-gcm", test_aes_gcm, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-gcm-siv", test_aes_gcm_siv, NULL, NULL, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/aes-aegis", test_aes_aegis, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-ghash", test_aes_ghash, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-xts", test_aes_xts, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-hctr2", test_aes_hctr2, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-ocb", test_aes_ocb, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-ccm", test_aes_ccm, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-cmac", test_aes_cmac, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-eax", test_aes_eax, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-pmac", test_aes_pmac, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-cfb", test_aes_cfb, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-ofb", test_aes_ofb, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-kw", test_aes_kw, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-siv", test_aes_siv, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-ctr-drbg", test_aes_ctr_drbg, NULL, NULL, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/aes-fixed-key", test_aes_fixed_key, NULL, NULL, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/aes-haraka", test_aes_haraka, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/aes-fpe", test_aes_fpe, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     /* Mark the end of the array with an entry where the test
      * function is NULL */
     {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};
@@ -5,6 +5,8 @@
 #include <wmmintrin.h>
 
 #include "aes-ni.h"
+#include "aes-vaes.h"
+#include <ay/cpu-capability.h>
 #include <hexdump.h>
 
 #define m128i_eq(a, b) (_mm_movemask_epi8(_mm_cmpeq_epi8((a), (b))) == 0xffff)
@@ -456,6 +458,200 @@ static MunitResult test_aes256_ctr(const MunitParameter params[],
   return MUNIT_OK;
 }
 
+struct gcm_wide_kernels {
+  void (*ghash)(const AesGcmContext *ctx, unsigned char xi[16],
+                size_t textsize, const unsigned char *in);
+  void (*ctr32_encrypt)(const AesGcmContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char counter[16], unsigned char xi[16]);
+  void (*ctr32_decrypt)(const AesGcmContext *ctx, size_t textsize,
+                        unsigned char *out, const unsigned char *in,
+                        unsigned char counter[16], unsigned char xi[16]);
+};
+
+/* The wide kernels must produce the same output, GHASH & counter as the
+ * 128-bit kernels, including across the wrap of the 32-bit counter. */
+static void check_gcm_wide(const struct gcm_wide_kernels *wide) {
+  static const size_t sizes[] = {0, 255, 256, 789, 4096, 16389};
+  static unsigned char plain_text[16389], expected[16389], actual[16389];
+  const unsigned char key[32] = {
+      0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae,
+      0xf0, 0x85, 0x7d, 0x77, 0x81, 0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61,
+      0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4};
+  const unsigned char counter[16] = {0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce,
+                                     0xdb, 0xad, 0xff, 0xff, 0xff, 0xf0,
+                                     0xff, 0xff, 0xff, 0xf8};
+
+  for (size_t i = 0; i < sizeof plain_text; ++i)
+    plain_text[i] = (unsigned char)(i * 7);
+
+  for (enum AesKeyType key_type = 128; key_type <= 256; key_type += 64) {
+    AesGcmContext ctx;
+    aesni_init(&ctx.aes, key_type, key);
+    aesni_gcm_init(&ctx);
+
+    for (size_t i = 0; i < sizeof sizes / sizeof sizes[0]; ++i) {
+      unsigned char ctr_expected[16], ctr_actual[16];
+      unsigned char xi_expected[16] = {1, 2, 3}, xi_actual[16] = {1, 2, 3};
+
+      memcpy(ctr_expected, counter, 16);
+      memcpy(ctr_actual, counter, 16);
+      aesni_gcm_ctr32_encrypt(&ctx, sizes[i], expected, plain_text,
+                              ctr_expected, xi_expected);
+      wide->ctr32_encrypt(&ctx, sizes[i], actual, plain_text, ctr_actual,
+                          xi_actual);
+      munit_assert_memory_equal(sizes[i], actual, expected);
+      munit_assert_memory_equal(16, ctr_actual, ctr_expected);
+      munit_assert_memory_equal(16, xi_actual, xi_expected);
+
+      memcpy(ctr_actual, counter, 16);
+      memset(xi_actual, 0, 16);
+      memset(xi_expected, 0, 16);
+      aesni_gcm_ghash(&ctx, xi_expected, sizes[i] & ~(size_t)15, expected);
+      wide->ctr32_decrypt(&ctx, sizes[i] & ~(size_t)15, actual, expected,
+                          ctr_actual, xi_actual);
+      munit_assert_memory_equal(sizes[i] & ~(size_t)15, actual, plain_text);
+      munit_assert_memory_equal(16, xi_actual, xi_expected);
+
+      memset(xi_actual, 0, 16);
+      wide->ghash(&ctx, xi_actual, sizes[i] & ~(size_t)15, expected);
+      munit_assert_memory_equal(16, xi_actual, xi_expected);
+    }
+  }
+}
+
+static MunitResult test_gcm_vaes(const MunitParameter params[],
+                                 void *user_data_or_fixture) {
+  struct cpu_capability_x86 cpufeat;
+  cpu_capability_x86_init(&cpufeat);
+
+  bool vaes = cpufeat.aes && cpufeat.pclmulqdq && cpufeat.vaes &&
+              cpufeat.vpclmulqdq;
+  bool tested = false;
+
+  if (vaes && cpufeat.avx2 && cpufeat.os_ymm) {
+    const struct gcm_wide_kernels vaes256 = {aesvaes256_gcm_ghash,
+                                             aesvaes256_gcm_ctr32_encrypt,
+                                             aesvaes256_gcm_ctr32_decrypt};
+    check_gcm_wide(&vaes256);
+    tested = true;
+  }
+
+  if (vaes && cpufeat.avx512f && cpufeat.avx512bw && cpufeat.avx512vl &&
+      cpufeat.os_zmm) {
+    const struct gcm_wide_kernels vaes512 = {aesvaes512_gcm_ghash,
+                                             aesvaes512_gcm_ctr32_encrypt,
+                                             aesvaes512_gcm_ctr32_decrypt};
+    check_gcm_wide(&vaes512);
+    tested = true;
+  }
+
+  return tested ? MUNIT_OK : MUNIT_SKIP;
+}
+
+struct fixed_key_kernels {
+  void (*cr)(const AesContext *ctx, size_t textsize, unsigned char *out,
+             const unsigned char *in);
+  void (*ccr)(const AesContext *ctx, size_t textsize, unsigned char *out,
+              const unsigned char *in);
+  void (*tccr)(const AesContext *ctx, size_t textsize, unsigned char *out,
+               const unsigned char *in, uint64_t tweak);
+};
+
+/* The wide kernels must hash like the 128-bit kernels over several chunks
+ * (16 blocks on YMM, 32 on ZMM) & a tail, with a tweak wrapping around 2^64
+ * in the middle of a chunk. */
+static void check_fixed_key_wide(const struct fixed_key_kernels *wide) {
+  static const size_t sizes[] = {16, 240, 1040, 1136, 4144};
+  static unsigned char in[4144], expected[4144], actual[4144];
+  const unsigned char key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae,
+                                 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+                                 0x09, 0xcf, 0x4f, 0x3c};
+  const uint64_t tweak = UINT64_MAX - 40;
+  AesContext ctx;
+
+  for (size_t i = 0; i < sizeof in; ++i)
+    in[i] = (unsigned char)(i * 7);
+
+  aesni_init(&ctx, 128, key);
+
+  for (size_t i = 0; i < sizeof sizes / sizeof sizes[0]; ++i) {
+    aesni_fixed_key_cr(&ctx, sizes[i], expected, in);
+    wide->cr(&ctx, sizes[i], actual, in);
+    munit_assert_memory_equal(sizes[i], actual, expected);
+
+    aesni_fixed_key_ccr(&ctx, sizes[i], expected, in);
+    wide->ccr(&ctx, sizes[i], actual, in);
+    munit_assert_memory_equal(sizes[i], actual, expected);
+
+    aesni_fixed_key_tccr(&ctx, sizes[i], expected, in, tweak);
+    wide->tccr(&ctx, sizes[i], actual, in, tweak);
+    munit_assert_memory_equal(sizes[i], actual, expected);
+  }
+}
+
+static MunitResult test_fixed_key_ni(const MunitParameter params[],
+                                     void *user_data_or_fixture) {
+  static unsigned char in[16 * 19], expected[16 * 19], actual[16 * 19];
+  const unsigned char key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae,
+                                 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+                                 0x09, 0xcf, 0x4f, 0x3c};
+  const uint64_t tweak = UINT64_MAX - 9;
+  AesContext ctx;
+
+  for (size_t i = 0; i < sizeof in; ++i)
+    in[i] = (unsigned char)(i * 7);
+
+  aesni_init(&ctx, 128, key);
+
+  /* The 8-way interleave must hash like blocks taken one at a time, with a
+   * tweak wrapping around 2^64 in the middle of the second group. */
+  for (size_t i = 0; i < sizeof in / 16; ++i)
+    aesni_fixed_key_cr(&ctx, 16, &expected[i * 16], &in[i * 16]);
+  aesni_fixed_key_cr(&ctx, sizeof in, actual, in);
+  munit_assert_memory_equal(sizeof in, actual, expected);
+
+  for (size_t i = 0; i < sizeof in / 16; ++i)
+    aesni_fixed_key_ccr(&ctx, 16, &expected[i * 16], &in[i * 16]);
+  aesni_fixed_key_ccr(&ctx, sizeof in, actual, in);
+  munit_assert_memory_equal(sizeof in, actual, expected);
+
+  for (size_t i = 0; i < sizeof in / 16; ++i)
+    aesni_fixed_key_tccr(&ctx, 16, &expected[i * 16], &in[i * 16], tweak + i);
+  aesni_fixed_key_tccr(&ctx, sizeof in, actual, in, tweak);
+  munit_assert_memory_equal(sizeof in, actual, expected);
+
+  return MUNIT_OK;
+}
+
+static MunitResult test_fixed_key_vaes(const MunitParameter params[],
+                                       void *user_data_or_fixture) {
+  struct cpu_capability_x86 cpufeat;
+  cpu_capability_x86_init(&cpufeat);
+
+  bool vaes = cpufeat.aes && cpufeat.vaes;
+  bool tested = false;
+
+  if (vaes && cpufeat.avx2 && cpufeat.os_ymm) {
+    const struct fixed_key_kernels vaes256 = {aesvaes256_fixed_key_cr,
+                                              aesvaes256_fixed_key_ccr,
+                                              aesvaes256_fixed_key_tccr};
+    check_fixed_key_wide(&vaes256);
+    tested = true;
+  }
+
+  if (vaes && cpufeat.avx512f && cpufeat.avx512bw && cpufeat.avx512vl &&
+      cpufeat.os_zmm) {
+    const struct fixed_key_kernels vaes512 = {aesvaes512_fixed_key_cr,
+                                              aesvaes512_fixed_key_ccr,
+                                              aesvaes512_fixed_key_tccr};
+    check_fixed_key_wide(&vaes512);
+    tested = true;
+  }
+
+  return tested ? MUNIT_OK : MUNIT_SKIP;
+}
+
 static MunitTest tests[] = {
     {
         "/aes-128-ecb",         /* name */
@@ -471,6 +667,11 @@ static MunitTest tests[] = {
     {"/aes-128-ctr", test_aes128_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     {"/aes-192-ctr", test_aes192_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
     {"/aes-256-ctr", test_aes256_ctr, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/gcm-vaes", test_gcm_vaes, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+    {"/fixed-key-ni", test_fixed_key_ni, NULL, NULL, MUNIT_TEST_OPTION_NONE,
+     NULL},
+    {"/fixed-key-vaes", test_fixed_key_vaes, NULL, NULL,
+     MUNIT_TEST_OPTION_NONE, NULL},
     /* Mark the end of the array with an entry where the test
      * function is NULL */
     {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};